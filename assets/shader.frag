@@ -9,27 +9,82 @@ layout(set = 2, binding = 0) uniform Light {
 	float specularStrength;
 } light;
 
+layout(set = 2, binding = 1) uniform Cluster {
+	uvec3 gridSize;
+	uint lightCount;
+	vec2 screenSize;
+	float zNear;
+	float zFar;
+} cluster;
+
+struct PointLight {
+	vec3 position;
+	float radius;
+	vec4 color;
+};
+
+layout(std430, set = 2, binding = 2) readonly buffer LightBuffer {
+	PointLight lights[];
+} lightBuffer;
+
+layout(std430, set = 2, binding = 3) readonly buffer GridBuffer {
+	uint counts[];
+} gridBuffer;
+
+layout(std430, set = 2, binding = 4) readonly buffer IndexBuffer {
+	uint indices[];
+} indexBuffer;
+
+// Must match LightClusters::max_lights_per_cluster
+const uint maxLightsPerCluster = 128;
+
 layout(set = 3, binding = 0) uniform sampler2D u_Texture;
 
 layout(location = 0) in vec2 v_Texcoord;
 layout(location = 1) in vec3 v_Normal;
 layout(location = 2) in vec3 v_FragPos;
+layout(location = 3) in float v_ViewDepth;
 
 layout(location = 0) out vec4 o_Color;
 
-void main() {
-	vec3 norm = normalize(v_Normal);
-	vec3 lightDir = normalize(light.position - v_FragPos);
-
-	vec3 viewDir = normalize(light.viewPos - v_FragPos);
+vec4 shade(vec3 norm, vec3 viewDir, vec3 lightDir, vec4 color) {
 	vec3 reflectDir = reflect(-lightDir, norm);  
 	float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32);
-	vec4 specular = light.specularStrength * spec * light.color;  
+	vec4 specular = light.specularStrength * spec * color;  
 
 	float diff = max(dot(norm, lightDir), 0.0);
-	vec4 diffuse = diff * light.color;
+	vec4 diffuse = diff * color;
+
+	return diffuse + specular;
+}
+
+uint clusterIndex() {
+	uvec2 tile = uvec2(gl_FragCoord.xy / cluster.screenSize * vec2(cluster.gridSize.xy));
+	float slice = log(v_ViewDepth / cluster.zNear) / log(cluster.zFar / cluster.zNear) * float(cluster.gridSize.z);
+
+	uvec3 cell = min(uvec3(tile, uint(max(slice, 0.0))), cluster.gridSize - 1);
+	return cell.x + cluster.gridSize.x * (cell.y + cluster.gridSize.y * cell.z);
+}
+
+void main() {
+	vec3 norm = normalize(v_Normal);
+	vec3 viewDir = normalize(light.viewPos - v_FragPos);
 
 	vec4 ambient = light.ambientStrength * light.color;
+	vec4 lighting = ambient + shade(norm, viewDir, normalize(light.position - v_FragPos), light.color);
+
+	// Only the point lights binned in this fragment's cluster
+	uint index = clusterIndex();
+	uint count = gridBuffer.counts[index];
+	for (uint i = 0; i < count; ++i) {
+		PointLight pointLight = lightBuffer.lights[indexBuffer.indices[index * maxLightsPerCluster + i]];
+
+		vec3 toLight = pointLight.position - v_FragPos;
+		float distance = length(toLight);
+		float falloff = clamp(1.0 - (distance * distance) / (pointLight.radius * pointLight.radius), 0.0, 1.0);
+
+		lighting += falloff * falloff * shade(norm, viewDir, toLight / max(distance, 1e-4), pointLight.color);
+	}
 
-	o_Color = (ambient + diffuse + specular) * texture( u_Texture, v_Texcoord );
-}
\ No newline at end of file
+	o_Color = lighting * texture( u_Texture, v_Texcoord );
+}
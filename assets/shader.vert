@@ -13,24 +13,44 @@ out gl_PerVertex {
   vec4 gl_Position;
 };
 
-struct ObjectData {
-  mat4 model;
-};
+// Matches InstanceFormat, set when the pipeline is created
+layout(constant_id = 0) const bool compactInstances = false;
 
-//all object matrices
-layout(std140, set = 1, binding = 0) readonly buffer ObjectBuffer{
-  ObjectData objects[];
+// 7 vec4 per ModelGpuObject, 3 per AffineModelGpuObject
+layout(std430, set = 1, binding = 0) readonly buffer ObjectBuffer {
+  vec4 data[];
 } objectBuffer;
 
 layout(location = 0) out vec2 v_Texcoord;
 layout(location = 1) out vec3 v_Normal;
 layout(location = 2) out vec3 v_FragPos;
+layout(location = 3) out float v_ViewDepth;
+
+void loadObject(uint index, out mat4 model, out mat3 normal) {
+  if (compactInstances) {
+    vec4 c0 = objectBuffer.data[3 * index];
+    vec4 c1 = objectBuffer.data[3 * index + 1];
+    vec4 c2 = objectBuffer.data[3 * index + 2];
+    model = transpose(mat4(c0, c1, c2, vec4(0.0, 0.0, 0.0, 1.0)));
+
+    // Inverse transpose from the cofactors, cheaper than inverse() but paid per vertex
+    normal = transpose(mat3(cross(c1.xyz, c2.xyz), cross(c2.xyz, c0.xyz), cross(c0.xyz, c1.xyz))) / dot(c0.xyz, cross(c1.xyz, c2.xyz));
+  }
+  else {
+    model = mat4(objectBuffer.data[7 * index], objectBuffer.data[7 * index + 1], objectBuffer.data[7 * index + 2], objectBuffer.data[7 * index + 3]);
+    normal = mat3(objectBuffer.data[7 * index + 4].xyz, objectBuffer.data[7 * index + 5].xyz, objectBuffer.data[7 * index + 6].xyz);
+  }
+}
 
 void main() {
-  mat4 modelMatrix = objectBuffer.objects[gl_BaseInstance].model;
+  mat4 modelMatrix;
+  mat3 normalMatrix;
+  loadObject(uint(gl_BaseInstance), modelMatrix, normalMatrix);
+
   gl_Position = ubo.proj * ubo.view * modelMatrix * vec4(i_Position, 1.0);
 
   v_Texcoord = i_Texcoord;
-  v_Normal = mat3(transpose(inverse(modelMatrix))) * i_Normal;  
+  v_Normal = normalMatrix * i_Normal;
   v_FragPos = vec3(modelMatrix * vec4(i_Position, 1.0));
+  v_ViewDepth = abs((ubo.view * vec4(v_FragPos, 1.0)).z);
 }
@@ -0,0 +1,72 @@
+#version 460
+
+layout(set = 0, binding = 0) uniform UniformBufferObject {
+  mat4 view;
+  mat4 proj;
+} ubo;
+
+layout(push_constant) uniform MeshConstants {
+  vec4 positionOffset;
+  vec4 positionScale;
+} mesh;
+
+// Matches QuantizedVertex, positions are normalized in the mesh bounds and normals octahedral encoded
+layout(location = 0) in vec4 i_Position;
+layout(location = 1) in vec2 i_Texcoord;
+layout(location = 2) in vec2 i_Normal;
+
+out gl_PerVertex {
+  vec4 gl_Position;
+};
+
+// Matches InstanceFormat, set when the pipeline is created
+layout(constant_id = 0) const bool compactInstances = false;
+
+// 7 vec4 per ModelGpuObject, 3 per AffineModelGpuObject
+layout(std430, set = 1, binding = 0) readonly buffer ObjectBuffer {
+  vec4 data[];
+} objectBuffer;
+
+layout(location = 0) out vec2 v_Texcoord;
+layout(location = 1) out vec3 v_Normal;
+layout(location = 2) out vec3 v_FragPos;
+layout(location = 3) out float v_ViewDepth;
+
+void loadObject(uint index, out mat4 model, out mat3 normal) {
+  if (compactInstances) {
+    vec4 c0 = objectBuffer.data[3 * index];
+    vec4 c1 = objectBuffer.data[3 * index + 1];
+    vec4 c2 = objectBuffer.data[3 * index + 2];
+    model = transpose(mat4(c0, c1, c2, vec4(0.0, 0.0, 0.0, 1.0)));
+
+    // Inverse transpose from the cofactors, cheaper than inverse() but paid per vertex
+    normal = transpose(mat3(cross(c1.xyz, c2.xyz), cross(c2.xyz, c0.xyz), cross(c0.xyz, c1.xyz))) / dot(c0.xyz, cross(c1.xyz, c2.xyz));
+  }
+  else {
+    model = mat4(objectBuffer.data[7 * index], objectBuffer.data[7 * index + 1], objectBuffer.data[7 * index + 2], objectBuffer.data[7 * index + 3]);
+    normal = mat3(objectBuffer.data[7 * index + 4].xyz, objectBuffer.data[7 * index + 5].xyz, objectBuffer.data[7 * index + 6].xyz);
+  }
+}
+
+vec3 decodeNormal(vec2 encoded) {
+  vec3 normal = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+  float t = max(-normal.z, 0.0);
+  normal.xy += mix(vec2(t), vec2(-t), greaterThanEqual(normal.xy, vec2(0.0)));
+  return normalize(normal);
+}
+
+void main() {
+  vec3 position = mesh.positionOffset.xyz + i_Position.xyz * mesh.positionScale.xyz;
+  vec3 normal = decodeNormal(i_Normal);
+
+  mat4 modelMatrix;
+  mat3 normalMatrix;
+  loadObject(uint(gl_BaseInstance), modelMatrix, normalMatrix);
+
+  gl_Position = ubo.proj * ubo.view * modelMatrix * vec4(position, 1.0);
+
+  v_Texcoord = i_Texcoord;
+  v_Normal = normalMatrix * normal;
+  v_FragPos = vec3(modelMatrix * vec4(position, 1.0));
+  v_ViewDepth = abs((ubo.view * vec4(v_FragPos, 1.0)).z);
+}
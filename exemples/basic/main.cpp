@@ -8,12 +8,20 @@
 
 #include <Maths/Angle.hpp>
 
+#include <Utils/AssetFile.hpp>
 #include <Utils/Color.hpp>
 
 #include <iostream>
 #include <chrono>
+#include <cmath>
+#include <filesystem>
 
 int main() {
+	// Packed assets take over the loose files, see nthcook --archive
+	if (std::filesystem::exists("assets.ntha")) {
+		Nth::AssetFile::Mount("assets.ntha");
+	}
+
 	Nth::Window::Init();
 	Nth::Window window{ "Hello World", 100, 100, 640, 480, 0 };
 	window.set_resizable();
@@ -22,8 +30,8 @@ int main() {
 	renderer.set_render_on(window);
 
 	Nth::MaterialInfos basic_material_infos = {
-		"vert.spv",
-		"frag.spv"
+		"shader.vert.spv",
+		"shader.frag.spv"
 	};
 
 	Nth::Material basic_material = renderer.create_material(basic_material_infos);
@@ -44,14 +52,19 @@ int main() {
 	//	Nth::Matrix4f::Rotation(Nth::to_radians(90.f), {1.f, 0.f, 0.f}) * Nth::Matrix4f::Translation({ -1.f, 0.f, 0.f }) * Nth::Matrix4f::Scale({ 2.f, 2.f, 2.f })
 	//}; 
 
-	Nth::Model model = Nth::Model::LoadFromFile("./boxs/scene.gltf");
+	Nth::ImportOptions import_options;
+	import_options.lod_count = 3;
+
+	Nth::Model model = Nth::Model::LoadFromFile("./boxs/scene.gltf", renderer.read_pool(), import_options);
+	std::cout << model.optimize().to_string() << std::endl;
 	size_t model_index = renderer.register_model(model);
 
-	Nth::RenderObject obj{
+	Nth::RenderScene scene = renderer.create_scene();
+	scene.add(Nth::RenderObject{
 		model_index,
 		&basic_material,
 		Nth::Matrix4f::Identity()
-	};
+	});
 
 	renderer.camera.position = Nth::Vector3f{ 0.f, 0.f, 0.f }; 
 
@@ -71,10 +84,19 @@ int main() {
 		0.5f,
 	};
 
+	for (int i = 0; i < 8; ++i) {
+		float angle = Nth::to_radians(45.f * static_cast<float>(i));
+		renderer.point_lights.push_back(Nth::PointLightGpuObject{
+			{ 2.f * std::cos(angle), 0.5f, 2.f * std::sin(angle) },
+			1.5f,
+			{ 0.5f + 0.5f * std::cos(angle), 0.5f, 0.5f + 0.5f * std::sin(angle), 1.f }
+		});
+	}
+
 	while (window.is_open()) {
 		window.poll_event();
 
-		renderer.draw({ obj });
+		renderer.draw(scene);
 	}
 
 	renderer.wait_idle();
@@ -0,0 +1,56 @@
+#ifndef NTH_MATHS_BOUNDINGBOX_HPP
+#define NTH_MATHS_BOUNDINGBOX_HPP
+
+#include <Maths/Vector3.hpp>
+
+#include <string>
+
+namespace Nth {
+	template<typename T>
+	class Matrix4;
+
+	template<typename T>
+	class BoundingBox {
+	public:
+		BoundingBox();
+		BoundingBox(const Vector3<T>& min, const Vector3<T>& max);
+		BoundingBox(const BoundingBox<T>&) = default;
+		BoundingBox(BoundingBox<T>&&) = default;
+		~BoundingBox() = default;
+
+		void extend(const Vector3<T>& point);
+		void extend(const BoundingBox& box);
+
+		bool is_valid() const;
+		bool contains(const Vector3<T>& point) const;
+		bool intersect(const BoundingBox& box) const;
+		// Distance along direction where the ray enters the box, 0 when it starts inside
+		bool intersect_ray(const Vector3<T>& origin, const Vector3<T>& direction, T max_distance, T& distance) const;
+
+		Vector3<T> center() const;
+		Vector3<T> extent() const;
+
+		BoundingBox transform(const Matrix4<T>& mat) const;
+
+		bool operator==(const BoundingBox& box) const;
+		bool operator!=(const BoundingBox& box) const;
+
+		BoundingBox& operator=(const BoundingBox&) = default;
+		BoundingBox& operator=(BoundingBox&&) = default;
+
+		std::string to_string() const;
+
+		Vector3<T> min;
+		Vector3<T> max;
+	};
+
+	using BoundingBoxf = BoundingBox<float>;
+	using BoundingBoxd = BoundingBox<double>;
+}
+
+template<typename T>
+std::ostream& operator<<(std::ostream& out, const Nth::BoundingBox<T>& box);
+
+#include <Maths/BoundingBox.inl>
+
+#endif
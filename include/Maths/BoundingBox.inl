@@ -0,0 +1,150 @@
+#include <Maths/BoundingBox.hpp>
+
+#include <Maths/Matrix4.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <utility>
+
+namespace Nth {
+	template<typename T>
+	BoundingBox<T>::BoundingBox() :
+		min(std::numeric_limits<T>::max(), std::numeric_limits<T>::max(), std::numeric_limits<T>::max()),
+		max(std::numeric_limits<T>::lowest(), std::numeric_limits<T>::lowest(), std::numeric_limits<T>::lowest()) { }
+
+	template<typename T>
+	BoundingBox<T>::BoundingBox(const Vector3<T>& min, const Vector3<T>& max) :
+		min(min),
+		max(max) { }
+
+	template<typename T>
+	void BoundingBox<T>::extend(const Vector3<T>& point) {
+		min = Vector3<T>{ std::min(min.x, point.x), std::min(min.y, point.y), std::min(min.z, point.z) };
+		max = Vector3<T>{ std::max(max.x, point.x), std::max(max.y, point.y), std::max(max.z, point.z) };
+	}
+
+	template<typename T>
+	void BoundingBox<T>::extend(const BoundingBox& box) {
+		if (!box.is_valid()) {
+			return;
+		}
+
+		extend(box.min);
+		extend(box.max);
+	}
+
+	template<typename T>
+	bool BoundingBox<T>::is_valid() const {
+		return min.x <= max.x && min.y <= max.y && min.z <= max.z;
+	}
+
+	template<typename T>
+	bool BoundingBox<T>::contains(const Vector3<T>& point) const {
+		return point.x >= min.x && point.x <= max.x &&
+			point.y >= min.y && point.y <= max.y &&
+			point.z >= min.z && point.z <= max.z;
+	}
+
+	template<typename T>
+	bool BoundingBox<T>::intersect(const BoundingBox& box) const {
+		return min.x <= box.max.x && max.x >= box.min.x &&
+			min.y <= box.max.y && max.y >= box.min.y &&
+			min.z <= box.max.z && max.z >= box.min.z;
+	}
+
+	template<typename T>
+	bool BoundingBox<T>::intersect_ray(const Vector3<T>& origin, const Vector3<T>& direction, T max_distance, T& distance) const {
+		if (!is_valid()) {
+			return false;
+		}
+
+		const T ray_origin[3] = { origin.x, origin.y, origin.z };
+		const T ray_direction[3] = { direction.x, direction.y, direction.z };
+		const T box_min[3] = { min.x, min.y, min.z };
+		const T box_max[3] = { max.x, max.y, max.z };
+
+		// Slab test, the ray is clipped by each pair of planes
+		T entry = static_cast<T>(0);
+		T leave = max_distance;
+		for (int axis = 0; axis < 3; ++axis) {
+			if (ray_direction[axis] == static_cast<T>(0)) {
+				if (ray_origin[axis] < box_min[axis] || ray_origin[axis] > box_max[axis]) {
+					return false;
+				}
+
+				continue;
+			}
+
+			T inverse = static_cast<T>(1) / ray_direction[axis];
+			T t0 = (box_min[axis] - ray_origin[axis]) * inverse;
+			T t1 = (box_max[axis] - ray_origin[axis]) * inverse;
+			if (t0 > t1) {
+				std::swap(t0, t1);
+			}
+
+			entry = std::max(entry, t0);
+			leave = std::min(leave, t1);
+			if (entry > leave) {
+				return false;
+			}
+		}
+
+		distance = entry;
+		return true;
+	}
+
+	template<typename T>
+	Vector3<T> BoundingBox<T>::center() const {
+		return (min + max) * static_cast<T>(0.5);
+	}
+
+	template<typename T>
+	Vector3<T> BoundingBox<T>::extent() const {
+		return (max - min) * static_cast<T>(0.5);
+	}
+
+	template<typename T>
+	BoundingBox<T> BoundingBox<T>::transform(const Matrix4<T>& mat) const {
+		if (!is_valid()) {
+			return BoundingBox<T>{};
+		}
+
+		// Arvo's method: project the extent on the absolute rotation part
+		Vector3<T> c = center() * mat;
+		Vector3<T> e = extent();
+
+		Vector3<T> new_extent{
+			std::abs(mat.a11) * e.x + std::abs(mat.a21) * e.y + std::abs(mat.a31) * e.z,
+			std::abs(mat.a12) * e.x + std::abs(mat.a22) * e.y + std::abs(mat.a32) * e.z,
+			std::abs(mat.a13) * e.x + std::abs(mat.a23) * e.y + std::abs(mat.a33) * e.z
+		};
+
+		return BoundingBox<T>{ c - new_extent, c + new_extent };
+	}
+
+	template<typename T>
+	bool BoundingBox<T>::operator==(const BoundingBox& box) const {
+		return min == box.min && max == box.max;
+	}
+
+	template<typename T>
+	bool BoundingBox<T>::operator!=(const BoundingBox& box) const {
+		return !(*this == box);
+	}
+
+	template<typename T>
+	std::string BoundingBox<T>::to_string() const {
+		std::stringstream stream;
+
+		stream << "BoundingBox(" << min.to_string() << "," << max.to_string() << ")";
+
+		return stream.str();
+	}
+}
+
+template<typename T>
+std::ostream& operator<<(std::ostream& out, const Nth::BoundingBox<T>& box) {
+	return out << box.to_string();
+}
@@ -0,0 +1,51 @@
+#ifndef NTH_MATHS_FRUSTUM_HPP
+#define NTH_MATHS_FRUSTUM_HPP
+
+#include <Maths/Vector4.hpp>
+
+#include <array>
+#include <string>
+
+namespace Nth {
+	template<typename T>
+	class Matrix4;
+
+	template<typename T>
+	class BoundingBox;
+
+	enum class FrustumContainment {
+		Outside,
+		Intersecting,
+		Inside
+	};
+
+	// Clip volume of a view projection with depth in [0, w], planes point inside
+	template<typename T>
+	class Frustum {
+	public:
+		Frustum() = default;
+		explicit Frustum(const Matrix4<T>& view_projection);
+		Frustum(const Frustum<T>&) = default;
+		Frustum(Frustum<T>&&) = default;
+		~Frustum() = default;
+
+		FrustumContainment classify(const BoundingBox<T>& box) const;
+
+		Frustum& operator=(const Frustum&) = default;
+		Frustum& operator=(Frustum&&) = default;
+
+		std::string to_string() const;
+
+		std::array<Vector4<T>, 6> planes;
+	};
+
+	using Frustumf = Frustum<float>;
+	using Frustumd = Frustum<double>;
+}
+
+template<typename T>
+std::ostream& operator<<(std::ostream& out, const Nth::Frustum<T>& frustum);
+
+#include <Maths/Frustum.inl>
+
+#endif
@@ -0,0 +1,61 @@
+#include <Maths/Frustum.hpp>
+
+#include <Maths/BoundingBox.hpp>
+#include <Maths/Matrix4.hpp>
+
+#include <sstream>
+
+namespace Nth {
+	template<typename T>
+	Frustum<T>::Frustum(const Matrix4<T>& view_projection) {
+		// Points are row vectors, so each clip coordinate is a column of the matrix
+		const Matrix4<T>& m = view_projection;
+		Vector4<T> x{ m.a11, m.a21, m.a31, m.a41 };
+		Vector4<T> y{ m.a12, m.a22, m.a32, m.a42 };
+		Vector4<T> z{ m.a13, m.a23, m.a33, m.a43 };
+		Vector4<T> w{ m.a14, m.a24, m.a34, m.a44 };
+
+		planes = { w + x, w - x, w + y, w - y, z, w - z };
+	}
+
+	template<typename T>
+	FrustumContainment Frustum<T>::classify(const BoundingBox<T>& box) const {
+		if (!box.is_valid()) {
+			return FrustumContainment::Outside;
+		}
+
+		FrustumContainment containment = FrustumContainment::Inside;
+		for (const Vector4<T>& plane : planes) {
+			// Corners furthest along and against the plane normal
+			Vector4<T> positive{ plane.x >= 0 ? box.max.x : box.min.x, plane.y >= 0 ? box.max.y : box.min.y, plane.z >= 0 ? box.max.z : box.min.z, static_cast<T>(1) };
+			Vector4<T> negative{ plane.x >= 0 ? box.min.x : box.max.x, plane.y >= 0 ? box.min.y : box.max.y, plane.z >= 0 ? box.min.z : box.max.z, static_cast<T>(1) };
+
+			if (positive.dot_product(plane) < 0) {
+				return FrustumContainment::Outside;
+			}
+			if (negative.dot_product(plane) < 0) {
+				containment = FrustumContainment::Intersecting;
+			}
+		}
+
+		return containment;
+	}
+
+	template<typename T>
+	std::string Frustum<T>::to_string() const {
+		std::stringstream stream;
+
+		stream << "Frustum(";
+		for (size_t i = 0; i < planes.size(); ++i) {
+			stream << (i > 0 ? "," : "") << planes[i].to_string();
+		}
+		stream << ")";
+
+		return stream.str();
+	}
+}
+
+template<typename T>
+std::ostream& operator<<(std::ostream& out, const Nth::Frustum<T>& frustum) {
+	return out << frustum.to_string();
+}
@@ -0,0 +1,41 @@
+#ifndef NTH_RENDERER_ASSETIOSYSTEM_HPP
+#define NTH_RENDERER_ASSETIOSYSTEM_HPP
+
+#include <Utils/AssetFile.hpp>
+
+#include <assimp/IOStream.hpp>
+#include <assimp/IOSystem.hpp>
+
+namespace Nth {
+	// Read only stream over an AssetFile
+	class AssetIOStream : public Assimp::IOStream {
+	public:
+		explicit AssetIOStream(AssetFile&& file);
+		~AssetIOStream() override = default;
+
+		size_t Read(void* buffer, size_t size, size_t count) override;
+		size_t Write(const void* buffer, size_t size, size_t count) override;
+		aiReturn Seek(size_t offset, aiOrigin origin) override;
+		size_t Tell() const override;
+		size_t FileSize() const override;
+		void Flush() override;
+
+	private:
+		AssetFile m_file;
+		size_t m_position;
+	};
+
+	// Lets the importer open a model and the files it references, like glTF buffers, through the mounted archives
+	class AssetIOSystem : public Assimp::IOSystem {
+	public:
+		AssetIOSystem() = default;
+		~AssetIOSystem() override = default;
+
+		bool Exists(const char* file) const override;
+		char getOsSeparator() const override;
+		Assimp::IOStream* Open(const char* file, const char* mode = "rb") override;
+		void Close(Assimp::IOStream* file) override;
+	};
+}
+
+#endif
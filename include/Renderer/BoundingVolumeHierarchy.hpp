@@ -0,0 +1,84 @@
+#ifndef NTH_RENDERER_BOUNDINGVOLUMEHIERARCHY_HPP
+#define NTH_RENDERER_BOUNDINGVOLUMEHIERARCHY_HPP
+
+#include <Maths/BoundingBox.hpp>
+#include <Maths/Matrix4.hpp>
+#include <Maths/Vector3.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace Nth {
+	struct BoundingVolumeHit {
+		uint32_t item;
+		// Along the ray direction, where it enters the item's box
+		float distance;
+	};
+
+	// Binned SAH tree over item boxes, moved and removed items are refitted in place until the tree gets too loose
+	class BoundingVolumeHierarchy {
+	public:
+		BoundingVolumeHierarchy();
+		BoundingVolumeHierarchy(const BoundingVolumeHierarchy&) = delete;
+		BoundingVolumeHierarchy(BoundingVolumeHierarchy&&) = default;
+		~BoundingVolumeHierarchy() = default;
+
+		// Items are the indices of bounds, invalid boxes are left out
+		void build(const std::vector<BoundingBoxf>& bounds);
+
+		// Invalid bounds remove the item, a new item is only inserted by the next refresh
+		void set(uint32_t item, const BoundingBoxf& bounds);
+		// Rebuilds after insertions or when refits made the tree much more expensive to walk than when built
+		void refresh();
+
+		void clear();
+
+		// Overlapping the box
+		void query(const BoundingBoxf& bounds, std::vector<uint32_t>& items) const;
+		// Hit by the ray within max_distance, nearest first
+		void query(const Vector3f& origin, const Vector3f& direction, float max_distance, std::vector<BoundingVolumeHit>& hits) const;
+		// Inside the frustum, visible also tests nodes and items the frustum doesn't reject, a rejected node skips its whole subtree
+		void cull(const Matrix4f& view_projection, std::vector<uint32_t>& items, const std::function<bool(const BoundingBoxf&)>& visible = {}) const;
+
+		const BoundingBoxf& bounds() const;
+		const BoundingBoxf& bounds(uint32_t item) const;
+		size_t node_count() const;
+		size_t size() const;
+
+		// Expected box tests of a query, relative to the root box
+		float cost() const;
+
+		BoundingVolumeHierarchy& operator=(const BoundingVolumeHierarchy&) = delete;
+		BoundingVolumeHierarchy& operator=(BoundingVolumeHierarchy&&) = default;
+
+		static constexpr uint32_t max_leaf_size = 4;
+		static constexpr uint32_t bin_count = 16;
+		static constexpr float rebuild_cost_ratio = 1.5f;
+
+	private:
+		// Leaves own count items from first in m_items, inner nodes have their two children at first and first + 1
+		struct Node {
+			BoundingBoxf bounds;
+			uint32_t first;
+			uint32_t count;
+			uint32_t parent;
+		};
+
+		void refit(uint32_t node_index);
+
+		std::vector<Node> m_nodes;
+		std::vector<uint32_t> m_items;
+		std::vector<BoundingBoxf> m_item_bounds;
+		std::vector<uint32_t> m_item_leaves;
+
+		float m_built_cost;
+		bool m_refitted;
+		bool m_rebuild;
+
+		static constexpr uint32_t no_node = std::numeric_limits<uint32_t>::max();
+	};
+}
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef NTH_RENDERER_COMPUTESHADER_HPP
+#define NTH_RENDERER_COMPUTESHADER_HPP
+
+#include <Renderer/Vulkan/Pipeline.hpp>
+#include <Renderer/Vulkan/PipelineLayout.hpp>
+#include <Renderer/Vulkan/ShaderModule.hpp>
+
+#include <filesystem>
+#include <vector>
+
+namespace Nth {
+	namespace Vk {
+		class Device;
+	}
+
+	class ComputeShader {
+	public:
+		ComputeShader() = default;
+		ComputeShader(const ComputeShader&) = delete;
+		ComputeShader(ComputeShader&&) = default;
+		~ComputeShader() = default;
+
+		void create(const Vk::Device& device, const std::filesystem::path& shader_name, const std::vector<VkDescriptorSetLayout>& descriptor_set_layouts, uint32_t push_constant_size, const std::vector<uint32_t>& specialization_constants = {});
+
+		ComputeShader& operator=(const ComputeShader&) = delete;
+		ComputeShader& operator=(ComputeShader&&) = default;
+
+		Vk::Pipeline pipeline;
+		Vk::PipelineLayout pipeline_layout;
+
+	private:
+		Vk::ShaderModule create_shader_module(const Vk::Device& device, const std::filesystem::path& path) const;
+	};
+}
+
+#endif
@@ -0,0 +1,144 @@
+#ifndef NTH_RENDERER_COOKEDMODEL_HPP
+#define NTH_RENDERER_COOKEDMODEL_HPP
+
+#include <Renderer/Meshlet.hpp>
+#include <Renderer/Texture.hpp>
+#include <Renderer/Vertex.hpp>
+
+#include <Utils/AssetFile.hpp>
+
+#include <Maths/BoundingBox.hpp>
+#include <Maths/Matrix4.hpp>
+#include <Maths/Vector3.hpp>
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+namespace Nth {
+	class ReadPool;
+	class Model;
+	struct Mesh;
+	struct ModelInstance;
+
+	// Offsets are in bytes from the start of the file, which is written in the host byte order
+	struct CookedHeader {
+		std::array<char, 4> magic;
+		uint32_t version;
+		uint32_t mesh_count;
+		uint32_t texture_count;
+		uint32_t instance_count;
+		uint32_t padding;
+		uint64_t mesh_table;
+		uint64_t texture_table;
+		uint64_t instance_table;
+		uint64_t file_size;
+	};
+
+	// Same range as a RenderMeshLod, the full detail level comes first
+	struct CookedLod {
+		uint32_t first_index;
+		uint32_t index_count;
+		float error;
+	};
+
+	// Blobs hold the buffers exactly as uploaded, the index blob has every level one after the other
+	struct CookedMesh {
+		BoundingBoxf bounds;
+		VertexFormat vertex_format;
+		IndexFormat index_format;
+		uint32_t vertex_count;
+		uint32_t lod_count;
+		uint32_t meshlet_count;
+		uint32_t texture_count;
+		uint32_t occluder;
+		uint32_t padding;
+		uint64_t vertices;
+		uint64_t vertices_size;
+		uint64_t indices;
+		uint64_t indices_size;
+		uint64_t lods;
+		uint64_t meshlets;
+		uint64_t textures;
+	};
+
+	// Image files are only referenced, the path is relative to the cooked file
+	struct CookedTexture {
+		uint64_t path;
+		uint32_t path_size;
+		uint32_t type;
+	};
+
+	struct CookedInstance {
+		uint32_t mesh_index;
+		uint32_t padding[3];
+		Matrix4f transform;
+	};
+
+	// Model prepared offline, loading maps the file or reads it from an archive and only checks its tables so blobs can be copied to staging as they are
+	class CookedModel {
+	public:
+		CookedModel() = delete;
+		CookedModel(const CookedModel&) = delete;
+		CookedModel(CookedModel&&) = default;
+		~CookedModel() = default;
+
+		const std::vector<CookedMesh>& meshes() const;
+
+		// Point into the mapped file, valid as long as the model is
+		const uint8_t* vertices(const CookedMesh& mesh) const;
+		const uint8_t* indices(const CookedMesh& mesh) const;
+
+		std::vector<CookedLod> lods(const CookedMesh& mesh) const;
+		std::vector<Meshlet> meshlets(const CookedMesh& mesh) const;
+		std::vector<uint32_t> texture_indices(const CookedMesh& mesh) const;
+
+		// Full detail level decoded on CPU, for the few users of the geometry like occluders
+		std::vector<uint32_t> unpack_indices(const CookedMesh& mesh) const;
+		std::vector<Vector3f> unpack_positions(const CookedMesh& mesh) const;
+
+		size_t texture_count() const;
+		std::string_view texture_path(size_t index) const;
+		std::string_view texture_type(size_t index) const;
+		// Where the image is, resolved from the cooked file's directory
+		std::filesystem::path texture_file(size_t index) const;
+		// Reads and decodes every referenced image as one batch on the pool
+		std::vector<Texture> load_textures(ReadPool& pool) const;
+		// Asks the OS to read the whole file ahead, blobs are then copied to staging without waiting on disk
+		void prefetch() const;
+
+		std::vector<ModelInstance> instances() const;
+
+		CookedModel& operator=(const CookedModel&) = delete;
+		CookedModel& operator=(CookedModel&&) = default;
+
+		static CookedModel LoadFromFile(const std::filesystem::path& path);
+
+		static constexpr std::array<char, 4> magic{ 'N', 'T', 'H', 'C' };
+		static constexpr uint32_t version = 1;
+		// Blobs start on a cache line
+		static constexpr uint64_t blob_alignment = 64;
+		// Texture::type is a view, so only these names can be stored
+		static constexpr std::array<std::string_view, 3> texture_types{ "texture_diffuse", "texture_specular", "base_color" };
+
+	private:
+		CookedModel(const std::filesystem::path& path);
+
+		template<typename T>
+		std::vector<T> read_table(uint64_t offset, size_t count) const;
+
+		std::filesystem::path m_directory;
+		AssetFile m_file;
+		CookedHeader m_header;
+		std::vector<CookedMesh> m_meshes;
+		std::vector<CookedTexture> m_textures;
+	};
+
+	// Meshes are written as they are, so import processing like optimize or quantize should run before
+	void save_cooked_model(const Model& model, const std::filesystem::path& path);
+	void save_cooked_model(const std::vector<Mesh>& meshes, const std::vector<Texture>& textures, const std::vector<ModelInstance>& instances, const std::filesystem::path& path);
+}
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef NTH_RENDERER_DEPTHPYRAMID_HPP
+#define NTH_RENDERER_DEPTHPYRAMID_HPP
+
+#include <Renderer/RenderImage.hpp>
+#include <Renderer/ComputeShader.hpp>
+#include <Renderer/ShaderBinding.hpp>
+#include <Renderer/Vulkan/Sampler.hpp>
+#include <Renderer/Vulkan/DescriptorSetLayout.hpp>
+
+#include <Maths/Vector2.hpp>
+
+#include <filesystem>
+#include <vector>
+
+namespace Nth {
+	namespace Vk {
+		class CommandBuffer;
+	}
+
+	class RenderDevice;
+	class DescriptorAllocator;
+	class DepthImage;
+
+	// Hierarchical-Z buffer, each texel of a mip keeps the farthest depth of the texels it covers
+	class DepthPyramid {
+	public:
+		DepthPyramid();
+		DepthPyramid(const DepthPyramid&) = delete;
+		DepthPyramid(DepthPyramid&&) = default;
+		~DepthPyramid() = default;
+
+		void init(const RenderDevice& device, DescriptorAllocator& allocator, const std::filesystem::path& reduce_shader_name);
+		void create(const DepthImage& depth, const Vector2ui& depth_size);
+		void build(const Vk::CommandBuffer& command_buffer) const;
+
+		const Vk::ImageView& view() const;
+		const Vk::Sampler& sampler() const;
+		const Vector2ui& size() const;
+		const Vector2ui& depth_size() const;
+
+		DepthPyramid& operator=(const DepthPyramid&) = delete;
+		DepthPyramid& operator=(DepthPyramid&&) = default;
+
+	private:
+		void create_sampler();
+		void clear();
+
+		RenderDevice const* m_device;
+		DescriptorAllocator* m_allocator;
+
+		Vk::DescriptorSetLayout m_descriptor_set_layout;
+		ComputeShader m_reduce;
+		Vk::Sampler m_sampler;
+
+		RenderImage m_image;
+		std::vector<Vk::ImageView> m_mip_views;
+		std::vector<ShaderBinding> m_bindings;
+
+		Vector2ui m_size;
+		Vector2ui m_depth_size;
+	};
+}
+
+#endif
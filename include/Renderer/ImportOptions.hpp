@@ -0,0 +1,27 @@
+#ifndef NTH_RENDERER_IMPORTOPTIONS_HPP
+#define NTH_RENDERER_IMPORTOPTIONS_HPP
+
+#include <cstddef>
+
+namespace Nth {
+	// Processing applied to meshes when a file is loaded
+	struct ImportOptions {
+		// Identical vertices are merged when reading files, OBJ meshes always are
+		bool weld_vertices = false;
+		bool optimize_meshes = false;
+		bool build_meshlets = false;
+		bool quantize_vertices = false;
+
+		// Levels of detail built for every mesh, each keeping lod_reduction of the previous index count
+		size_t lod_count = 0;
+		float lod_reduction = 0.5f;
+
+		// Meshes stay in their node space and Model::nodes keeps the transforms, otherwise they are baked in
+		bool keep_hierarchy = false;
+
+		// Meshes are loaded once and placed by Model::instances, implied by keep_hierarchy
+		bool instance_meshes = false;
+	};
+}
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef NTH_RENDERER_INSTANCETRANSFORM_HPP
+#define NTH_RENDERER_INSTANCETRANSFORM_HPP
+
+#include <Renderer/SceneParameters.hpp>
+
+#include <vector>
+
+namespace Nth {
+	// Fills normal from model for every object, laid out as the columns of a GLSL mat3
+	void compute_normal_matrices(std::vector<ModelGpuObject>& objects);
+
+	// Drops the constant last column, model must be affine
+	AffineModelGpuObject make_affine_model(const Matrix4f& model);
+}
+
+#endif
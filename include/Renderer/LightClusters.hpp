@@ -0,0 +1,69 @@
+#ifndef NTH_RENDERER_LIGHTCLUSTERS_HPP
+#define NTH_RENDERER_LIGHTCLUSTERS_HPP
+
+#include <Renderer/RenderBuffer.hpp>
+#include <Renderer/ComputeShader.hpp>
+#include <Renderer/ShaderBinding.hpp>
+#include <Renderer/SceneParameters.hpp>
+#include <Renderer/Vulkan/DescriptorSetLayout.hpp>
+
+#include <Maths/Vector2.hpp>
+
+#include <filesystem>
+#include <vector>
+
+namespace Nth {
+	namespace Vk {
+		class CommandBuffer;
+	}
+
+	class RenderDevice;
+	class DescriptorAllocator;
+
+	// View frustum split in froxels, each one listing the point lights touching it
+	class LightClusters {
+	public:
+		LightClusters();
+		LightClusters(const LightClusters&) = delete;
+		LightClusters(LightClusters&&) = default;
+		~LightClusters() = default;
+
+		void init(const RenderDevice& device, DescriptorAllocator& allocator, const std::filesystem::path& assign_shader_name, size_t frame_count);
+		void update(size_t frame_index, const RenderBuffer& viewer_buffer, const std::vector<PointLightGpuObject>& lights, const Vector2ui& screen_size, float z_near, float z_far);
+		void build(const Vk::CommandBuffer& command_buffer, size_t frame_index) const;
+
+		const RenderBuffer& cluster_buffer(size_t frame_index) const;
+		const RenderBuffer& light_buffer(size_t frame_index) const;
+		const RenderBuffer& grid_buffer(size_t frame_index) const;
+		const RenderBuffer& index_buffer(size_t frame_index) const;
+
+		LightClusters& operator=(const LightClusters&) = delete;
+		LightClusters& operator=(LightClusters&&) = default;
+
+		static constexpr uint32_t grid_width = 16;
+		static constexpr uint32_t grid_height = 9;
+		static constexpr uint32_t grid_depth = 24;
+		static constexpr uint32_t cluster_count = grid_width * grid_height * grid_depth;
+		static constexpr uint32_t max_lights_per_cluster = 128;
+
+	private:
+		struct Frame {
+			RenderBuffer cluster_buffer;
+			RenderBuffer light_buffer;
+			RenderBuffer grid_buffer;
+			RenderBuffer index_buffer;
+			ShaderBinding binding;
+		};
+
+		void reserve_lights(Frame& frame, size_t light_count);
+
+		RenderDevice const* m_device;
+
+		Vk::DescriptorSetLayout m_descriptor_set_layout;
+		ComputeShader m_assign;
+
+		std::vector<Frame> m_frames;
+	};
+}
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef NTH_RENDERER_LOOSEOCTREE_HPP
+#define NTH_RENDERER_LOOSEOCTREE_HPP
+
+#include <Renderer/BoundingVolumeHierarchy.hpp>
+
+#include <Maths/BoundingBox.hpp>
+#include <Maths/Matrix4.hpp>
+#include <Maths/Vector3.hpp>
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace Nth {
+	// Cells span twice their octant, so an item only depends on its size and center, it stays in its cell while it fits the loose bounds and moving it costs a walk of max_depth cells at most
+	class LooseOctree {
+	public:
+		LooseOctree() = delete;
+		// The region is made cubic, items centered outside of it are kept in the root
+		explicit LooseOctree(const BoundingBoxf& region, uint32_t max_depth = LooseOctree::default_max_depth);
+		LooseOctree(const LooseOctree&) = delete;
+		LooseOctree(LooseOctree&&) = default;
+		~LooseOctree() = default;
+
+		// Inserts or moves the item, invalid bounds remove it
+		void set(uint32_t item, const BoundingBoxf& bounds);
+		void remove(uint32_t item);
+		bool contains(uint32_t item) const;
+
+		void clear();
+		// Once per frame, cells left empty are kept for items moving back in and only pruned once the tree doubled since the last pruning
+		void refresh();
+		void prune();
+
+		// Same queries as BoundingVolumeHierarchy
+		void query(const BoundingBoxf& bounds, std::vector<uint32_t>& items) const;
+		void query(const Vector3f& origin, const Vector3f& direction, float max_distance, std::vector<BoundingVolumeHit>& hits) const;
+		void cull(const Matrix4f& view_projection, std::vector<uint32_t>& items, const std::function<bool(const BoundingBoxf&)>& visible = {}) const;
+
+		const BoundingBoxf& region() const;
+		const BoundingBoxf& bounds(uint32_t item) const;
+		uint32_t max_depth() const;
+		size_t cell_count() const;
+		size_t size() const;
+
+		LooseOctree& operator=(const LooseOctree&) = delete;
+		LooseOctree& operator=(LooseOctree&&) = default;
+
+		static constexpr uint32_t default_max_depth = 8;
+
+	private:
+		// What moves walk through fits a cache line
+		struct alignas(64) Cell {
+			// Octant the items are centered in, loose bounds extend it by half its size on every side
+			Vector3f origin;
+			float size;
+			uint32_t depth;
+			uint32_t parent;
+			// Items in the whole subtree
+			uint32_t item_count;
+			std::array<uint32_t, 8> children;
+			// Items of the cell are linked through their placements, so moves allocate nothing
+			uint32_t first_item;
+		};
+
+		// Kept with the item so a move inside the same octant doesn't touch the cells
+		struct Placement {
+			uint32_t cell;
+			// Neighbours in the items of its cell
+			uint32_t previous;
+			uint32_t next;
+			uint32_t depth;
+			Vector3f origin;
+			float size;
+		};
+
+		static BoundingBoxf loose_bounds(const Vector3f& origin, float size);
+
+		// Deepest level whose octants are at least as large as the item, 0 when centered outside the region
+		uint32_t fit_depth(const BoundingBoxf& bounds) const;
+		// Walks from the current cell up to the first one holding the center then down to depth, so short moves stay local
+		// The item's count is moved along the way, only below the common ancestor, cells left empty stay until pruned
+		uint32_t move_to_cell(const Vector3f& center, uint32_t depth, uint32_t from_cell);
+		uint32_t add_cell(uint32_t parent, uint32_t octant, const Vector3f& origin, float size);
+		void insert(uint32_t item, uint32_t cell_index);
+		void erase(uint32_t item);
+		void free_cell(uint32_t cell_index);
+
+		BoundingBoxf m_region;
+		float m_region_size;
+		uint32_t m_max_depth;
+
+		std::vector<Cell> m_cells;
+		std::vector<uint32_t> m_free_cells;
+		size_t m_pruned_cell_count;
+		std::vector<BoundingBoxf> m_item_bounds;
+		std::vector<Placement> m_placements;
+		size_t m_size;
+
+		static constexpr uint32_t no_cell = std::numeric_limits<uint32_t>::max();
+	};
+}
+
+#endif
@@ -5,6 +5,8 @@
 #include <Renderer/Vulkan/PipelineLayout.hpp>
 #include <Renderer/Vulkan/ShaderModule.hpp>
 #include <Renderer/Vulkan/RenderPass.hpp>
+#include <Renderer/Vertex.hpp>
+#include <Renderer/SceneParameters.hpp>
 
 #include <filesystem>
 #include <vector>
@@ -16,6 +18,7 @@ namespace Nth {
 	struct MaterialInfos {
 		std::filesystem::path vertexShaderName;
 		std::filesystem::path fragmentShaderName;
+		VertexFormat vertexFormat = VertexFormat::Full;
 	};
 
 	class Material {
@@ -26,13 +29,14 @@ namespace Nth {
 		~Material() = default;
 
 		void create_pipeline(const Vk::Device& device, const Vk::RenderPass& render_pass, const std::filesystem::path& vertex_shader_name, 
-			const std::filesystem::path& fragment_shader_name, const std::vector<VkDescriptorSetLayout>& descriptor_set_layouts);
+			const std::filesystem::path& fragment_shader_name, const std::vector<VkDescriptorSetLayout>& descriptor_set_layouts, VertexFormat format, InstanceFormat instance_format);
 
 		Material& operator=(const Material&) = delete;
 		Material& operator=(Material&&) = default;
 
 		Vk::Pipeline pipeline;
 		Vk::PipelineLayout pipeline_layout;
+		VertexFormat vertex_format = VertexFormat::Full;
 
 	private:
 		void create_pipeline_layout(const Vk::Device& device, const std::vector<VkDescriptorSetLayout>& descriptorSetLayouts);
@@ -2,6 +2,13 @@
 #define NTH_RENDERER_MESH_HPP
 
 #include <Renderer/Vertex.hpp>
+#include <Renderer/MeshLod.hpp>
+#include <Renderer/Meshlet.hpp>
+#include <Renderer/QuantizedVertex.hpp>
+#include <Renderer/MeshOptimization.hpp>
+#include <Renderer/ImportOptions.hpp>
+
+#include <Maths/BoundingBox.hpp>
 
 #include <vector>
 #include <string_view>
@@ -15,12 +22,36 @@ namespace Nth {
 		Mesh(std::vector<Vertex> vertices, std::vector<uint32_t> indices, std::vector<size_t> textures_index);
 
 		void add_texture_index(size_t index);
+		void update_bounds();
+		void generate_lods(size_t count, float reduction);
+		void quantize();
+		// Must run before generate_meshlets, meshlets are ranges of the current index order, throws once they are built
+		MeshOptimizationReport optimize();
+		// Runs the import processing in the order each step expects
+		void prepare(const ImportOptions& options);
+		void generate_meshlets(uint32_t max_vertices = Meshlet::max_vertices, uint32_t max_triangles = Meshlet::max_triangles);
+		// UInt16 while every vertex can be addressed with 16 bits
+		IndexFormat index_format() const;
 
 		std::vector<Vertex> vertices;
 		std::vector<uint32_t> indices;
 		std::vector<size_t> textures_index;
+		BoundingBoxf bounds;
+		bool occluder = false;
+
+		// Simplified index lists over the same vertices, coarser at each level
+		std::vector<MeshLod> lods;
+
+		// Clusters of the full detail indices, empty when the mesh is culled as a whole
+		std::vector<Meshlet> meshlets;
+
+		// Uploaded instead of vertices when not empty, decoded with bounds
+		std::vector<QuantizedVertex> quantized_vertices;
+
+		// Indices as uploaded to the GPU, 2 or 4 bytes each depending on format
+		static std::vector<uint8_t> pack_indices(const std::vector<uint32_t>& indices, IndexFormat format);
 
-		static Mesh FromOBJ(std::string_view filename);
+		static Mesh FromOBJ(std::string_view filename, const ImportOptions& options = ImportOptions{});
 		static Mesh Plane();
 	};
 
@@ -0,0 +1,24 @@
+#ifndef NTH_RENDERER_MESHLOD_HPP
+#define NTH_RENDERER_MESHLOD_HPP
+
+#include <Renderer/Vertex.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace Nth {
+	struct MeshLod {
+		std::vector<uint32_t> indices;
+
+		// Largest distance to the original surface, in mesh units
+		float error;
+	};
+
+	// Quadric edge collapse keeping the original vertices, seams and borders shared with other vertices are locked
+	MeshLod simplify_mesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, size_t target_index_count);
+
+	// Coarsest level whose error stays under max_pixel_error, coarsening needs a margin of hysteresis to avoid flicker
+	size_t select_lod(const std::vector<float>& level_errors, float pixels_per_unit, float max_pixel_error, float hysteresis, size_t current_lod);
+}
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef NTH_RENDERER_MESHOPTIMIZATION_HPP
+#define NTH_RENDERER_MESHOPTIMIZATION_HPP
+
+#include <Renderer/Vertex.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Nth {
+	// Post-transform cache behaviour of an index buffer, simulated with a FIFO cache
+	struct VertexCacheStatistics {
+		size_t triangle_count = 0;
+		size_t vertex_count = 0;
+		size_t miss_count = 0;
+
+		// Average cache miss ratio, transformed vertices per triangle
+		float acmr() const;
+		// Average transform to vertex ratio, 1 is ideal
+		float atvr() const;
+
+		VertexCacheStatistics& operator+=(const VertexCacheStatistics& statistics);
+
+		std::string to_string() const;
+	};
+
+	struct MeshOptimizationReport {
+		VertexCacheStatistics before;
+		VertexCacheStatistics after;
+
+		MeshOptimizationReport& operator+=(const MeshOptimizationReport& report);
+
+		std::string to_string() const;
+	};
+
+	VertexCacheStatistics analyze_vertex_cache(const std::vector<uint32_t>& indices, size_t vertex_count, uint32_t cache_size = 16);
+
+	// Forsyth's linear-speed vertex cache optimisation
+	void optimize_vertex_cache(std::vector<uint32_t>& indices, size_t vertex_count);
+
+	// Keeps the cache friendly order inside clusters and draws outward facing clusters first, reverts if ACMR grows past threshold
+	void optimize_overdraw(std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices, float threshold = 1.05f);
+
+	// Orders vertices by first use and drops unused ones, returns the new index of each old vertex
+	std::vector<uint32_t> optimize_vertex_fetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+}
+
+#endif
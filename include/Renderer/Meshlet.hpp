@@ -0,0 +1,34 @@
+#ifndef NTH_RENDERER_MESHLET_HPP
+#define NTH_RENDERER_MESHLET_HPP
+
+#include <Renderer/Vertex.hpp>
+
+#include <Maths/BoundingBox.hpp>
+#include <Maths/Vector3.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace Nth {
+	// Small cluster of triangles culled on its own, its indices are a contiguous range of the mesh indices
+	struct Meshlet {
+		uint32_t first_index;
+		uint32_t index_count;
+
+		BoundingBoxf bounds;
+		Vector3f center;
+		float radius;
+
+		// Every triangle faces away from a viewer inside the cone, a cutoff of 1 disables the test
+		Vector3f cone_axis;
+		float cone_cutoff;
+
+		static constexpr uint32_t max_vertices = 64;
+		static constexpr uint32_t max_triangles = 124;
+	};
+
+	// Reorders indices so each meshlet is contiguous, triangles are grown from shared vertices to keep meshlets compact
+	std::vector<Meshlet> build_meshlets(const std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, uint32_t max_vertices, uint32_t max_triangles);
+}
+
+#endif
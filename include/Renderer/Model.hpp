@@ -2,15 +2,44 @@
 #define NTH_RENDERER_MODEL_HPP
 
 #include <Renderer/Texture.hpp>
+#include <Renderer/MeshOptimization.hpp>
+#include <Renderer/ImportOptions.hpp>
+
+#include <Maths/Matrix4.hpp>
+#include <Maths/Vector3.hpp>
+#include <Maths/Vector4.hpp>
 
 #include <assimp/scene.h>
 
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_map>
 #include <vector>
 #include <filesystem>
 
 namespace Nth {
+	class ReadPool;
 	struct Mesh;
 
+	// Stored after its parent, rotation is a unit quaternion as in SceneGraph
+	struct ModelNode {
+		std::string name;
+		uint32_t parent;
+		Vector3f translation;
+		Vector4f rotation;
+		Vector3f scale;
+		std::vector<size_t> meshes;
+
+		static constexpr uint32_t no_parent = std::numeric_limits<uint32_t>::max();
+	};
+
+	// One placement of a shared mesh, in model space
+	struct ModelInstance {
+		size_t mesh_index;
+		Matrix4f transform;
+	};
+
 	class Model {
 	public:
 		Model() = default;
@@ -18,21 +47,46 @@ namespace Nth {
 		// TODO: Cleanup
 		std::vector<Texture> m_textures_loaded;
 		std::vector<Mesh> meshes;
+		// Only filled when imported with keep_hierarchy
+		std::vector<ModelNode> nodes;
+		// Filled when meshes aren't baked, a mesh used by several nodes is stored once
+		std::vector<ModelInstance> instances;
 
 		void add_mesh(Mesh&& mesh);
 		size_t add_texture(Texture&& texture);
+		void generate_lods(size_t count, float reduction);
+		// Throws if any mesh already has meshlets, as Mesh::optimize
+		MeshOptimizationReport optimize();
 
 		const std::vector<Texture>& textures() const;
 
-		static Model LoadFromFile(const std::filesystem::path& path);
+		// Meshes and textures are built as jobs of pool, it can be called from one of its jobs
+		static Model LoadFromFile(const std::filesystem::path& path, ReadPool& pool, const ImportOptions& options = ImportOptions{});
 	private:
-		Model(const std::filesystem::path& directory, const aiScene* scene);
+		// One mesh of the model to build, in the order of meshes
+		struct MeshJob {
+			const aiMesh* mesh;
+			aiMatrix4x4 transformation;
+			std::vector<size_t> textures;
+		};
 
-		void process_node(aiNode* node, const aiScene* scene, const aiMatrix4x4& parent_transformation);
-		Mesh process_mesh(aiMesh* mesh, const aiScene* scene, const aiMatrix4x4& transformation);
-		std::vector<size_t> load_material_textures(aiMaterial* mat, aiTextureType type, std::string_view type_name);
+		// Nodes are walked first, meshes and textures are then built on the pool
+		Model(const std::filesystem::path& directory, const aiScene* scene, ReadPool& pool, const ImportOptions& options);
+
+		void collect_node(const aiNode* node, const aiScene* scene, const aiMatrix4x4& parent_transformation, uint32_t parent_index, std::vector<MeshJob>& jobs);
+		Mesh process_mesh(const aiMesh* mesh, const aiMatrix4x4& transformation, std::vector<size_t> textures) const;
+		// Textures are only referenced here, they are decoded with the meshes
+		std::vector<size_t> collect_material_textures(const aiMaterial* mat, aiTextureType type, std::string_view type_name);
+		void decode_texture(size_t index);
 
 		std::filesystem::path m_directory;
+		ImportOptions m_options;
+
+		// Model mesh loaded for each assimp mesh
+		std::vector<size_t> m_mesh_indices;
+		// Index in m_textures_loaded of each texture path
+		std::unordered_map<std::string, size_t> m_texture_indices;
+		static constexpr size_t unloaded_mesh = std::numeric_limits<size_t>::max();
 	};
 
 }
@@ -0,0 +1,73 @@
+#ifndef NTH_RENDERER_OCCLUSIONBUFFER_HPP
+#define NTH_RENDERER_OCCLUSIONBUFFER_HPP
+
+#include <Maths/Matrix4.hpp>
+#include <Maths/Vector3.hpp>
+#include <Maths/BoundingBox.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace Nth {
+	class ReadPool;
+
+	// Low resolution depth buffer filled on CPU with a few occluders, used to reject hidden objects before upload
+	class OcclusionBuffer {
+	public:
+		OcclusionBuffer();
+		OcclusionBuffer(const OcclusionBuffer&) = delete;
+		OcclusionBuffer(OcclusionBuffer&&) = default;
+		~OcclusionBuffer() = default;
+
+		void resize(uint32_t width, uint32_t height);
+
+		void begin(const Matrix4f& view_projection);
+		void add_occluder(const std::vector<Vector3f>& vertices, const std::vector<uint32_t>& indices, const Matrix4f& transform);
+		// Tiles are shared between the pool's threads and the caller, the caller does them all without a pool
+		void rasterize(ReadPool* pool = nullptr);
+
+		bool is_visible(const BoundingBoxf& bounds, const Matrix4f& transform) const;
+
+		float depth(uint32_t x, uint32_t y) const;
+		uint32_t width() const;
+		uint32_t height() const;
+
+		OcclusionBuffer& operator=(const OcclusionBuffer&) = delete;
+		OcclusionBuffer& operator=(OcclusionBuffer&&) = default;
+
+		static constexpr uint32_t tile_width = 32;
+		static constexpr uint32_t tile_height = 16;
+
+	private:
+		// Edge functions and depth plane, evaluated at pixel centers
+		struct ScreenTriangle {
+			float edge_a[3];
+			float edge_b[3];
+			float edge_c[3];
+			float depth_a;
+			float depth_b;
+			float depth_c;
+			uint32_t min_x;
+			uint32_t min_y;
+			uint32_t max_x;
+			uint32_t max_y;
+		};
+
+		void rasterize_tile(uint32_t tile_index);
+		void rasterize_triangle(const ScreenTriangle& triangle, uint32_t begin_x, uint32_t begin_y, uint32_t end_x, uint32_t end_y);
+
+		uint32_t m_width;
+		uint32_t m_height;
+		uint32_t m_tile_count_x;
+		uint32_t m_tile_count_y;
+
+		Matrix4f m_view_projection;
+
+		std::vector<float> m_depth;
+		std::vector<float> m_tile_max_depth;
+		std::vector<ScreenTriangle> m_triangles;
+		std::vector<std::vector<uint32_t>> m_bins;
+	};
+}
+
+#endif
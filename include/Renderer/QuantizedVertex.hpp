@@ -0,0 +1,28 @@
+#ifndef NTH_RENDERER_QUANTIZEDVERTEX_HPP
+#define NTH_RENDERER_QUANTIZEDVERTEX_HPP
+
+#include <Renderer/Vertex.hpp>
+
+#include <Maths/BoundingBox.hpp>
+
+#include <cstdint>
+
+namespace Nth {
+	// Half the size of Vertex, positions are relative to the mesh bounds
+	struct QuantizedVertex {
+		uint16_t pos[4];
+		uint16_t texture_pos[2];
+		int8_t normal[2];
+		uint16_t padding;
+
+		static VertexInputDescription get_vertex_description();
+	};
+
+	QuantizedVertex quantize_vertex(const Vertex& vertex, const BoundingBoxf& bounds);
+	Vertex dequantize_vertex(const QuantizedVertex& vertex, const BoundingBoxf& bounds);
+
+	uint16_t encode_half(float value);
+	float decode_half(uint16_t value);
+}
+
+#endif
@@ -19,7 +19,10 @@ namespace Nth {
 		RenderBuffer(RenderBuffer&&) = default;
 		~RenderBuffer() = default;
 
-		void copy(const void* data, size_t size);
+		// Writes size bytes at offset, the rest of the buffer is left as is
+		void copy(const void* data, size_t size, size_t offset = 0);
+		// Same write recorded in command_buffer, the caller submits it and synchronizes readers
+		void upload(const Vk::CommandBuffer& command_buffer, const void* data, size_t size, size_t offset = 0);
 
 		RenderBuffer& operator=(const RenderBuffer&) = delete;
 		RenderBuffer& operator=(RenderBuffer&&) = default;
@@ -28,7 +31,9 @@ namespace Nth {
 	private:
 		void allocate_buffer_memory(const Vk::Device& device, VkMemoryPropertyFlagBits memoryProperty, Vk::Buffer& buffer, Vk::DeviceMemory& memory);
 		void create_staging(const Vk::Device& device, VkDeviceSize size);
-		void copy_by_staging(const void* data, size_t size);
+		void copy_by_staging(const void* data, size_t size, size_t offset);
+		void write_memory(Vk::DeviceMemory& memory, const void* data, size_t size, size_t offset);
+		void record_copy(const Vk::CommandBuffer& command_buffer, size_t size, size_t offset) const;
 
 		Vk::Buffer m_staging;
 		Vk::DeviceMemory m_staging_memory;
@@ -5,6 +5,7 @@
 #include <Renderer/Vulkan/Queue.hpp>
 #include <Renderer/Vulkan/CommandPool.hpp>
 
+#include <vector>
 
 namespace Nth {
 	namespace Vk {
@@ -23,14 +24,20 @@ namespace Nth {
 		~RenderDevice();
 
 		//TODO: Review this
-		void create(Vk::PhysicalDevice physicalDevice, const VkDeviceCreateInfo& infos, uint32_t present_queue_family_index, uint32_t graphic_queue_family_index);
+		void create(Vk::PhysicalDevice physicalDevice, const VkDeviceCreateInfo& infos, uint32_t present_queue_family_index, uint32_t graphic_queue_family_index, uint32_t transfer_queue_family_index);
 
 		Vk::CommandBuffer allocate_command_buffer() const;
+		// Recorded for the transfer queue, which may be the graphics one
+		Vk::CommandBuffer allocate_transfer_command_buffer() const;
+		// Families a resource written by the transfer queue and read by graphics is shared with
+		std::vector<uint32_t> upload_queue_families() const;
 
 		Vk::Queue& present_queue();
 		const Vk::Queue& present_queue() const;
 		Vk::Queue& graphics_queue();
 		const Vk::Queue& graphics_queue() const;
+		Vk::Queue& transfer_queue();
+		const Vk::Queue& transfer_queue() const;
 		Vk::Device& get_handle();
 		const Vk::Device& get_handle() const;
 
@@ -40,8 +47,10 @@ namespace Nth {
 		const RenderInstance& m_instance;
 		Vk::Queue m_present_queue;
 		Vk::Queue m_graphics_queue;
+		Vk::Queue m_transfer_queue;
 
 		Vk::CommandPool m_pool;
+		Vk::CommandPool m_transfer_pool;
 
 		Vk::Device m_device;
 	};
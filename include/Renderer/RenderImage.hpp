@@ -6,6 +6,8 @@
 #include <Renderer/Vulkan/DeviceMemory.hpp>
 #include <Renderer/Vulkan/Buffer.hpp>
 
+#include <functional>
+
 namespace Nth {
 	namespace Vk {
 		class CommandBuffer;
@@ -21,10 +23,18 @@ namespace Nth {
 		RenderImage(RenderImage&&) = default;
 		~RenderImage() = default;
 
-		void create(const RenderDevice& device, uint32_t width, uint32_t height, size_t staging_size, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties);
+		void create(const RenderDevice& device, uint32_t width, uint32_t height, uint32_t mip_levels, size_t staging_size, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties);
 		void create_view(VkFormat format, VkImageAspectFlags aspect_flags);
+		Vk::ImageView create_mip_view(VkFormat format, VkImageAspectFlags aspect_flags, uint32_t base_mip_level, uint32_t level_count) const;
+
+		uint32_t mip_levels() const;
 
 		void copy(void const* data, size_t size, uint32_t width, uint32_t height);
+		// Lets write fill the mapped staging memory, then copy_staged sends it without going through another buffer
+		void stage(size_t size, const std::function<void(void*)>& write);
+		void copy_staged(uint32_t width, uint32_t height);
+		// Same copy recorded in command_buffer, which may run on the transfer queue, readers wait on the semaphore its submit signals
+		void upload(const Vk::CommandBuffer& command_buffer, void const* data, size_t size, uint32_t width, uint32_t height);
 
 		RenderImage& operator=(const RenderImage&) = delete;
 		RenderImage& operator=(RenderImage&&) = default;
@@ -35,8 +45,10 @@ namespace Nth {
 	private:
 		uint32_t find_memory_type(const Vk::Device& device, uint32_t memory_type_bit, VkMemoryPropertyFlags properties) const;
 		void create_staging(const Vk::Device& device, size_t size);
+		void record_copy(const Vk::CommandBuffer& command_buffer, uint32_t width, uint32_t height, VkPipelineStageFlags dst_stage, VkAccessFlags dst_access) const;
 
 		RenderDevice const* m_device;
+		uint32_t m_mip_levels;
 
 		Vk::Buffer m_staging;
 		Vk::DeviceMemory m_staging_memory;
@@ -3,24 +3,96 @@
 
 #include <Renderer/RenderTexture.hpp>
 #include <Renderer/RenderBuffer.hpp>
+#include <Renderer/Meshlet.hpp>
+#include <Renderer/SceneParameters.hpp>
+#include <Renderer/Vertex.hpp>
 
+#include <Maths/BoundingBox.hpp>
+#include <Maths/Matrix4.hpp>
+
+#include <Utils/Hash.hpp>
+
+#include <memory>
 #include <vector>
 
 namespace Nth {
-	struct RenderMesh {
+	// Range of the shared index buffer holding one level of detail
+	struct RenderMeshLod {
+		uint32_t first_index;
+		uint32_t index_count;
+		float error;
+	};
+
+	// Buffers of a mesh, shared through the renderer's cache by every model with the same content
+	struct RenderGeometry {
 		RenderBuffer vertex_buffer;
 		RenderBuffer index_buffer;
+		ContentHash content_hash;
+		// Checked on a cache hit along with the hash
+		size_t vertices_size;
+		size_t indices_size;
+	};
+
+	struct RenderMesh {
+		std::shared_ptr<const RenderGeometry> geometry;
+
+		VertexFormat vertex_format;
+		VkIndexType index_type;
+		MeshGpuObject parameters;
 
 		std::vector<uint32_t> indices;
 		size_t texture_index;
+		BoundingBoxf bounds;
+
+		// Full detail first, all levels are stored one after the other in index_buffer
+		std::vector<RenderMeshLod> lods;
+
+		// Culled one by one when the full detail level is drawn
+		std::vector<Meshlet> meshlets;
+
+		// Positions kept on CPU for meshes flagged as occluder
+		std::vector<Vector3f> occluder_vertices;
+	};
+
+	// Placement of a mesh shared by several nodes, in model space
+	struct RenderMeshInstance {
+		size_t mesh_index;
+		Matrix4f transform;
+	};
+
+	struct RenderMeshRange {
+		const RenderMesh* first;
+		const RenderMesh* last;
+
+		const RenderMesh* begin() const;
+		const RenderMesh* end() const;
+	};
+
+	// Models loaded by Renderer::async_load_model stay out of draws until resident
+	enum class ModelStatus {
+		Loading,
+		Uploading,
+		Resident,
+		Failed
 	};
 
 	struct RenderModel {
 		RenderModel() = default;
-		RenderModel(std::vector<RenderMesh>&& meshes, std::vector<RenderTexture>&& textures);
+		RenderModel(std::vector<RenderMesh>&& meshes, std::vector<std::shared_ptr<const RenderTexture>>&& textures);
+
+		// Every mesh for RenderObject::all_meshes, otherwise the one mesh
+		RenderMeshRange meshes_of(size_t mesh_index) const;
+		const BoundingBoxf& bounds_of(size_t mesh_index) const;
 
 		std::vector<RenderMesh> meshes;
-		std::vector<RenderTexture> textures;
+		// Shared with other models using the same images
+		std::vector<std::shared_ptr<const RenderTexture>> textures;
+		BoundingBoxf bounds;
+
+		// Empty when the meshes were baked in model space
+		std::vector<RenderMeshInstance> instances;
+
+		ModelStatus status = ModelStatus::Resident;
 	};
 }
 
@@ -3,15 +3,30 @@
 
 #include <Maths/Matrix4.hpp>
 
+#include <limits>
+
 namespace Nth {
 	class Material;
 
+	// Structure culling and queries go through, objects moving every frame are cheaper to keep in the loose octree
+	enum class SpatialIndex {
+		BoundingVolumeHierarchy,
+		LooseOctree
+	};
+
 	class RenderObject {
 	public:
 		size_t model_index;
 		Material* material;
 
 		Matrix4f transform_matrix;
+
+		// Single mesh of the model to draw, used for nodes of a kept hierarchy
+		size_t mesh_index = RenderObject::all_meshes;
+
+		SpatialIndex spatial_index = SpatialIndex::BoundingVolumeHierarchy;
+
+		static constexpr size_t all_meshes = std::numeric_limits<size_t>::max();
 	};
 }
 
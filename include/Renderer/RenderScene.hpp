@@ -0,0 +1,80 @@
+#ifndef NTH_RENDERER_RENDERSCENE_HPP
+#define NTH_RENDERER_RENDERSCENE_HPP
+
+#include <Renderer/RenderObject.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace Nth {
+	// Stays valid until the object is removed, a reused slot gets a new generation
+	struct RenderObjectHandle {
+		uint32_t index;
+		uint32_t generation;
+
+		bool operator==(const RenderObjectHandle& handle) const;
+		bool operator!=(const RenderObjectHandle& handle) const;
+	};
+
+	// Consecutive slots to upload again
+	struct RenderSceneRange {
+		uint32_t first;
+		uint32_t count;
+	};
+
+	// Objects kept between frames, each frame copy of the instance data only receives what changed since its last upload
+	class RenderScene {
+	public:
+		RenderScene() = delete;
+		explicit RenderScene(size_t frame_count);
+		RenderScene(const RenderScene&) = delete;
+		RenderScene(RenderScene&&) = default;
+		~RenderScene() = default;
+
+		RenderObjectHandle add(const RenderObject& object);
+		void remove(RenderObjectHandle handle);
+		bool contains(RenderObjectHandle handle) const;
+
+		const RenderObject& get(RenderObjectHandle handle) const;
+		void set(RenderObjectHandle handle, const RenderObject& object);
+		void set_transform(RenderObjectHandle handle, const Matrix4f& transform);
+
+		// Indexed by slot, removed slots keep their last object until reused
+		const std::vector<RenderObject>& objects() const;
+		bool is_alive(size_t slot) const;
+		RenderObjectHandle handle_of(size_t slot) const;
+		size_t slot_count() const;
+		size_t size() const;
+
+		// Unique per scene, tells a frame copy filled from another scene apart
+		uint64_t id() const;
+		size_t frame_count() const;
+
+		// Sorted and merged, cleared for that frame only
+		std::vector<RenderSceneRange> take_dirty_ranges(size_t frame_index);
+
+		// Slots added, changed or removed since the last call, for structures built over the objects
+		std::vector<uint32_t> take_changed_slots();
+
+		RenderScene& operator=(const RenderScene&) = delete;
+		RenderScene& operator=(RenderScene&&) = default;
+
+	private:
+		void mark_dirty(uint32_t slot);
+		void mark_dirty(uint32_t slot, size_t channel);
+
+		std::vector<RenderObject> m_objects;
+		std::vector<uint32_t> m_generations;
+		std::vector<bool> m_alive;
+		std::vector<uint32_t> m_free_slots;
+		size_t m_size;
+
+		// Bit i is set while the slot waits in m_dirty_slots[i], the last channel is for take_changed_slots
+		std::vector<uint32_t> m_dirty_frames;
+		std::vector<std::vector<uint32_t>> m_dirty_slots;
+
+		uint64_t m_id;
+	};
+}
+
+#endif
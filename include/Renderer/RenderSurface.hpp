@@ -33,6 +33,8 @@ namespace Nth {
 		void create(const WindowHandle& window_hanlde);
 		const Vk::Surface& get_handle() const;
 		const Vk::RenderPass& get_render_pass() const;
+		const Vk::RenderPass& get_late_render_pass() const;
+		const DepthImage& get_depth() const;
 		// TODO : Review this
 		void init_render_pipeline(const Vector2ui& size);
 		
@@ -44,7 +46,8 @@ namespace Nth {
 
 	private:
 		void create_swapchain(const Vector2ui& size);
-		void create_render_pass();
+		void create_render_passes();
+		void create_render_pass(Vk::RenderPass& render_pass, bool first_pass) const;
 		void create_depth_ressource();
 		void on_window_size_changed(const Vector2ui& size);
 
@@ -62,6 +65,7 @@ namespace Nth {
 		Vk::Surface m_surface;
 		Vk::Swapchain m_swapchain;
 		Vk::RenderPass m_render_pass;
+		Vk::RenderPass m_late_render_pass;
 		DepthImage m_depth;
 
 		size_t m_ressource_index;
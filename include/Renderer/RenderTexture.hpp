@@ -5,6 +5,8 @@
 #include <Renderer/Vulkan/Sampler.hpp>
 #include <Renderer/ShaderBinding.hpp>
 
+#include <Utils/Hash.hpp>
+
 namespace Nth {
 	class RenderDevice;
 
@@ -23,6 +25,11 @@ namespace Nth {
 
 		ShaderBinding binding;
 
+		// Key of the renderer's cache, size is checked on a hit along with the hash
+		ContentHash content_hash;
+		uint32_t width = 0;
+		uint32_t height = 0;
+
 		RenderTexture& operator=(const RenderTexture&) = delete;
 		RenderTexture& operator=(RenderTexture&&) = default;
 	private:
@@ -13,14 +13,34 @@
 #include <Renderer/RenderBuffer.hpp>
 #include <Renderer/RenderModel.hpp>
 #include <Renderer/ShaderBinding.hpp>
+#include <Renderer/ComputeShader.hpp>
+#include <Renderer/DepthPyramid.hpp>
+#include <Renderer/OcclusionBuffer.hpp>
+#include <Renderer/LightClusters.hpp>
+#include <Renderer/RenderScene.hpp>
+#include <Renderer/BoundingVolumeHierarchy.hpp>
+#include <Renderer/LooseOctree.hpp>
+#include <Renderer/ImportOptions.hpp>
+#include <Renderer/Vulkan/CommandBuffer.hpp>
+#include <Renderer/Vulkan/Fence.hpp>
+#include <Renderer/Vulkan/Semaphore.hpp>
+
+#include <Utils/ReadPool.hpp>
 
 #include <vector>
 #include <array>
+#include <filesystem>
+#include <future>
+#include <list>
+#include <memory>
 #include <string_view>
+#include <unordered_map>
 
 namespace Nth {
 	class RenderObject;
 	class Model;
+	class CookedModel;
+	struct CookedMesh;
 	struct Texture;
 	struct BindingInfo;
 	class Window;
@@ -38,24 +58,95 @@ namespace Nth {
 		Material create_material(const MaterialInfos& infos);
 
 		size_t register_model(const Model& model);
+		// Blobs are copied from the mapped file to staging without going through Mesh
+		size_t register_model(const CookedModel& model);
 
+		// Returns at once, the file (.nthc files are read as cooked models) is read and decoded in the background then uploaded by the transfer queue
+		// Objects of the model are skipped by draw until it is resident, model_instances should only be asked once it is
+		size_t async_load_model(const std::filesystem::path& path, const ImportOptions& options = ImportOptions{});
+		ModelStatus model_status(size_t model_index) const;
+		// Threads of the background loads, models loaded directly can share them
+		ReadPool& read_pool();
+
+		// One object per instance of the model's shared meshes, placed by transform, or a single object if it has none
+		std::vector<RenderObject> model_instances(size_t model_index, Material& material, const Matrix4f& transform = Matrix4f::Identity()) const;
+
+		// Frame count matches this renderer's frame copies
+		RenderScene create_scene() const;
+
+		// Kept for immediate use, objects are diffed with the previous call through an internal scene
 		void draw(const std::vector<RenderObject>& objects);
+		void draw(RenderScene& scene);
+
+		// World bounds of the scene's objects split by RenderObject::spatial_index, items are scene slots, brought up to date with the scene first
+		const BoundingVolumeHierarchy& scene_bvh(RenderScene& scene);
+		const LooseOctree& scene_octree(RenderScene& scene);
 
 		// TODO: Move out, used for sync destructor
 		void wait_idle() const;
 
 		// TODO: Move out
 		LightGpuObject light;
+		std::vector<PointLightGpuObject> point_lights;
 		Camera camera;
 
+		bool occlusion_culling;
+		bool software_occlusion_culling;
+
+		// Materials don't cull back faces, so only enable it for scenes made of closed meshes
+		bool cluster_cone_culling;
+
+		// Largest simplification error allowed on screen, in pixels
+		float lod_pixel_error;
+		float lod_hysteresis;
+
+		// Read once by set_render_on, materials and object uploads then use it
+		InstanceFormat instance_format;
+
+		// Subdivided by the loose octree, changing it rebuilds the octree on the next update
+		BoundingBoxf octree_region;
+
 		static constexpr uint32_t resource_count = 3;
+		static constexpr uint32_t occlusion_buffer_width = 256;
+		static constexpr size_t min_object_capacity = 1024;
+		static constexpr uint32_t model_buffer_shrink_frames = 300;
+		static constexpr float z_near = 0.1f;
+		static constexpr float z_far = 10.f;
 
 		Renderer& operator=(const Renderer&) = delete;
 		Renderer& operator=(Renderer&&) = default;
 
 	private:
+		// Read and decoded off the render thread
+		struct StreamedModel;
+
+		// The model's slot in m_renders stays empty until the fence signals
+		struct ModelUpload {
+			size_t model_index;
+			std::future<std::shared_ptr<StreamedModel>> loading;
+			RenderModel model;
+			Vk::CommandBuffer command_buffer;
+			Vk::Fence fence;
+			Vk::Semaphore semaphore;
+		};
+
 		ViewerGpuObject get_viewer_data() const;
 		void update_descriptor_set();
+		void update_light_descriptor_set();
+		std::vector<VkSemaphore> update_streaming();
+		void start_upload(ModelUpload& upload);
+		void update_spatial_indices(RenderScene& scene);
+		BoundingBoxf world_bounds(const RenderObject& object) const;
+		std::vector<size_t> software_cull(const RenderScene& scene, const ViewerGpuObject& viewer);
+		void update_lods(const std::vector<RenderObject>& objects, const std::vector<size_t>& visible_objects, const ViewerGpuObject& viewer);
+		void update_culling_descriptor_set();
+		void reserve_draw_buffers(size_t index, size_t draw_count);
+		bool reserve_model_buffer(size_t index, size_t object_count);
+		void upload_objects(RenderScene& scene);
+		void cull(const Vk::CommandBuffer& command_buffer, uint32_t phase, uint32_t draw_count) const;
+		void record_draws(const Vk::CommandBuffer& command_buffer, const std::vector<RenderObject>& objects, const std::vector<size_t>& visible_objects, const std::vector<uint32_t>& mesh_draw_counts, const RenderBuffer& commands) const;
+
+		static DrawGpuObject make_draw(const BoundingBoxf& bounds, const Vector3f& center, float radius, const Vector3f& cone_axis, float cone_cutoff, uint32_t object_index);
 
 		RenderInstance m_vulkan;
 		RenderSurface m_render_surface;
@@ -68,9 +159,17 @@ namespace Nth {
 		ShaderBinding allocate_shader_binding(size_t index);
 
 		size_t m_resource_index;
+		InstanceFormat m_instance_format;
 
 		std::array<ShaderBinding, Renderer::resource_count> m_model_bindings;
 		std::array<RenderBuffer, Renderer::resource_count> m_model_buffers;
+		// Frames in a row each model buffer stayed mostly empty
+		std::array<uint32_t, Renderer::resource_count> m_model_buffer_idle_frames;
+		// Id of the scene each model buffer holds
+		std::array<uint64_t, Renderer::resource_count> m_model_buffer_scenes;
+
+		RenderScene m_immediate_scene;
+		std::vector<RenderObjectHandle> m_immediate_handles;
 
 		std::array<ShaderBinding, Renderer::resource_count> m_viewer_bindings;
 		std::array<RenderBuffer, Renderer::resource_count> m_viewer_buffers;
@@ -78,12 +177,58 @@ namespace Nth {
 		std::array<ShaderBinding, Renderer::resource_count> m_light_bindings;
 		std::array<RenderBuffer, Renderer::resource_count> m_light_buffers;
 
+		DepthPyramid m_depth_pyramid;
+		Vk::DescriptorSetLayout m_culling_layout;
+		ComputeShader m_culling;
+		std::array<ShaderBinding, Renderer::resource_count> m_culling_bindings;
+		std::array<RenderBuffer, Renderer::resource_count> m_draw_buffers;
+		std::array<RenderBuffer, Renderer::resource_count> m_early_command_buffers;
+		std::array<RenderBuffer, Renderer::resource_count> m_late_command_buffers;
+
+		OcclusionBuffer m_occlusion_buffer;
+
+		BoundingVolumeHierarchy m_scene_bvh;
+		LooseOctree m_scene_octree;
+		BoundingBoxf m_octree_region;
+		// Id of the scene both indices are built over
+		uint64_t m_spatial_scene;
+
+		LightClusters m_light_clusters;
+
+		// Indexed by scene slot
+		std::vector<size_t> m_object_lods;
+
 		// TODO: Review this
-		RenderMesh register_mesh(const Mesh& mesh) const;
-		RenderTexture register_texture(const Texture& texture);
+		// Copies are recorded in transfer_commands when given, otherwise done right away
+		RenderModel create_render_model(const Model& model, const Vk::CommandBuffer* transfer_commands);
+		RenderModel create_render_model(const CookedModel& model, std::vector<std::shared_ptr<const RenderTexture>>&& textures, const Vk::CommandBuffer* transfer_commands);
+		RenderMesh register_mesh(const Mesh& mesh, const Vk::CommandBuffer* transfer_commands);
+		RenderMesh register_mesh(const CookedModel& model, const CookedMesh& mesh, const Vk::CommandBuffer* transfer_commands);
+		// Looked up in the caches by content hash, only created and uploaded on a miss
+		std::shared_ptr<const RenderGeometry> register_geometry(const void* vertices, size_t vertices_size, const void* indices, size_t indices_size, VertexFormat vertex_format, IndexFormat index_format, const Vk::CommandBuffer* transfer_commands);
+		std::shared_ptr<const RenderTexture> register_texture(const Texture& texture, const Vk::CommandBuffer* transfer_commands);
+		// Decodes the image straight into the texture's staging memory, shares the texture of the same file loaded by register_texture
+		std::shared_ptr<const RenderTexture> register_texture_file(const std::filesystem::path& path);
+		std::shared_ptr<const RenderTexture> cached_texture(const ContentHash& content_hash, uint32_t width, uint32_t height) const;
+		std::shared_ptr<RenderTexture> create_texture(uint32_t width, uint32_t height, size_t size, const ContentHash& content_hash);
+		// Adds resources of a model uploaded by the transfer queue to the caches, once its copies completed
+		void share_resources(const RenderModel& model);
+		static void upload(RenderBuffer& buffer, const void* data, size_t size, const Vk::CommandBuffer* transfer_commands);
 		Window* m_window;
 
 		std::vector<RenderModel> m_renders;
+
+		// Entries expire with the last model holding them
+		std::unordered_map<ContentHash, std::weak_ptr<const RenderGeometry>> m_geometry_cache;
+		std::unordered_map<ContentHash, std::weak_ptr<const RenderTexture>> m_texture_cache;
+
+		// Streamed models are loaded as its jobs, their images read as batches on the same threads
+		std::unique_ptr<ReadPool> m_read_pool;
+
+		// Erased from the middle as they complete, a list never moves the others
+		std::list<ModelUpload> m_uploads;
+		// Kept until the frame waiting on their semaphore is done
+		std::array<std::vector<ModelUpload>, Renderer::resource_count> m_retired_uploads;
 	};
 }
 
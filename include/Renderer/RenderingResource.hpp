@@ -6,8 +6,10 @@
 #include <Renderer/Vulkan/CommandBuffer.hpp>
 #include <Renderer/Vulkan/Semaphore.hpp>
 #include <Renderer/Vulkan/Fence.hpp>
+#include <Renderer/Vulkan/RenderPass.hpp>
 
 #include <functional>
+#include <vector>
 
 namespace Nth {
 	class Vk::Device;
@@ -26,7 +28,11 @@ namespace Nth {
 		void create(uint32_t family_index);
 
 		void prepare(std::function<void(Vk::CommandBuffer&)> action);
-		void present(const Vector2ui& size);
+		void begin();
+		void begin_render_pass(const Vk::RenderPass& render_pass);
+		void end_render_pass();
+		void end();
+		void present(const Vector2ui& size, const std::vector<VkSemaphore>& upload_semaphores = {});
 
 		Vk::Framebuffer framebuffer;
 		Vk::CommandPool command_pool;
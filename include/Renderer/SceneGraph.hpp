@@ -0,0 +1,79 @@
+#ifndef NTH_RENDERER_SCENEGRAPH_HPP
+#define NTH_RENDERER_SCENEGRAPH_HPP
+
+#include <Renderer/RenderScene.hpp>
+
+#include <Maths/Matrix4.hpp>
+#include <Maths/Vector3.hpp>
+#include <Maths/Vector4.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace Nth {
+	class ReadPool;
+
+	// Transform hierarchy, nodes are stored after their parent so one forward pass resolves it
+	class SceneGraph {
+	public:
+		SceneGraph() = default;
+		SceneGraph(const SceneGraph&) = delete;
+		SceneGraph(SceneGraph&&) = default;
+		~SceneGraph() = default;
+
+		// Rotation is a unit quaternion, xyz then w
+		uint32_t add_node(uint32_t parent, const Vector3f& translation, const Vector4f& rotation, const Vector3f& scale);
+
+		void set_translation(uint32_t node, const Vector3f& translation);
+		void set_rotation(uint32_t node, const Vector4f& rotation);
+		void set_scale(uint32_t node, const Vector3f& scale);
+
+		const Vector3f& translation(uint32_t node) const;
+		const Vector4f& rotation(uint32_t node) const;
+		const Vector3f& scale(uint32_t node) const;
+		uint32_t parent(uint32_t node) const;
+		size_t size() const;
+
+		// Valid after update
+		const Matrix4f& world_matrix(uint32_t node) const;
+
+		// Recomputes changed nodes and their descendants only, returns them in storage order
+		// Large levels are shared between the pool's threads and the caller, the caller does them all without a pool
+		const std::vector<uint32_t>& update(ReadPool* pool = nullptr);
+
+		// The object follows the node, its transform is set by apply
+		void attach(uint32_t node, RenderObjectHandle object);
+		void apply(RenderScene& scene) const;
+
+		SceneGraph& operator=(const SceneGraph&) = delete;
+		SceneGraph& operator=(SceneGraph&&) = default;
+
+		static Matrix4f compose(const Vector3f& translation, const Vector4f& rotation, const Vector3f& scale);
+
+		static constexpr uint32_t no_parent = std::numeric_limits<uint32_t>::max();
+
+	private:
+		// Same as parent * local, one row of the result per SSE register when available
+		static Matrix4f multiply(const Matrix4f& parent, const Matrix4f& local);
+
+		void mark_dirty(uint32_t node);
+
+		// Local transforms, one array per component
+		std::vector<Vector3f> m_translations;
+		std::vector<Vector4f> m_rotations;
+		std::vector<Vector3f> m_scales;
+
+		std::vector<uint32_t> m_parents;
+		std::vector<uint32_t> m_depths;
+		std::vector<uint8_t> m_dirty;
+		std::vector<Matrix4f> m_world_matrices;
+
+		std::vector<std::vector<RenderObjectHandle>> m_objects;
+
+		std::vector<uint32_t> m_changed;
+		uint32_t m_max_depth = 0;
+	};
+}
+
+#endif
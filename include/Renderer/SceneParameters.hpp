@@ -2,6 +2,7 @@
 #define NTH_RENDERER_SCENEPARAMETERS_HPP
 
 #include <Maths/Matrix4.hpp>
+#include <Maths/Vector2.hpp>
 #include <Maths/Vector3.hpp>
 #include <Maths/Vector4.hpp>
 
@@ -15,14 +16,56 @@ namespace Nth {
 		alignas(4) float specular_strength;
 	};
 
+	struct PointLightGpuObject {
+		alignas(16) Vector3f position;
+		alignas(4) float radius;
+		alignas(16) Vector4f color;
+	};
+
+	struct ClusterGpuObject {
+		uint32_t grid_size[3];
+		uint32_t light_count;
+		Vector2f screen_size;
+		float z_near;
+		float z_far;
+	};
+
 	// TODO: Precalculate VP CPU-side
 	struct ViewerGpuObject {
 		Matrix4f view;
 		Matrix4f proj;
 	};
 
+	// Chosen at renderer setup, Affine uploads less than half the data but shaders rebuild the normal matrix per vertex
+	enum class InstanceFormat {
+		Matrix,
+		Affine
+	};
+
 	struct ModelGpuObject {
 		Matrix4f model;
+		// std140 mat3, see compute_normal_matrices
+		Vector4f normal[3];
+	};
+
+	// GLSL mat3x4, see make_affine_model
+	struct AffineModelGpuObject {
+		Vector4f columns[3];
+	};
+
+	// Pushed per mesh, decodes quantized positions
+	struct MeshGpuObject {
+		Vector4f position_offset;
+		Vector4f position_scale;
+	};
+
+	struct DrawGpuObject {
+		Vector4f bounds_min;
+		Vector4f bounds_max;
+		Vector4f sphere;
+		Vector4f cone;
+		uint32_t object_index;
+		uint32_t padding[3];
 	};
 }
 
@@ -2,24 +2,33 @@
 #define NTH_RENDERER_SHADERBINDING_HPP
 
 #include <Renderer/Vulkan/DescriptorSet.hpp>
+#include <Renderer/Vulkan/DescriptorSetLayout.hpp>
 
 #include <cstdint>
 #include <variant>
 #include <vector>
 
 namespace Nth {
+	namespace Vk {
+		class Device;
+		class ImageView;
+		class Sampler;
+	}
+
 	class RenderBuffer;
 	class RenderTexture;
 
 	enum class ShaderType {
 		Fragment,
-		Vertex
+		Vertex,
+		Compute
 	};
 
 	enum class BindingType {
 		Uniform,
 		Texture,
-		Storage
+		Storage,
+		StorageImage
 	};
 
 	struct BindingInfo {
@@ -46,11 +55,24 @@ namespace Nth {
 		uint64_t range;
 	};
 
+	struct ImageBinding {
+		const Vk::ImageView& view;
+		const Vk::Sampler& sampler;
+		VkImageLayout layout;
+	};
+
+	struct StorageImageBinding {
+		const Vk::ImageView& view;
+		VkImageLayout layout;
+	};
+
 	struct Binding {
-		std::variant<UniformBinding, TextureBinding, StorageBinding> info;
+		std::variant<UniformBinding, TextureBinding, StorageBinding, ImageBinding, StorageImageBinding> info;
 		uint32_t dstIndex;
 	};
 
+	Vk::DescriptorSetLayout create_descriptor_set_layout(const Vk::Device& device, const std::vector<BindingInfo>& bindings);
+
 	class ShaderBinding {
 	public:
 		ShaderBinding() = default;
@@ -1,11 +1,14 @@
 #ifndef NTH_RENDERER_TEXTURE_HPP
 #define NTH_RENDERER_TEXTURE_HPP
 
+#include <Utils/Hash.hpp>
+
 #include <string_view>
 #include <filesystem>
 #include <vector>
 
 namespace Nth {
+	class AssetFile;
 	struct Color;
 
 	struct Texture {
@@ -14,9 +17,17 @@ namespace Nth {
 		std::vector<unsigned char> data;
 		unsigned int height;
 		unsigned int width;
+		// Key of the renderer's cache, set when loading so it's computed on the loading threads, empty textures are hashed when registered
+		ContentHash content_hash;
 	};
 
 	Texture texture_from_file(const std::filesystem::path& path);
+	// From a file already read, like by ReadPool::read_batch
+	Texture texture_from_file(const AssetFile& file, const std::filesystem::path& path);
+	// Over the size and pixels, for textures not loaded from a file
+	ContentHash texture_content_hash(const Texture& texture);
+	// Over the encoded bytes, so a file gets the same key whether it's decoded up front or into staging
+	ContentHash texture_file_hash(const AssetFile& file);
 	Texture uniform_texture(const Color& color);
 }
 
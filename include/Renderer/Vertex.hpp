@@ -17,6 +17,16 @@ namespace Nth {
 		VkPipelineVertexInputStateCreateFlags flags = 0;
 	};
 
+	enum class VertexFormat {
+		Full,
+		Quantized
+	};
+
+	enum class IndexFormat {
+		UInt16,
+		UInt32
+	};
+
 	struct Vertex {
 		Vector3f pos;
 		Vector2f texture_pos;
@@ -20,6 +20,7 @@ namespace Nth {
 			void bind_vertex_buffer(VkBuffer buffer, VkDeviceSize offset) const;
 			void bind_index_buffer(VkBuffer buffer, VkDeviceSize offset, VkIndexType index_type) const;
 			void bind_descriptor_sets(VkPipelineLayout layout, uint32_t first_set, uint32_t descriptor_set_count, VkDescriptorSet const* descriptor_sets, uint32_t dynamic_offset_count, uint32_t const* dynamic_offsets) const;
+			void bind_descriptor_sets(VkPipelineBindPoint pipeline_bind_point, VkPipelineLayout layout, uint32_t first_set, uint32_t descriptor_set_count, VkDescriptorSet const* descriptor_sets, uint32_t dynamic_offset_count, uint32_t const* dynamic_offsets) const;
 			void bind_pipeline(VkPipelineBindPoint pipeline_bind_point, VkPipeline pipeline) const;
 			
 			void clear_color_image(VkImage image, VkImageLayout layout, const VkClearColorValue& color, uint32_t range_count, VkImageSubresourceRange const* p_ranges) const;
@@ -28,6 +29,8 @@ namespace Nth {
 
 			void draw(uint32_t vertex_count, uint32_t instance_count, uint32_t first_vertex, uint32_t first_instance) const;
 			void draw_indexed(uint32_t index_count, uint32_t instance_count, uint32_t first_index, int32_t vertex_offset, uint32_t first_instance) const;
+			void draw_indexed_indirect(VkBuffer buffer, VkDeviceSize offset, uint32_t draw_count, uint32_t stride) const;
+			void dispatch(uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z) const;
 
 			void end() const;
 			void end_render_pass() const;
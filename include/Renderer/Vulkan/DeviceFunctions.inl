@@ -42,10 +42,13 @@ NTH_RENDERER_VK_DEVICE_FUNCTION(vkCreateFramebuffer)
 NTH_RENDERER_VK_DEVICE_FUNCTION(vkCreateShaderModule)
 NTH_RENDERER_VK_DEVICE_FUNCTION(vkCreatePipelineLayout)
 NTH_RENDERER_VK_DEVICE_FUNCTION(vkCreateGraphicsPipelines)
+NTH_RENDERER_VK_DEVICE_FUNCTION(vkCreateComputePipelines)
 NTH_RENDERER_VK_DEVICE_FUNCTION(vkCmdBeginRenderPass)
 NTH_RENDERER_VK_DEVICE_FUNCTION(vkCmdBindPipeline)
 NTH_RENDERER_VK_DEVICE_FUNCTION(vkCmdDraw)
 NTH_RENDERER_VK_DEVICE_FUNCTION(vkCmdDrawIndexed)
+NTH_RENDERER_VK_DEVICE_FUNCTION(vkCmdDrawIndexedIndirect)
+NTH_RENDERER_VK_DEVICE_FUNCTION(vkCmdDispatch)
 NTH_RENDERER_VK_DEVICE_FUNCTION(vkCmdEndRenderPass)
 NTH_RENDERER_VK_DEVICE_FUNCTION(vkDestroyShaderModule)
 NTH_RENDERER_VK_DEVICE_FUNCTION(vkDestroyPipelineLayout)
@@ -70,6 +73,7 @@ NTH_RENDERER_VK_DEVICE_FUNCTION(vkCmdBindIndexBuffer)
 NTH_RENDERER_VK_DEVICE_FUNCTION(vkCmdPushConstants)
 NTH_RENDERER_VK_DEVICE_FUNCTION(vkResetCommandPool)
 NTH_RENDERER_VK_DEVICE_FUNCTION(vkWaitForFences)
+NTH_RENDERER_VK_DEVICE_FUNCTION(vkGetFenceStatus)
 NTH_RENDERER_VK_DEVICE_FUNCTION(vkResetFences)
 NTH_RENDERER_VK_DEVICE_FUNCTION(vkFreeMemory)
 NTH_RENDERER_VK_DEVICE_FUNCTION(vkDestroyBuffer)
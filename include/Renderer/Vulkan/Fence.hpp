@@ -17,6 +17,7 @@ namespace Nth {
 			void create(const Device& device, VkFenceCreateFlags flags);
 			void reset() const;
 			void wait(uint64_t timeout) const;
+			bool is_signaled() const;
 			
 			VkFence operator()() const;
 
@@ -15,6 +15,7 @@ namespace Nth {
 			~Pipeline();
 
 			void create_graphics(const Device& device, VkPipelineCache cache, const VkGraphicsPipelineCreateInfo& infos);
+			void create_compute(const Device& device, VkPipelineCache cache, const VkComputePipelineCreateInfo& infos);
 			void destroy();
 
 			VkPipeline operator()() const;
@@ -15,11 +15,12 @@ namespace Nth {
 			~Sampler();
 
 			void create(const Device& device, const VkSamplerCreateInfo& info);
+			void destroy();
 
 			VkSampler operator()() const;
 
 			Sampler& operator=(const Sampler&) = delete;
-			Sampler& operator=(Sampler&&) = delete;
+			Sampler& operator=(Sampler&& object) noexcept;
 
 		private:
 			VkSampler m_sampler;
@@ -0,0 +1,95 @@
+#ifndef NTH_UTILS_ARCHIVE_HPP
+#define NTH_UTILS_ARCHIVE_HPP
+
+#include <Utils/MappedFile.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Nth {
+	// Offsets are in bytes from the start of the file, which is written in the host byte order
+	struct ArchiveHeader {
+		std::array<char, 4> magic;
+		uint32_t version;
+		uint32_t entry_count;
+		uint32_t block_size;
+		uint64_t entry_table;
+		uint64_t file_size;
+	};
+
+	// Entries are sorted by path, every block decodes to block_size bytes except the last one
+	struct ArchiveEntry {
+		uint64_t path;
+		uint64_t size;
+		uint64_t blocks;
+		uint32_t path_size;
+		uint32_t block_count;
+		uint32_t compressed_blocks;
+		uint32_t padding;
+	};
+
+	// Blocks which don't compress are stored as they are, stored_size is their decoded size then
+	struct ArchiveBlock {
+		uint64_t offset;
+		uint32_t stored_size;
+		uint32_t padding;
+	};
+
+	// Files packed together, opening maps the archive and checks its table of contents and blocks
+	class Archive {
+	public:
+		Archive() = delete;
+		Archive(const Archive&) = delete;
+		Archive(Archive&&) = default;
+		~Archive() = default;
+
+		const std::vector<ArchiveEntry>& entries() const;
+		// Null if the archive has no such file
+		const ArchiveEntry* find(const std::filesystem::path& path) const;
+		std::string_view entry_path(const ArchiveEntry& entry) const;
+
+		// Points into the mapping when no block of the entry is compressed and its blocks follow each other, null otherwise
+		const uint8_t* view(const ArchiveEntry& entry) const;
+		// Only the blocks covering the range are read, whole blocks are decoded straight into destination
+		void read(const ArchiveEntry& entry, uint64_t offset, void* destination, size_t size) const;
+		std::vector<uint8_t> read(const ArchiveEntry& entry) const;
+
+		// Range given in the entry as for MappedFile::advise, only stored entries are read in place and take hints
+		void advise(const ArchiveEntry& entry, MappedFile::Access access, size_t offset = 0, size_t size = 0) const;
+
+		Archive& operator=(const Archive&) = delete;
+		Archive& operator=(Archive&&) = default;
+
+		static Archive LoadFromFile(const std::filesystem::path& path);
+		// Name a path is stored and looked up under, relative to the working directory like a loose file
+		static std::string entry_name(const std::filesystem::path& path);
+
+		static constexpr std::array<char, 4> magic{ 'N', 'T', 'H', 'A' };
+		static constexpr uint32_t version = 1;
+		static constexpr uint32_t default_block_size = 64 * 1024;
+		// Entries start on a cache line, so stored files keep the alignment of their own blobs
+		static constexpr uint64_t entry_alignment = 64;
+
+	private:
+		Archive(const std::filesystem::path& path);
+
+		ArchiveBlock block(const ArchiveEntry& entry, size_t index) const;
+
+		std::filesystem::path m_path;
+		MappedFile m_file;
+		ArchiveHeader m_header;
+		std::vector<ArchiveEntry> m_entries;
+		// By entry, whether view can point into the mapping
+		std::vector<bool> m_in_place;
+	};
+
+	// Files are stored under their path relative to root
+	void save_archive(const std::filesystem::path& root, const std::vector<std::filesystem::path>& files, const std::filesystem::path& path, uint32_t block_size = Archive::default_block_size);
+}
+
+#endif
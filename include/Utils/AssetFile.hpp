@@ -0,0 +1,61 @@
+#ifndef NTH_UTILS_ASSETFILE_HPP
+#define NTH_UTILS_ASSETFILE_HPP
+
+#include <Utils/MappedFile.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Nth {
+	class Archive;
+	struct ArchiveEntry;
+
+	// Content of a file loaded by path, from the mounted archives first then from the disk
+	class AssetFile {
+	public:
+		AssetFile();
+		AssetFile(const AssetFile&) = delete;
+		AssetFile(AssetFile&&) = default;
+		~AssetFile() = default;
+
+		// Only mapped content takes hints, decompressed content is already in memory
+		void advise(MappedFile::Access access, size_t offset = 0, size_t size = 0) const;
+
+		const uint8_t* data() const;
+		size_t size() const;
+
+		AssetFile& operator=(const AssetFile&) = delete;
+		AssetFile& operator=(AssetFile&&) = default;
+
+		// Loose and stored files are mapped, compressed ones are decompressed once
+		static AssetFile Open(const std::filesystem::path& path);
+		static bool Exists(const std::filesystem::path& path);
+
+		// Archives mounted last are searched first, their files are found by the same paths as loose files
+		static void Mount(const std::filesystem::path& archive);
+		static void UnmountAll();
+
+	private:
+		struct MountedArchives {
+			std::mutex mutex;
+			std::vector<std::shared_ptr<const Archive>> archives;
+		};
+
+		static MountedArchives& mounted_archives();
+		// Copied so loaders on other threads don't hold the lock while reading
+		static std::vector<std::shared_ptr<const Archive>> archives();
+
+		MappedFile m_file;
+		std::shared_ptr<const Archive> m_archive;
+		std::vector<uint8_t> m_content;
+		const ArchiveEntry* m_entry;
+		const uint8_t* m_data;
+		size_t m_size;
+	};
+}
+
+#endif
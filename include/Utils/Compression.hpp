@@ -0,0 +1,15 @@
+#ifndef NTH_UTILS_COMPRESSION_HPP
+#define NTH_UTILS_COMPRESSION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Nth {
+	// LZ4 block format without a frame, blocks have to be under 4 GiB
+	std::vector<uint8_t> compress_block(const void* data, size_t size);
+	// Decodes into memory owned by the caller, throws if the block is malformed or doesn't decode to exactly destination_size bytes
+	void decompress_block(const void* data, size_t size, void* destination, size_t destination_size);
+}
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef NTH_UTILS_HASH_HPP
+#define NTH_UTILS_HASH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+
+namespace Nth {
+	constexpr uint64_t hash_seed = 14695981039346656037ull;
+
+	// FNV-1a, stable across runs and platforms so hashes can be stored on disk, chained by passing the previous hash
+	uint64_t hash_bytes(const void* data, size_t size, uint64_t hash = hash_seed);
+	uint64_t hash_file(const std::filesystem::path& path, uint64_t hash = hash_seed);
+
+	// Key of content shared by equality, wide enough that distinct buffers never meet in practice
+	struct ContentHash {
+		uint64_t low = 0;
+		uint64_t high = 0;
+
+		bool operator==(const ContentHash& other) const;
+		bool operator!=(const ContentHash& other) const;
+	};
+
+	// Reads 8 bytes at a time on 4 independent lanes, so hashing keeps up with uploads of large buffers
+	ContentHash hash_content(const void* data, size_t size, uint64_t seed = 0);
+}
+
+namespace std {
+	template<>
+	struct hash<Nth::ContentHash> {
+		size_t operator()(const Nth::ContentHash& hash) const {
+			return static_cast<size_t>(hash.low);
+		}
+	};
+}
+
+#endif
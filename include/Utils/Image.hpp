@@ -6,6 +6,8 @@
 #include <memory>
 
 namespace Nth {
+	class AssetFile;
+
 	enum class PixelChannel {
 		Unknow = 0,
 		Grey = 1,
@@ -14,10 +16,18 @@ namespace Nth {
 		Rgba = 4
 	};
 
+	// Read from the header, channels are the ones pixels are decoded to
+	struct ImageInfo {
+		unsigned int width;
+		unsigned int height;
+		unsigned int channels;
+	};
+
 	class Image {
 	public:
 		Image() = default;
 		Image(unsigned int width, unsigned int height, unsigned int channels, std::vector<unsigned char> const& pixels);
+		Image(unsigned int width, unsigned int height, unsigned int channels, std::vector<unsigned char>&& pixels);
 		Image(const Image&) = default;
 		Image(Image&&) = default;
 		~Image() = default;
@@ -26,13 +36,28 @@ namespace Nth {
 		unsigned int height() const;
 		unsigned int channels() const;
 		const std::vector<unsigned char>& pixels() const;
+		// Moves the pixels out, the image is left empty
+		std::vector<unsigned char> take_pixels();
 
 		static Image LoadFromFile(const std::filesystem::path& path, PixelChannel desiredChannel = PixelChannel::Unknow);
+		// Decodes a file already read, path only names it in errors
+		static Image LoadFromFile(const AssetFile& file, const std::filesystem::path& path, PixelChannel desired_channel = PixelChannel::Unknow);
+		// Decodes into memory owned by the caller, like mapped staging, which holds size bytes as given by ReadInfo
+		static ImageInfo LoadFromFileInto(const std::filesystem::path& path, PixelChannel desired_channel, void* destination, size_t size);
+		static ImageInfo LoadFromFileInto(const AssetFile& file, const std::filesystem::path& path, PixelChannel desired_channel, void* destination, size_t size);
+		static ImageInfo ReadInfo(const std::filesystem::path& path, PixelChannel desired_channel = PixelChannel::Unknow);
+		static ImageInfo ReadInfo(const AssetFile& file, const std::filesystem::path& path, PixelChannel desired_channel = PixelChannel::Unknow);
 
 		Image& operator=(const Image&) = default;
 		Image& operator=(Image&&) = default;
 
 	private:
+		using DecodedPixels = std::unique_ptr<unsigned char, void(*)(void*)>;
+		static DecodedPixels decode(const AssetFile& file, const std::filesystem::path& path, PixelChannel desired_channel, ImageInfo& info);
+		static AssetFile open_image(const std::filesystem::path& path);
+		// stb takes the size as an int
+		static void check_size(const AssetFile& file, const std::filesystem::path& path);
+
 		unsigned int m_width;
 		unsigned int m_height;
 		unsigned int m_channels;
@@ -0,0 +1,47 @@
+#ifndef NTH_UTILS_MAPPEDFILE_HPP
+#define NTH_UTILS_MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+namespace Nth {
+	// Read only view of a whole file, pages are loaded by the OS when first touched
+	class MappedFile {
+	public:
+		// Read-ahead hints, the OS is free to ignore them
+		enum class Access {
+			Normal,
+			Sequential,
+			Random,
+			WillNeed
+		};
+
+		MappedFile();
+		explicit MappedFile(const std::filesystem::path& path);
+		MappedFile(const MappedFile&) = delete;
+		MappedFile(MappedFile&& other);
+		~MappedFile();
+
+		void open(const std::filesystem::path& path);
+		void close();
+		// Range given by offset and size, the rest of the file when size is 0
+		void advise(Access access, size_t offset = 0, size_t size = 0) const;
+
+		bool is_valid() const;
+		const uint8_t* data() const;
+		size_t size() const;
+
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile& operator=(MappedFile&& other);
+	private:
+		const uint8_t* m_data;
+		size_t m_size;
+	#if defined _WIN32
+		void* m_file;
+		void* m_mapping;
+	#endif
+	};
+}
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef NTH_UTILS_READPOOL_HPP
+#define NTH_UTILS_READPOOL_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Nth {
+	class AssetFile;
+
+	// Worker threads shared by the loaders, so reads of a batch overlap with the work done on them without spawning threads per load
+	class ReadPool {
+	public:
+		// 0 for every hardware thread
+		explicit ReadPool(unsigned int thread_count = 0);
+		ReadPool(const ReadPool&) = delete;
+		ReadPool(ReadPool&&) = delete;
+		// Queued jobs are run before the threads are joined
+		~ReadPool();
+
+		// Calls job with every index below count, on the pool and the caller's thread, so it can be called from a job
+		// The first failure in index order is rethrown once the whole batch is done
+		void run_batch(size_t count, const std::function<void(size_t)>& job);
+		// Same as run_batch, each job opens its file and calls callback with its index on the thread that read it
+		void read_batch(const std::vector<std::filesystem::path>& paths, const std::function<void(size_t, const AssetFile&)>& callback);
+
+		template<typename Job>
+		std::future<std::invoke_result_t<Job>> submit(Job&& job);
+
+		size_t thread_count() const;
+
+		ReadPool& operator=(const ReadPool&) = delete;
+		ReadPool& operator=(ReadPool&&) = delete;
+
+	private:
+		void push(std::function<void()>&& job);
+		void work();
+
+		std::vector<std::thread> m_threads;
+		std::deque<std::function<void()>> m_jobs;
+		std::mutex m_mutex;
+		std::condition_variable m_condition;
+		bool m_stopping;
+	};
+}
+
+#include <Utils/ReadPool.inl>
+
+#endif
@@ -0,0 +1,17 @@
+#include <Utils/ReadPool.hpp>
+
+#include <memory>
+#include <utility>
+
+namespace Nth {
+	template<typename Job>
+	inline std::future<std::invoke_result_t<Job>> ReadPool::submit(Job&& job) {
+		// std::function needs a copyable target, the task is shared
+		auto task = std::make_shared<std::packaged_task<std::invoke_result_t<Job>()>>(std::forward<Job>(job));
+		std::future<std::invoke_result_t<Job>> result = task->get_future();
+
+		push([task]() { (*task)(); });
+
+		return result;
+	}
+}
@@ -0,0 +1,92 @@
+#include <Renderer/AssetIOSystem.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <string_view>
+#include <utility>
+
+namespace Nth {
+	AssetIOStream::AssetIOStream(AssetFile&& file) :
+		m_file(std::move(file)),
+		m_position(0) {}
+
+	size_t AssetIOStream::Read(void* buffer, size_t size, size_t count) {
+		if (size == 0) {
+			return 0;
+		}
+
+		// Only whole elements are read, as fread does
+		count = std::min(count, (m_file.size() - m_position) / size);
+		if (count > 0) {
+			std::memcpy(buffer, m_file.data() + m_position, size * count);
+			m_position += size * count;
+		}
+
+		return count;
+	}
+
+	size_t AssetIOStream::Write(const void*, size_t, size_t) {
+		return 0;
+	}
+
+	aiReturn AssetIOStream::Seek(size_t offset, aiOrigin origin) {
+		size_t position = 0;
+		switch (origin) {
+		case aiOrigin_SET:
+			position = offset;
+			break;
+		case aiOrigin_CUR:
+			position = m_position + offset;
+			break;
+		case aiOrigin_END:
+			position = m_file.size() + offset;
+			break;
+		default:
+			return aiReturn_FAILURE;
+		}
+
+		if (position > m_file.size()) {
+			return aiReturn_FAILURE;
+		}
+
+		m_position = position;
+		return aiReturn_SUCCESS;
+	}
+
+	size_t AssetIOStream::Tell() const {
+		return m_position;
+	}
+
+	size_t AssetIOStream::FileSize() const {
+		return m_file.size();
+	}
+
+	void AssetIOStream::Flush() {}
+
+	bool AssetIOSystem::Exists(const char* file) const {
+		return AssetFile::Exists(file);
+	}
+
+	char AssetIOSystem::getOsSeparator() const {
+		return '/';
+	}
+
+	Assimp::IOStream* AssetIOSystem::Open(const char* file, const char* mode) {
+		// Assets are read only
+		if (std::string_view{ mode }.find_first_of("wa+") != std::string_view::npos) {
+			return nullptr;
+		}
+
+		try {
+			return new AssetIOStream{ AssetFile::Open(file) };
+		}
+		catch (const std::exception&) {
+			return nullptr;
+		}
+	}
+
+	void AssetIOSystem::Close(Assimp::IOStream* file) {
+		delete file;
+	}
+}
@@ -0,0 +1,376 @@
+#include <Renderer/BoundingVolumeHierarchy.hpp>
+
+#include <Maths/Frustum.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <utility>
+
+namespace Nth {
+	BoundingVolumeHierarchy::BoundingVolumeHierarchy() :
+		m_nodes(),
+		m_items(),
+		m_item_bounds(),
+		m_item_leaves(),
+		m_built_cost(0.f),
+		m_refitted(false),
+		m_rebuild(false) { }
+
+	void BoundingVolumeHierarchy::build(const std::vector<BoundingBoxf>& bounds) {
+		clear();
+
+		m_item_bounds = bounds;
+		m_item_leaves.assign(bounds.size(), BoundingVolumeHierarchy::no_node);
+
+		std::vector<Vector3f> centroids(bounds.size());
+		for (size_t i = 0; i < bounds.size(); ++i) {
+			if (bounds[i].is_valid()) {
+				m_items.push_back(static_cast<uint32_t>(i));
+				centroids[i] = bounds[i].center();
+			}
+		}
+
+		if (m_items.empty()) {
+			return;
+		}
+
+		auto component = [](const Vector3f& vec, int axis) {
+			return axis == 0 ? vec.x : (axis == 1 ? vec.y : vec.z);
+		};
+
+		auto surface_area = [](const BoundingBoxf& box) {
+			if (!box.is_valid()) {
+				return 0.f;
+			}
+
+			Vector3f size = box.max - box.min;
+			return 2.f * (size.x * size.y + size.y * size.z + size.z * size.x);
+		};
+
+		m_nodes.reserve(2 * m_items.size());
+		m_nodes.push_back(Node{ BoundingBoxf{}, 0, static_cast<uint32_t>(m_items.size()), BoundingVolumeHierarchy::no_node });
+
+		std::vector<uint32_t> pending{ 0 };
+		while (!pending.empty()) {
+			uint32_t node_index = pending.back();
+			pending.pop_back();
+
+			uint32_t first = m_nodes[node_index].first;
+			uint32_t count = m_nodes[node_index].count;
+
+			BoundingBoxf node_bounds;
+			BoundingBoxf centroid_bounds;
+			for (uint32_t i = first; i < first + count; ++i) {
+				node_bounds.extend(m_item_bounds[m_items[i]]);
+				centroid_bounds.extend(centroids[m_items[i]]);
+			}
+			m_nodes[node_index].bounds = node_bounds;
+
+			if (count <= BoundingVolumeHierarchy::max_leaf_size) {
+				for (uint32_t i = first; i < first + count; ++i) {
+					m_item_leaves[m_items[i]] = node_index;
+				}
+
+				continue;
+			}
+
+			Vector3f centroid_size = centroid_bounds.max - centroid_bounds.min;
+			int axis = 0;
+			if (centroid_size.y > centroid_size.x) {
+				axis = 1;
+			}
+			if (centroid_size.z > component(centroid_size, axis)) {
+				axis = 2;
+			}
+
+			float axis_min = component(centroid_bounds.min, axis);
+			float axis_size = component(centroid_size, axis);
+
+			// Every centroid at the same place, items are split in order
+			auto middle = m_items.begin() + first + count / 2;
+			if (axis_size > 0.f) {
+				auto bin_of = [&](uint32_t item) {
+					float position = (component(centroids[item], axis) - axis_min) / axis_size;
+					return std::min(static_cast<uint32_t>(position * BoundingVolumeHierarchy::bin_count), BoundingVolumeHierarchy::bin_count - 1);
+				};
+
+				std::array<BoundingBoxf, BoundingVolumeHierarchy::bin_count> bin_bounds;
+				std::array<uint32_t, BoundingVolumeHierarchy::bin_count> bin_counts{};
+				for (uint32_t i = first; i < first + count; ++i) {
+					uint32_t bin = bin_of(m_items[i]);
+					bin_bounds[bin].extend(m_item_bounds[m_items[i]]);
+					++bin_counts[bin];
+				}
+
+				// Cost of the right side when splitting before each bin
+				std::array<float, BoundingVolumeHierarchy::bin_count> right_costs{};
+				BoundingBoxf right_bounds;
+				uint32_t right_count = 0;
+				for (uint32_t bin = BoundingVolumeHierarchy::bin_count - 1; bin > 0; --bin) {
+					right_bounds.extend(bin_bounds[bin]);
+					right_count += bin_counts[bin];
+					right_costs[bin] = surface_area(right_bounds) * right_count;
+				}
+
+				// The first and last bins are never empty, so every split keeps items on both sides
+				uint32_t best_split = 1;
+				float best_cost = std::numeric_limits<float>::max();
+				BoundingBoxf left_bounds;
+				uint32_t left_count = 0;
+				for (uint32_t bin = 1; bin < BoundingVolumeHierarchy::bin_count; ++bin) {
+					left_bounds.extend(bin_bounds[bin - 1]);
+					left_count += bin_counts[bin - 1];
+
+					float cost = surface_area(left_bounds) * left_count + right_costs[bin];
+					if (cost < best_cost) {
+						best_cost = cost;
+						best_split = bin;
+					}
+				}
+
+				middle = std::partition(m_items.begin() + first, m_items.begin() + first + count, [&](uint32_t item) {
+					return bin_of(item) < best_split;
+				});
+			}
+
+			uint32_t middle_index = static_cast<uint32_t>(middle - m_items.begin());
+
+			uint32_t left = static_cast<uint32_t>(m_nodes.size());
+			m_nodes[node_index].first = left;
+			m_nodes[node_index].count = 0;
+
+			m_nodes.push_back(Node{ BoundingBoxf{}, first, middle_index - first, node_index });
+			m_nodes.push_back(Node{ BoundingBoxf{}, middle_index, first + count - middle_index, node_index });
+
+			pending.push_back(left);
+			pending.push_back(left + 1);
+		}
+
+		m_built_cost = cost();
+	}
+
+	void BoundingVolumeHierarchy::set(uint32_t item, const BoundingBoxf& bounds) {
+		if (item >= m_item_bounds.size()) {
+			m_item_bounds.resize(item + 1);
+			m_item_leaves.resize(item + 1, BoundingVolumeHierarchy::no_node);
+		}
+
+		m_item_bounds[item] = bounds;
+
+		// Removed items stay in their leaf with an empty box until the next rebuild
+		if (m_item_leaves[item] == BoundingVolumeHierarchy::no_node) {
+			m_rebuild = m_rebuild || bounds.is_valid();
+			return;
+		}
+
+		refit(m_item_leaves[item]);
+		m_refitted = true;
+	}
+
+	void BoundingVolumeHierarchy::refresh() {
+		if (m_rebuild || (m_refitted && cost() > m_built_cost * BoundingVolumeHierarchy::rebuild_cost_ratio)) {
+			std::vector<BoundingBoxf> bounds = std::move(m_item_bounds);
+			build(bounds);
+		}
+
+		m_refitted = false;
+	}
+
+	void BoundingVolumeHierarchy::clear() {
+		m_nodes.clear();
+		m_items.clear();
+		m_item_bounds.clear();
+		m_item_leaves.clear();
+
+		m_built_cost = 0.f;
+		m_refitted = false;
+		m_rebuild = false;
+	}
+
+	void BoundingVolumeHierarchy::query(const BoundingBoxf& bounds, std::vector<uint32_t>& items) const {
+		if (m_nodes.empty()) {
+			return;
+		}
+
+		std::vector<uint32_t> stack{ 0 };
+		while (!stack.empty()) {
+			const Node& node = m_nodes[stack.back()];
+			stack.pop_back();
+
+			if (!node.bounds.intersect(bounds)) {
+				continue;
+			}
+
+			if (node.count == 0) {
+				stack.push_back(node.first);
+				stack.push_back(node.first + 1);
+				continue;
+			}
+
+			for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+				if (m_item_bounds[m_items[i]].intersect(bounds)) {
+					items.push_back(m_items[i]);
+				}
+			}
+		}
+	}
+
+	void BoundingVolumeHierarchy::query(const Vector3f& origin, const Vector3f& direction, float max_distance, std::vector<BoundingVolumeHit>& hits) const {
+		if (m_nodes.empty()) {
+			return;
+		}
+
+		size_t first_hit = hits.size();
+
+		std::vector<uint32_t> stack{ 0 };
+		while (!stack.empty()) {
+			const Node& node = m_nodes[stack.back()];
+			stack.pop_back();
+
+			float distance;
+			if (!node.bounds.intersect_ray(origin, direction, max_distance, distance)) {
+				continue;
+			}
+
+			if (node.count == 0) {
+				stack.push_back(node.first);
+				stack.push_back(node.first + 1);
+				continue;
+			}
+
+			for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+				if (m_item_bounds[m_items[i]].intersect_ray(origin, direction, max_distance, distance)) {
+					hits.push_back(BoundingVolumeHit{ m_items[i], distance });
+				}
+			}
+		}
+
+		std::sort(hits.begin() + first_hit, hits.end(), [](const BoundingVolumeHit& a, const BoundingVolumeHit& b) {
+			return a.distance < b.distance;
+		});
+	}
+
+	void BoundingVolumeHierarchy::cull(const Matrix4f& view_projection, std::vector<uint32_t>& items, const std::function<bool(const BoundingBoxf&)>& visible) const {
+		if (m_nodes.empty()) {
+			return;
+		}
+
+		Frustumf frustum{ view_projection };
+
+		// A node inside the frustum skips the plane tests of its whole subtree
+		std::vector<std::pair<uint32_t, bool>> stack{ { 0, false } };
+		while (!stack.empty()) {
+			auto [node_index, inside] = stack.back();
+			stack.pop_back();
+
+			const Node& node = m_nodes[node_index];
+			if (!node.bounds.is_valid()) {
+				continue;
+			}
+
+			if (!inside) {
+				FrustumContainment containment = frustum.classify(node.bounds);
+				if (containment == FrustumContainment::Outside) {
+					continue;
+				}
+
+				inside = containment == FrustumContainment::Inside;
+			}
+
+			if (visible && !visible(node.bounds)) {
+				continue;
+			}
+
+			if (node.count == 0) {
+				stack.emplace_back(node.first, inside);
+				stack.emplace_back(node.first + 1, inside);
+				continue;
+			}
+
+			for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+				const BoundingBoxf& box = m_item_bounds[m_items[i]];
+				if (!box.is_valid() || (!inside && frustum.classify(box) == FrustumContainment::Outside)) {
+					continue;
+				}
+
+				if (!visible || visible(box)) {
+					items.push_back(m_items[i]);
+				}
+			}
+		}
+	}
+
+	const BoundingBoxf& BoundingVolumeHierarchy::bounds() const {
+		assert(!m_nodes.empty());
+
+		return m_nodes[0].bounds;
+	}
+
+	const BoundingBoxf& BoundingVolumeHierarchy::bounds(uint32_t item) const {
+		assert(item < m_item_bounds.size());
+
+		return m_item_bounds[item];
+	}
+
+	size_t BoundingVolumeHierarchy::node_count() const {
+		return m_nodes.size();
+	}
+
+	size_t BoundingVolumeHierarchy::size() const {
+		return m_items.size();
+	}
+
+	float BoundingVolumeHierarchy::cost() const {
+		if (m_nodes.empty()) {
+			return 0.f;
+		}
+
+		auto surface_area = [](const BoundingBoxf& box) {
+			if (!box.is_valid()) {
+				return 0.f;
+			}
+
+			Vector3f size = box.max - box.min;
+			return 2.f * (size.x * size.y + size.y * size.z + size.z * size.x);
+		};
+
+		float root_area = surface_area(m_nodes[0].bounds);
+		if (root_area <= 0.f) {
+			return static_cast<float>(m_nodes.size());
+		}
+
+		// A node is entered as often as its area, leaves then test each of their items
+		float total = 0.f;
+		for (const Node& node : m_nodes) {
+			total += surface_area(node.bounds) * (node.count == 0 ? 1.f : static_cast<float>(node.count));
+		}
+
+		return total / root_area;
+	}
+
+	void BoundingVolumeHierarchy::refit(uint32_t node_index) {
+		while (node_index != BoundingVolumeHierarchy::no_node) {
+			Node& node = m_nodes[node_index];
+
+			BoundingBoxf bounds;
+			if (node.count == 0) {
+				bounds.extend(m_nodes[node.first].bounds);
+				bounds.extend(m_nodes[node.first + 1].bounds);
+			}
+			else {
+				for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+					bounds.extend(m_item_bounds[m_items[i]]);
+				}
+			}
+
+			// Ancestors can't change either
+			if (bounds == node.bounds) {
+				return;
+			}
+
+			node.bounds = bounds;
+			node_index = node.parent;
+		}
+	}
+}
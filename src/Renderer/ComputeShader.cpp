@@ -0,0 +1,76 @@
+#include <Renderer/ComputeShader.hpp>
+
+#include <Renderer/Vulkan/Device.hpp>
+
+#include <Utils/AssetFile.hpp>
+
+#include <stdexcept>
+
+namespace Nth {
+	void ComputeShader::create(const Vk::Device& device, const std::filesystem::path& shader_name, const std::vector<VkDescriptorSetLayout>& descriptor_set_layouts, uint32_t push_constant_size, const std::vector<uint32_t>& specialization_constants) {
+		Vk::ShaderModule shader_module = create_shader_module(device, shader_name);
+
+		if (!shader_module.is_valid()) {
+			throw std::runtime_error("Can't create compute shader module");
+		}
+
+		VkPushConstantRange push_constant_range = {
+			VK_SHADER_STAGE_COMPUTE_BIT,                                // VkShaderStageFlags                             stageFlags
+			0,                                                          // uint32_t                                       offset
+			push_constant_size                                          // uint32_t                                       size
+		};
+
+		pipeline_layout.create(
+			device,
+			0,
+			static_cast<uint32_t>(descriptor_set_layouts.size()),
+			descriptor_set_layouts.data(),
+			push_constant_size > 0 ? 1 : 0,
+			push_constant_size > 0 ? &push_constant_range : nullptr
+		);
+
+		// Constant i is the ith value
+		std::vector<VkSpecializationMapEntry> specialization_entries;
+		for (uint32_t i = 0; i < specialization_constants.size(); ++i) {
+			specialization_entries.push_back(VkSpecializationMapEntry{ i, static_cast<uint32_t>(i * sizeof(uint32_t)), sizeof(uint32_t) });
+		}
+
+		VkSpecializationInfo specialization_info = {
+			static_cast<uint32_t>(specialization_entries.size()),       // uint32_t                                       mapEntryCount
+			specialization_entries.data(),                              // const VkSpecializationMapEntry                *pMapEntries
+			specialization_constants.size() * sizeof(uint32_t),         // size_t                                         dataSize
+			specialization_constants.data()                             // const void                                    *pData
+		};
+
+		VkComputePipelineCreateInfo pipeline_create_info = {
+			VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,             // VkStructureType                                sType
+			nullptr,                                                    // const void                                    *pNext
+			0,                                                          // VkPipelineCreateFlags                          flags
+			{                                                           // VkPipelineShaderStageCreateInfo                stage
+				VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,        // VkStructureType                                sType
+				nullptr,                                                    // const void                                    *pNext
+				0,                                                          // VkPipelineShaderStageCreateFlags               flags
+				VK_SHADER_STAGE_COMPUTE_BIT,                                // VkShaderStageFlagBits                          stage
+				shader_module(),                                            // VkShaderModule                                 module
+				"main",                                                     // const char                                    *pName
+				specialization_constants.empty() ? nullptr : &specialization_info // const VkSpecializationInfo              *pSpecializationInfo
+			},
+			pipeline_layout(),                                          // VkPipelineLayout                               layout
+			VK_NULL_HANDLE,                                             // VkPipeline                                     basePipelineHandle
+			-1                                                          // int32_t                                        basePipelineIndex
+		};
+
+		pipeline.create_compute(device, VK_NULL_HANDLE, pipeline_create_info);
+	}
+
+	Vk::ShaderModule ComputeShader::create_shader_module(const Vk::Device& device, const std::filesystem::path& path) const {
+		// SPIR-V is read in place, mappings and decompressed content are aligned for its words
+		AssetFile code = AssetFile::Open(path);
+		code.advise(MappedFile::Access::Sequential);
+
+		Vk::ShaderModule shader;
+		shader.create(device, code.size(), reinterpret_cast<const uint32_t*>(code.data()));
+
+		return shader;
+	}
+}
@@ -0,0 +1,328 @@
+#include <Renderer/CookedModel.hpp>
+
+#include <Renderer/Mesh.hpp>
+#include <Renderer/Model.hpp>
+#include <Renderer/QuantizedVertex.hpp>
+
+#include <Utils/ReadPool.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+namespace Nth {
+	template<typename T>
+	std::vector<T> CookedModel::read_table(uint64_t offset, size_t count) const {
+		// Copied out since the mapping gives no alignment guarantee for T
+		std::vector<T> table(count);
+		if (count > 0) {
+			std::memcpy(table.data(), m_file.data() + offset, count * sizeof(T));
+		}
+
+		return table;
+	}
+
+	const std::vector<CookedMesh>& CookedModel::meshes() const {
+		return m_meshes;
+	}
+
+	const uint8_t* CookedModel::vertices(const CookedMesh& mesh) const {
+		return m_file.data() + mesh.vertices;
+	}
+
+	const uint8_t* CookedModel::indices(const CookedMesh& mesh) const {
+		return m_file.data() + mesh.indices;
+	}
+
+	std::vector<CookedLod> CookedModel::lods(const CookedMesh& mesh) const {
+		return read_table<CookedLod>(mesh.lods, mesh.lod_count);
+	}
+
+	std::vector<Meshlet> CookedModel::meshlets(const CookedMesh& mesh) const {
+		return read_table<Meshlet>(mesh.meshlets, mesh.meshlet_count);
+	}
+
+	std::vector<uint32_t> CookedModel::texture_indices(const CookedMesh& mesh) const {
+		return read_table<uint32_t>(mesh.textures, mesh.texture_count);
+	}
+
+	std::vector<uint32_t> CookedModel::unpack_indices(const CookedMesh& mesh) const {
+		// The full detail level starts the index blob
+		uint32_t index_count = lods(mesh)[0].index_count;
+		if (mesh.index_format == IndexFormat::UInt32) {
+			return read_table<uint32_t>(mesh.indices, index_count);
+		}
+
+		std::vector<uint16_t> packed = read_table<uint16_t>(mesh.indices, index_count);
+		return std::vector<uint32_t>(packed.begin(), packed.end());
+	}
+
+	std::vector<Vector3f> CookedModel::unpack_positions(const CookedMesh& mesh) const {
+		std::vector<Vector3f> positions;
+		positions.reserve(mesh.vertex_count);
+
+		if (mesh.vertex_format == VertexFormat::Quantized) {
+			for (const QuantizedVertex& vertex : read_table<QuantizedVertex>(mesh.vertices, mesh.vertex_count)) {
+				positions.push_back(dequantize_vertex(vertex, mesh.bounds).pos);
+			}
+		}
+		else {
+			for (const Vertex& vertex : read_table<Vertex>(mesh.vertices, mesh.vertex_count)) {
+				positions.push_back(vertex.pos);
+			}
+		}
+
+		return positions;
+	}
+
+	size_t CookedModel::texture_count() const {
+		return m_textures.size();
+	}
+
+	std::string_view CookedModel::texture_path(size_t index) const {
+		const CookedTexture& texture = m_textures[index];
+
+		return std::string_view{ reinterpret_cast<const char*>(m_file.data() + texture.path), texture.path_size };
+	}
+
+	std::string_view CookedModel::texture_type(size_t index) const {
+		return CookedModel::texture_types[m_textures[index].type];
+	}
+
+	std::filesystem::path CookedModel::texture_file(size_t index) const {
+		return m_directory / texture_path(index);
+	}
+
+	std::vector<Texture> CookedModel::load_textures(ReadPool& pool) const {
+		std::vector<std::filesystem::path> files;
+		for (size_t i = 0; i < m_textures.size(); ++i) {
+			files.push_back(texture_file(i));
+		}
+
+		// Every image is decoded in its own slot by the thread that read it
+		std::vector<Texture> textures(m_textures.size());
+		pool.read_batch(files, [&](size_t i, const AssetFile& file) {
+			textures[i] = texture_from_file(file, files[i]);
+			textures[i].type = texture_type(i);
+			textures[i].path = texture_path(i);
+		});
+
+		return textures;
+	}
+
+	void CookedModel::prefetch() const {
+		m_file.advise(MappedFile::Access::WillNeed);
+	}
+
+	std::vector<ModelInstance> CookedModel::instances() const {
+		std::vector<ModelInstance> instances;
+		instances.reserve(m_header.instance_count);
+
+		for (const CookedInstance& instance : read_table<CookedInstance>(m_header.instance_table, m_header.instance_count)) {
+			instances.push_back(ModelInstance{ instance.mesh_index, instance.transform });
+		}
+
+		return instances;
+	}
+
+	CookedModel CookedModel::LoadFromFile(const std::filesystem::path& path) {
+		return CookedModel{ path };
+	}
+
+	CookedModel::CookedModel(const std::filesystem::path& path) :
+		m_directory(path.parent_path()),
+		m_file(AssetFile::Open(path)),
+		m_header(),
+		m_meshes(),
+		m_textures() {
+		auto invalid = [&](const std::string& reason) {
+			return std::runtime_error("Cooked model " + path.string() + " " + reason);
+		};
+
+		if (m_file.size() < sizeof(CookedHeader)) {
+			throw invalid("is too small");
+		}
+
+		std::memcpy(&m_header, m_file.data(), sizeof(CookedHeader));
+
+		if (m_header.magic != CookedModel::magic) {
+			throw invalid("has no cooked header");
+		}
+		if (m_header.version != CookedModel::version) {
+			throw invalid("has version " + std::to_string(m_header.version) + ", expected " + std::to_string(CookedModel::version));
+		}
+		if (m_header.file_size != m_file.size()) {
+			throw invalid("is truncated");
+		}
+
+		// Only the tables are checked, blobs are trusted once they lie inside the file except for occluder indices, which the CPU rasterizer reads
+		auto in_file = [&](uint64_t offset, uint64_t size) {
+			return offset <= m_file.size() && size <= m_file.size() - offset;
+		};
+
+		if (!in_file(m_header.mesh_table, m_header.mesh_count * sizeof(CookedMesh)) ||
+			!in_file(m_header.texture_table, m_header.texture_count * sizeof(CookedTexture)) ||
+			!in_file(m_header.instance_table, m_header.instance_count * sizeof(CookedInstance))) {
+			throw invalid("has a table outside of the file");
+		}
+
+		m_meshes = read_table<CookedMesh>(m_header.mesh_table, m_header.mesh_count);
+		m_textures = read_table<CookedTexture>(m_header.texture_table, m_header.texture_count);
+
+		for (const CookedMesh& mesh : m_meshes) {
+			uint64_t vertex_size = mesh.vertex_format == VertexFormat::Quantized ? sizeof(QuantizedVertex) : sizeof(Vertex);
+			if (mesh.vertices_size != mesh.vertex_count * vertex_size || mesh.lod_count == 0 ||
+				!in_file(mesh.vertices, mesh.vertices_size) ||
+				!in_file(mesh.indices, mesh.indices_size) ||
+				!in_file(mesh.lods, mesh.lod_count * sizeof(CookedLod)) ||
+				!in_file(mesh.meshlets, mesh.meshlet_count * sizeof(Meshlet)) ||
+				!in_file(mesh.textures, mesh.texture_count * sizeof(uint32_t))) {
+				throw invalid("has a mesh outside of the file");
+			}
+
+			uint64_t index_count = mesh.indices_size / (mesh.index_format == IndexFormat::UInt16 ? sizeof(uint16_t) : sizeof(uint32_t));
+			for (const CookedLod& lod : lods(mesh)) {
+				if (static_cast<uint64_t>(lod.first_index) + lod.index_count > index_count) {
+					throw invalid("has a level of detail outside of its indices");
+				}
+			}
+
+			for (uint32_t texture_index : texture_indices(mesh)) {
+				if (texture_index >= m_header.texture_count) {
+					throw invalid("has a mesh using a missing texture");
+				}
+			}
+
+			if (mesh.occluder) {
+				std::vector<uint32_t> occluder_indices = unpack_indices(mesh);
+				if (occluder_indices.size() % 3 != 0) {
+					throw invalid("has an occluder with a partial triangle");
+				}
+
+				for (uint32_t index : occluder_indices) {
+					if (index >= mesh.vertex_count) {
+						throw invalid("has an occluder index outside of its vertices");
+					}
+				}
+			}
+		}
+
+		for (const CookedInstance& instance : read_table<CookedInstance>(m_header.instance_table, m_header.instance_count)) {
+			if (instance.mesh_index >= m_header.mesh_count) {
+				throw invalid("has an instance of a missing mesh");
+			}
+		}
+
+		for (const CookedTexture& texture : m_textures) {
+			if (!in_file(texture.path, texture.path_size) || texture.type >= CookedModel::texture_types.size()) {
+				throw invalid("has an invalid texture");
+			}
+		}
+	}
+
+	void save_cooked_model(const Model& model, const std::filesystem::path& path) {
+		save_cooked_model(model.meshes, model.textures(), model.instances, path);
+	}
+
+	void save_cooked_model(const std::vector<Mesh>& meshes, const std::vector<Texture>& textures, const std::vector<ModelInstance>& instances, const std::filesystem::path& path) {
+		std::vector<uint8_t> file(sizeof(CookedHeader), 0);
+
+		auto append = [&](const void* data, size_t size, uint64_t alignment) {
+			file.resize((file.size() + alignment - 1) / alignment * alignment, 0);
+
+			uint64_t offset = file.size();
+			const uint8_t* bytes = static_cast<const uint8_t*>(data);
+			file.insert(file.end(), bytes, bytes + size);
+
+			return offset;
+		};
+
+		std::vector<CookedMesh> mesh_table;
+		for (const Mesh& mesh : meshes) {
+			CookedMesh cooked{};
+			cooked.bounds = mesh.bounds;
+			cooked.occluder = mesh.occluder ? 1 : 0;
+
+			if (!mesh.quantized_vertices.empty()) {
+				cooked.vertex_format = VertexFormat::Quantized;
+				cooked.vertex_count = static_cast<uint32_t>(mesh.quantized_vertices.size());
+				cooked.vertices_size = mesh.quantized_vertices.size() * sizeof(QuantizedVertex);
+				cooked.vertices = append(mesh.quantized_vertices.data(), cooked.vertices_size, CookedModel::blob_alignment);
+			}
+			else {
+				cooked.vertex_format = VertexFormat::Full;
+				cooked.vertex_count = static_cast<uint32_t>(mesh.vertices.size());
+				cooked.vertices_size = mesh.vertices.size() * sizeof(Vertex);
+				cooked.vertices = append(mesh.vertices.data(), cooked.vertices_size, CookedModel::blob_alignment);
+			}
+
+			// Same layout as Renderer::register_mesh uploads
+			std::vector<uint32_t> indices = mesh.indices;
+			std::vector<CookedLod> lods{ CookedLod{ 0, static_cast<uint32_t>(mesh.indices.size()), 0.f } };
+			for (const MeshLod& lod : mesh.lods) {
+				lods.push_back(CookedLod{ static_cast<uint32_t>(indices.size()), static_cast<uint32_t>(lod.indices.size()), lod.error });
+				indices.insert(indices.end(), lod.indices.begin(), lod.indices.end());
+			}
+
+			cooked.index_format = mesh.index_format();
+			std::vector<uint8_t> packed_indices = Mesh::pack_indices(indices, cooked.index_format);
+			cooked.indices_size = packed_indices.size();
+			cooked.indices = append(packed_indices.data(), packed_indices.size(), CookedModel::blob_alignment);
+
+			cooked.lod_count = static_cast<uint32_t>(lods.size());
+			cooked.lods = append(lods.data(), lods.size() * sizeof(CookedLod), alignof(CookedLod));
+
+			cooked.meshlet_count = static_cast<uint32_t>(mesh.meshlets.size());
+			cooked.meshlets = append(mesh.meshlets.data(), mesh.meshlets.size() * sizeof(Meshlet), alignof(Meshlet));
+
+			std::vector<uint32_t> texture_indices(mesh.textures_index.begin(), mesh.textures_index.end());
+			cooked.texture_count = static_cast<uint32_t>(texture_indices.size());
+			cooked.textures = append(texture_indices.data(), texture_indices.size() * sizeof(uint32_t), alignof(uint32_t));
+
+			mesh_table.push_back(cooked);
+		}
+
+		std::vector<CookedTexture> texture_table;
+		for (const Texture& texture : textures) {
+			auto type = std::find(CookedModel::texture_types.begin(), CookedModel::texture_types.end(), texture.type);
+			if (type == CookedModel::texture_types.end()) {
+				throw std::runtime_error("Texture type " + std::string{ texture.type } + " can't be cooked");
+			}
+
+			std::string texture_path = texture.path.generic_string();
+
+			CookedTexture cooked{};
+			cooked.path_size = static_cast<uint32_t>(texture_path.size());
+			cooked.path = append(texture_path.data(), texture_path.size(), 1);
+			cooked.type = static_cast<uint32_t>(type - CookedModel::texture_types.begin());
+			texture_table.push_back(cooked);
+		}
+
+		std::vector<CookedInstance> instance_table;
+		for (const ModelInstance& instance : instances) {
+			instance_table.push_back(CookedInstance{ static_cast<uint32_t>(instance.mesh_index), { 0, 0, 0 }, instance.transform });
+		}
+
+		CookedHeader header{};
+		header.magic = CookedModel::magic;
+		header.version = CookedModel::version;
+		header.mesh_count = static_cast<uint32_t>(mesh_table.size());
+		header.texture_count = static_cast<uint32_t>(texture_table.size());
+		header.instance_count = static_cast<uint32_t>(instance_table.size());
+		header.mesh_table = append(mesh_table.data(), mesh_table.size() * sizeof(CookedMesh), alignof(CookedMesh));
+		header.texture_table = append(texture_table.data(), texture_table.size() * sizeof(CookedTexture), alignof(CookedTexture));
+		header.instance_table = append(instance_table.data(), instance_table.size() * sizeof(CookedInstance), alignof(CookedInstance));
+		header.file_size = file.size();
+
+		std::memcpy(file.data(), &header, sizeof(CookedHeader));
+
+		std::ofstream output(path, std::ios::binary);
+		output.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+
+		if (!output) {
+			throw std::runtime_error("Can't write file " + path.string());
+		}
+	}
+}
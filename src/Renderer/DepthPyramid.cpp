@@ -0,0 +1,258 @@
+#include <Renderer/DepthPyramid.hpp>
+
+#include <Renderer/RenderDevice.hpp>
+#include <Renderer/DescriptorAllocator.hpp>
+#include <Renderer/DepthImage.hpp>
+#include <Renderer/Vulkan/Device.hpp>
+#include <Renderer/Vulkan/CommandBuffer.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+namespace Nth {
+	DepthPyramid::DepthPyramid() :
+		m_device(nullptr),
+		m_allocator(nullptr),
+		m_size(0, 0),
+		m_depth_size(0, 0) { }
+
+	void DepthPyramid::init(const RenderDevice& device, DescriptorAllocator& allocator, const std::filesystem::path& reduce_shader_name) {
+		m_device = &device;
+		m_allocator = &allocator;
+
+		m_descriptor_set_layout = create_descriptor_set_layout(device.get_handle(), {
+			BindingInfo{ ShaderType::Compute, BindingType::Texture, 0, 0 },
+			BindingInfo{ ShaderType::Compute, BindingType::StorageImage, 0, 1 }
+		});
+
+		m_reduce.create(device.get_handle(), reduce_shader_name, { m_descriptor_set_layout() }, 4 * sizeof(uint32_t));
+
+		create_sampler();
+	}
+
+	void DepthPyramid::create(const DepthImage& depth, const Vector2ui& depth_size) {
+		assert(m_device != nullptr);
+
+		// Power of two below the depth size, so each level is exactly half of the previous one
+		auto previous_power_of_two = [](unsigned int value) {
+			unsigned int result = 1;
+			while (result * 2 <= value) {
+				result *= 2;
+			}
+			return result;
+		};
+
+		m_depth_size = depth_size;
+		m_size = Vector2ui{ previous_power_of_two(depth_size.x), previous_power_of_two(depth_size.y) };
+
+		uint32_t mip_levels = 1;
+		while ((std::max(m_size.x, m_size.y) >> mip_levels) > 0) {
+			++mip_levels;
+		}
+
+		m_mip_views.clear();
+
+		RenderImage image;
+		image.create(
+			*m_device,
+			m_size.x,
+			m_size.y,
+			mip_levels,
+			0,
+			VK_FORMAT_R32_SFLOAT,
+			VK_IMAGE_TILING_OPTIMAL,
+			VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+		);
+		m_image = std::move(image);
+
+		m_image.create_view(VK_FORMAT_R32_SFLOAT, VK_IMAGE_ASPECT_COLOR_BIT);
+
+		for (uint32_t level = 0; level < mip_levels; ++level) {
+			m_mip_views.push_back(m_image.create_mip_view(VK_FORMAT_R32_SFLOAT, VK_IMAGE_ASPECT_COLOR_BIT, level, 1));
+		}
+
+		// Descriptor sets can't be given back to the allocator, keep the ones already allocated
+		while (m_bindings.size() < mip_levels) {
+			m_bindings.emplace_back(m_allocator->allocate(m_descriptor_set_layout));
+		}
+
+		for (uint32_t level = 0; level < mip_levels; ++level) {
+			ImageBinding source = (level == 0) ?
+				ImageBinding{ depth.view(), m_sampler, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL } :
+				ImageBinding{ m_mip_views[level - 1], m_sampler, VK_IMAGE_LAYOUT_GENERAL };
+			StorageImageBinding destination{ m_mip_views[level], VK_IMAGE_LAYOUT_GENERAL };
+
+			m_bindings[level].update({ Binding{ source, 0 }, Binding{ destination, 1 } });
+		}
+
+		clear();
+	}
+
+	void DepthPyramid::build(const Vk::CommandBuffer& command_buffer) const {
+		struct ReduceConstants {
+			uint32_t source_width;
+			uint32_t source_height;
+			uint32_t destination_width;
+			uint32_t destination_height;
+		};
+
+		// Previous readers of the pyramid must be done before it is overwritten
+		VkMemoryBarrier memory_barrier = {
+			VK_STRUCTURE_TYPE_MEMORY_BARRIER,       // VkStructureType           sType
+			nullptr,                                // const void               *pNext
+			VK_ACCESS_SHADER_READ_BIT,              // VkAccessFlags             srcAccessMask
+			VK_ACCESS_SHADER_WRITE_BIT              // VkAccessFlags             dstAccessMask
+		};
+		command_buffer.pipeline_barrier(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memory_barrier, 0, nullptr, 0, nullptr);
+
+		command_buffer.bind_pipeline(VK_PIPELINE_BIND_POINT_COMPUTE, m_reduce.pipeline());
+
+		Vector2ui source_size = m_depth_size;
+		for (uint32_t level = 0; level < m_mip_views.size(); ++level) {
+			Vector2ui destination_size{ std::max(m_size.x >> level, 1u), std::max(m_size.y >> level, 1u) };
+
+			VkDescriptorSet vk_descriptor_set = m_bindings[level].descriptor_set()();
+			command_buffer.bind_descriptor_sets(VK_PIPELINE_BIND_POINT_COMPUTE, m_reduce.pipeline_layout(), 0, 1, &vk_descriptor_set, 0, nullptr);
+
+			ReduceConstants constants{ source_size.x, source_size.y, destination_size.x, destination_size.y };
+			command_buffer.push_constants(m_reduce.pipeline_layout(), VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(ReduceConstants), &constants);
+
+			command_buffer.dispatch((destination_size.x + 7) / 8, (destination_size.y + 7) / 8, 1);
+
+			VkImageMemoryBarrier image_memory_barrier = {
+				VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER, // VkStructureType           sType
+				nullptr,                                // const void               *pNext
+				VK_ACCESS_SHADER_WRITE_BIT,             // VkAccessFlags             srcAccessMask
+				VK_ACCESS_SHADER_READ_BIT,              // VkAccessFlags             dstAccessMask
+				VK_IMAGE_LAYOUT_GENERAL,                // VkImageLayout             oldLayout
+				VK_IMAGE_LAYOUT_GENERAL,                // VkImageLayout             newLayout
+				VK_QUEUE_FAMILY_IGNORED,                // uint32_t                  srcQueueFamilyIndex
+				VK_QUEUE_FAMILY_IGNORED,                // uint32_t                  dstQueueFamilyIndex
+				m_image.handle(),                       // VkImage                   image
+				{                                       // VkImageSubresourceRange   subresourceRange
+					VK_IMAGE_ASPECT_COLOR_BIT,              // VkImageAspectFlags        aspectMask
+					level,                                  // uint32_t                  baseMipLevel
+					1,                                      // uint32_t                  levelCount
+					0,                                      // uint32_t                  baseArrayLayer
+					1                                       // uint32_t                  layerCount
+				}
+			};
+			command_buffer.pipeline_barrier(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &image_memory_barrier);
+
+			source_size = destination_size;
+		}
+	}
+
+	const Vk::ImageView& DepthPyramid::view() const {
+		return m_image.view;
+	}
+
+	const Vk::Sampler& DepthPyramid::sampler() const {
+		return m_sampler;
+	}
+
+	const Vector2ui& DepthPyramid::size() const {
+		return m_size;
+	}
+
+	const Vector2ui& DepthPyramid::depth_size() const {
+		return m_depth_size;
+	}
+
+	void DepthPyramid::create_sampler() {
+		VkSamplerCreateInfo sampler_create_info = {
+			VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,         // VkStructureType        sType
+			nullptr,                                       // const void*            pNext
+			0,                                             // VkSamplerCreateFlags   flags
+			VK_FILTER_NEAREST,                             // VkFilter               magFilter
+			VK_FILTER_NEAREST,                             // VkFilter               minFilter
+			VK_SAMPLER_MIPMAP_MODE_NEAREST,                // VkSamplerMipmapMode    mipmapMode
+			VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,         // VkSamplerAddressMode   addressModeU
+			VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,         // VkSamplerAddressMode   addressModeV
+			VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,         // VkSamplerAddressMode   addressModeW
+			0.0f,                                          // float                  mipLodBias
+			VK_FALSE,                                      // VkBool32               anisotropyEnable
+			1.0f,                                          // float                  maxAnisotropy
+			VK_FALSE,                                      // VkBool32               compareEnable
+			VK_COMPARE_OP_ALWAYS,                          // VkCompareOp            compareOp
+			0.0f,                                          // float                  minLod
+			VK_LOD_CLAMP_NONE,                             // float                  maxLod
+			VK_BORDER_COLOR_FLOAT_TRANSPARENT_BLACK,       // VkBorderColor          borderColor
+			VK_FALSE                                       // VkBool32               unnormalizedCoordinates
+		};
+
+		m_sampler.create(m_device->get_handle(), sampler_create_info);
+	}
+
+	void DepthPyramid::clear() {
+		// Until a first frame is reduced, the pyramid is at the far plane so nothing is occluded
+		VkCommandBufferBeginInfo command_buffer_begin_info = {
+			VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,  // VkStructureType                        sType
+			nullptr,                                      // const void                            *pNext
+			VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,  // VkCommandBufferUsageFlags              flags
+			nullptr                                       // const VkCommandBufferInheritanceInfo  *pInheritanceInfo
+		};
+
+		Vk::CommandBuffer command_buffer{ m_device->allocate_command_buffer() };
+		command_buffer.begin(command_buffer_begin_info);
+
+		VkImageSubresourceRange image_subresource_range = {
+			VK_IMAGE_ASPECT_COLOR_BIT,              // VkImageAspectFlags        aspectMask
+			0,                                      // uint32_t                  baseMipLevel
+			m_image.mip_levels(),                   // uint32_t                  levelCount
+			0,                                      // uint32_t                  baseArrayLayer
+			1                                       // uint32_t                  layerCount
+		};
+
+		VkImageMemoryBarrier image_memory_barrier_from_undefined_to_general = {
+			VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER, // VkStructureType           sType
+			nullptr,                                // const void               *pNext
+			0,                                      // VkAccessFlags             srcAccessMask
+			VK_ACCESS_TRANSFER_WRITE_BIT,           // VkAccessFlags             dstAccessMask
+			VK_IMAGE_LAYOUT_UNDEFINED,              // VkImageLayout             oldLayout
+			VK_IMAGE_LAYOUT_GENERAL,                // VkImageLayout             newLayout
+			VK_QUEUE_FAMILY_IGNORED,                // uint32_t                  srcQueueFamilyIndex
+			VK_QUEUE_FAMILY_IGNORED,                // uint32_t                  dstQueueFamilyIndex
+			m_image.handle(),                       // VkImage                   image
+			image_subresource_range                 // VkImageSubresourceRange   subresourceRange
+		};
+		command_buffer.pipeline_barrier(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &image_memory_barrier_from_undefined_to_general);
+
+		VkClearColorValue far_depth = { { 1.0f, 1.0f, 1.0f, 1.0f } };
+		command_buffer.clear_color_image(m_image.handle(), VK_IMAGE_LAYOUT_GENERAL, far_depth, 1, &image_subresource_range);
+
+		VkImageMemoryBarrier image_memory_barrier_from_transfer_to_compute = {
+			VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,                  // VkStructureType           sType
+			nullptr,                                                 // const void               *pNext
+			VK_ACCESS_TRANSFER_WRITE_BIT,                            // VkAccessFlags             srcAccessMask
+			VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,  // VkAccessFlags             dstAccessMask
+			VK_IMAGE_LAYOUT_GENERAL,                                 // VkImageLayout             oldLayout
+			VK_IMAGE_LAYOUT_GENERAL,                                 // VkImageLayout             newLayout
+			VK_QUEUE_FAMILY_IGNORED,                                 // uint32_t                  srcQueueFamilyIndex
+			VK_QUEUE_FAMILY_IGNORED,                                 // uint32_t                  dstQueueFamilyIndex
+			m_image.handle(),                                        // VkImage                   image
+			image_subresource_range                                  // VkImageSubresourceRange   subresourceRange
+		};
+		command_buffer.pipeline_barrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &image_memory_barrier_from_transfer_to_compute);
+
+		command_buffer.end();
+
+		VkCommandBuffer vk_command_buffer = command_buffer();
+		VkSubmitInfo submit_info = {
+			VK_STRUCTURE_TYPE_SUBMIT_INFO,            // VkStructureType              sType
+			nullptr,                                  // const void                  *pNext
+			0,                                        // uint32_t                     waitSemaphoreCount
+			nullptr,                                  // const VkSemaphore           *pWaitSemaphores
+			nullptr,                                  // const VkPipelineStageFlags  *pWaitDstStageMask;
+			1,                                        // uint32_t                     commandBufferCount
+			&vk_command_buffer,                       // const VkCommandBuffer       *pCommandBuffers
+			0,                                        // uint32_t                     signalSemaphoreCount
+			nullptr                                   // const VkSemaphore           *pSignalSemaphores
+		};
+
+		m_device->graphics_queue().submit(submit_info, VK_NULL_HANDLE);
+
+		m_device->get_handle().wait_idle();
+	}
+}
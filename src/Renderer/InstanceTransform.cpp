@@ -0,0 +1,43 @@
+#include <Renderer/InstanceTransform.hpp>
+
+#include <cassert>
+
+namespace Nth {
+	void compute_normal_matrices(std::vector<ModelGpuObject>& objects) {
+		// Inverse transpose of the upper 3x3, the rows of the cofactor matrix over the determinant
+		// Straight line code without branches so the loop vectorizes over objects
+		for (ModelGpuObject& object : objects) {
+			const Matrix4f& m = object.model;
+
+			float c11 = m.a22 * m.a33 - m.a23 * m.a32;
+			float c12 = m.a23 * m.a31 - m.a21 * m.a33;
+			float c13 = m.a21 * m.a32 - m.a22 * m.a31;
+
+			float c21 = m.a32 * m.a13 - m.a33 * m.a12;
+			float c22 = m.a33 * m.a11 - m.a31 * m.a13;
+			float c23 = m.a31 * m.a12 - m.a32 * m.a11;
+
+			float c31 = m.a12 * m.a23 - m.a13 * m.a22;
+			float c32 = m.a13 * m.a21 - m.a11 * m.a23;
+			float c33 = m.a11 * m.a22 - m.a12 * m.a21;
+
+			float det = m.a11 * c11 + m.a12 * c12 + m.a13 * c13;
+			float inv_det = det != 0.f ? 1.f / det : 0.f;
+
+			object.normal[0] = Vector4f{ c11 * inv_det, c12 * inv_det, c13 * inv_det, 0.f };
+			object.normal[1] = Vector4f{ c21 * inv_det, c22 * inv_det, c23 * inv_det, 0.f };
+			object.normal[2] = Vector4f{ c31 * inv_det, c32 * inv_det, c33 * inv_det, 0.f };
+		}
+	}
+
+	AffineModelGpuObject make_affine_model(const Matrix4f& model) {
+		assert(model.a14 == 0.f && model.a24 == 0.f && model.a34 == 0.f && model.a44 == 1.f);
+
+		// Columns of the row vector transform, shaders apply it as vec4(position, 1.0) * mat3x4
+		return AffineModelGpuObject{ {
+			Vector4f{ model.a11, model.a21, model.a31, model.a41 },
+			Vector4f{ model.a12, model.a22, model.a32, model.a42 },
+			Vector4f{ model.a13, model.a23, model.a33, model.a43 }
+		} };
+	}
+}
@@ -0,0 +1,143 @@
+#include <Renderer/LightClusters.hpp>
+
+#include <Renderer/RenderDevice.hpp>
+#include <Renderer/DescriptorAllocator.hpp>
+#include <Renderer/Vulkan/Device.hpp>
+#include <Renderer/Vulkan/CommandBuffer.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+namespace Nth {
+	LightClusters::LightClusters() :
+		m_device(nullptr) { }
+
+	void LightClusters::init(const RenderDevice& device, DescriptorAllocator& allocator, const std::filesystem::path& assign_shader_name, size_t frame_count) {
+		m_device = &device;
+
+		m_descriptor_set_layout = create_descriptor_set_layout(device.get_handle(), {
+			BindingInfo{ ShaderType::Compute, BindingType::Uniform, 0, 0 },
+			BindingInfo{ ShaderType::Compute, BindingType::Uniform, 0, 1 },
+			BindingInfo{ ShaderType::Compute, BindingType::Storage, 0, 2 },
+			BindingInfo{ ShaderType::Compute, BindingType::Storage, 0, 3 },
+			BindingInfo{ ShaderType::Compute, BindingType::Storage, 0, 4 }
+		});
+
+		m_assign.create(device.get_handle(), assign_shader_name, { m_descriptor_set_layout() }, 0);
+
+		m_frames.clear();
+		for (size_t i = 0; i < frame_count; ++i) {
+			Frame frame;
+
+			frame.cluster_buffer = RenderBuffer{
+				device,
+				VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+				sizeof(ClusterGpuObject)
+			};
+
+			frame.grid_buffer = RenderBuffer{
+				device,
+				VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+				VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+				LightClusters::cluster_count * sizeof(uint32_t)
+			};
+
+			frame.index_buffer = RenderBuffer{
+				device,
+				VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+				VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+				LightClusters::cluster_count * LightClusters::max_lights_per_cluster * sizeof(uint32_t)
+			};
+
+			frame.binding = ShaderBinding{ allocator.allocate(m_descriptor_set_layout) };
+
+			reserve_lights(frame, 64);
+
+			m_frames.push_back(std::move(frame));
+		}
+	}
+
+	void LightClusters::update(size_t frame_index, const RenderBuffer& viewer_buffer, const std::vector<PointLightGpuObject>& lights, const Vector2ui& screen_size, float z_near, float z_far) {
+		assert(frame_index < m_frames.size());
+		Frame& frame = m_frames[frame_index];
+
+		reserve_lights(frame, lights.size());
+		if (!lights.empty()) {
+			frame.light_buffer.copy(lights.data(), lights.size() * sizeof(PointLightGpuObject));
+		}
+
+		ClusterGpuObject cluster{
+			{ LightClusters::grid_width, LightClusters::grid_height, LightClusters::grid_depth },
+			static_cast<uint32_t>(lights.size()),
+			Vector2f{ static_cast<float>(screen_size.x), static_cast<float>(screen_size.y) },
+			z_near,
+			z_far
+		};
+		frame.cluster_buffer.copy(&cluster, sizeof(ClusterGpuObject));
+
+		UniformBinding viewer_uniform{ viewer_buffer, 0, viewer_buffer.handle.get_size() };
+		UniformBinding cluster_uniform{ frame.cluster_buffer, 0, frame.cluster_buffer.handle.get_size() };
+		StorageBinding light_storage{ frame.light_buffer, 0, frame.light_buffer.handle.get_size() };
+		StorageBinding grid_storage{ frame.grid_buffer, 0, frame.grid_buffer.handle.get_size() };
+		StorageBinding index_storage{ frame.index_buffer, 0, frame.index_buffer.handle.get_size() };
+
+		frame.binding.update({
+			Binding{ viewer_uniform, 0 },
+			Binding{ cluster_uniform, 1 },
+			Binding{ light_storage, 2 },
+			Binding{ grid_storage, 3 },
+			Binding{ index_storage, 4 }
+		});
+	}
+
+	void LightClusters::build(const Vk::CommandBuffer& command_buffer, size_t frame_index) const {
+		assert(frame_index < m_frames.size());
+
+		command_buffer.bind_pipeline(VK_PIPELINE_BIND_POINT_COMPUTE, m_assign.pipeline());
+
+		VkDescriptorSet vk_descriptor_set = m_frames[frame_index].binding.descriptor_set()();
+		command_buffer.bind_descriptor_sets(VK_PIPELINE_BIND_POINT_COMPUTE, m_assign.pipeline_layout(), 0, 1, &vk_descriptor_set, 0, nullptr);
+
+		command_buffer.dispatch((LightClusters::cluster_count + 127) / 128, 1, 1);
+
+		VkMemoryBarrier memory_barrier = {
+			VK_STRUCTURE_TYPE_MEMORY_BARRIER,       // VkStructureType           sType
+			nullptr,                                // const void               *pNext
+			VK_ACCESS_SHADER_WRITE_BIT,             // VkAccessFlags             srcAccessMask
+			VK_ACCESS_SHADER_READ_BIT               // VkAccessFlags             dstAccessMask
+		};
+		command_buffer.pipeline_barrier(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 1, &memory_barrier, 0, nullptr, 0, nullptr);
+	}
+
+	const RenderBuffer& LightClusters::cluster_buffer(size_t frame_index) const {
+		return m_frames[frame_index].cluster_buffer;
+	}
+
+	const RenderBuffer& LightClusters::light_buffer(size_t frame_index) const {
+		return m_frames[frame_index].light_buffer;
+	}
+
+	const RenderBuffer& LightClusters::grid_buffer(size_t frame_index) const {
+		return m_frames[frame_index].grid_buffer;
+	}
+
+	const RenderBuffer& LightClusters::index_buffer(size_t frame_index) const {
+		return m_frames[frame_index].index_buffer;
+	}
+
+	void LightClusters::reserve_lights(Frame& frame, size_t light_count) {
+		if (frame.light_buffer.handle.get_size() >= light_count * sizeof(PointLightGpuObject)) {
+			return;
+		}
+
+		size_t capacity = std::max<size_t>(light_count, frame.light_buffer.handle.get_size() / sizeof(PointLightGpuObject) * 2);
+
+		frame.light_buffer = RenderBuffer{
+			*m_device,
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+			capacity * sizeof(PointLightGpuObject)
+		};
+	}
+}
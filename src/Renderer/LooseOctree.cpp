@@ -0,0 +1,398 @@
+#include <Renderer/LooseOctree.hpp>
+
+#include <Maths/Frustum.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace Nth {
+	LooseOctree::LooseOctree(const BoundingBoxf& region, uint32_t max_depth) :
+		m_region(),
+		m_region_size(0.f),
+		m_max_depth(max_depth),
+		m_cells(),
+		m_free_cells(),
+		m_pruned_cell_count(0),
+		m_item_bounds(),
+		m_placements(),
+		m_size(0) {
+		assert(region.is_valid());
+
+		Vector3f extent = region.extent();
+		float half_size = std::max({ extent.x, extent.y, extent.z });
+
+		m_region_size = 2.f * half_size;
+		m_region = BoundingBoxf{ region.center() - Vector3f{ half_size, half_size, half_size }, region.center() + Vector3f{ half_size, half_size, half_size } };
+
+		clear();
+	}
+
+	void LooseOctree::set(uint32_t item, const BoundingBoxf& bounds) {
+		if (!bounds.is_valid()) {
+			remove(item);
+			return;
+		}
+
+		if (item >= m_item_bounds.size()) {
+			m_item_bounds.resize(item + 1);
+			m_placements.resize(item + 1, Placement{ LooseOctree::no_cell, LooseOctree::no_cell, LooseOctree::no_cell, 0, Vector3f{ 0.f, 0.f, 0.f }, 0.f });
+		}
+
+		m_item_bounds[item] = bounds;
+
+		// Most moves stay in the loose bounds of the same cell, even past its octant
+		uint32_t depth = fit_depth(bounds);
+
+		const Placement& placement = m_placements[item];
+		uint32_t current_cell = placement.cell;
+		if (current_cell != LooseOctree::no_cell && placement.depth == depth) {
+			BoundingBoxf cell_bounds = loose_bounds(placement.origin, placement.size);
+			if (bounds.min.x >= cell_bounds.min.x && bounds.min.y >= cell_bounds.min.y && bounds.min.z >= cell_bounds.min.z &&
+				bounds.max.x <= cell_bounds.max.x && bounds.max.y <= cell_bounds.max.y && bounds.max.z <= cell_bounds.max.z) {
+				return;
+			}
+		}
+
+		uint32_t cell_index = move_to_cell(bounds.center(), depth, current_cell);
+		if (cell_index == current_cell) {
+			return;
+		}
+
+		if (current_cell != LooseOctree::no_cell) {
+			erase(item);
+		}
+		else {
+			++m_size;
+		}
+
+		insert(item, cell_index);
+	}
+
+	void LooseOctree::remove(uint32_t item) {
+		if (!contains(item)) {
+			return;
+		}
+
+		uint32_t cell_index = m_placements[item].cell;
+		erase(item);
+
+		for (; cell_index != LooseOctree::no_cell; cell_index = m_cells[cell_index].parent) {
+			--m_cells[cell_index].item_count;
+		}
+
+		m_item_bounds[item] = BoundingBoxf{};
+		--m_size;
+	}
+
+	bool LooseOctree::contains(uint32_t item) const {
+		return item < m_placements.size() && m_placements[item].cell != LooseOctree::no_cell;
+	}
+
+	void LooseOctree::clear() {
+		m_cells.clear();
+		m_free_cells.clear();
+		m_item_bounds.clear();
+		m_placements.clear();
+		m_size = 0;
+
+		add_cell(LooseOctree::no_cell, 0, m_region.min, m_region_size);
+		m_pruned_cell_count = cell_count();
+	}
+
+	void LooseOctree::refresh() {
+		// Pruning every frame would free the cells moving items come back to the next one
+		if (cell_count() > 2 * m_pruned_cell_count) {
+			prune();
+		}
+	}
+
+	void LooseOctree::prune() {
+		std::vector<uint32_t> stack{ 0 };
+		while (!stack.empty()) {
+			uint32_t cell_index = stack.back();
+			stack.pop_back();
+
+			for (uint32_t child : m_cells[cell_index].children) {
+				if (child == LooseOctree::no_cell) {
+					continue;
+				}
+
+				if (m_cells[child].item_count == 0) {
+					free_cell(child);
+				}
+				else {
+					stack.push_back(child);
+				}
+			}
+		}
+
+		m_pruned_cell_count = cell_count();
+	}
+
+	void LooseOctree::query(const BoundingBoxf& bounds, std::vector<uint32_t>& items) const {
+		std::vector<uint32_t> stack{ 0 };
+		while (!stack.empty()) {
+			const Cell& cell = m_cells[stack.back()];
+			stack.pop_back();
+
+			for (uint32_t item = cell.first_item; item != LooseOctree::no_cell; item = m_placements[item].next) {
+				if (m_item_bounds[item].intersect(bounds)) {
+					items.push_back(item);
+				}
+			}
+
+			for (uint32_t child : cell.children) {
+				if (child != LooseOctree::no_cell && m_cells[child].item_count > 0 && loose_bounds(m_cells[child].origin, m_cells[child].size).intersect(bounds)) {
+					stack.push_back(child);
+				}
+			}
+		}
+	}
+
+	void LooseOctree::query(const Vector3f& origin, const Vector3f& direction, float max_distance, std::vector<BoundingVolumeHit>& hits) const {
+		size_t first_hit = hits.size();
+		float distance;
+
+		std::vector<uint32_t> stack{ 0 };
+		while (!stack.empty()) {
+			const Cell& cell = m_cells[stack.back()];
+			stack.pop_back();
+
+			for (uint32_t item = cell.first_item; item != LooseOctree::no_cell; item = m_placements[item].next) {
+				if (m_item_bounds[item].intersect_ray(origin, direction, max_distance, distance)) {
+					hits.push_back(BoundingVolumeHit{ item, distance });
+				}
+			}
+
+			for (uint32_t child : cell.children) {
+				if (child != LooseOctree::no_cell && m_cells[child].item_count > 0 && loose_bounds(m_cells[child].origin, m_cells[child].size).intersect_ray(origin, direction, max_distance, distance)) {
+					stack.push_back(child);
+				}
+			}
+		}
+
+		std::sort(hits.begin() + first_hit, hits.end(), [](const BoundingVolumeHit& a, const BoundingVolumeHit& b) {
+			return a.distance < b.distance;
+		});
+	}
+
+	void LooseOctree::cull(const Matrix4f& view_projection, std::vector<uint32_t>& items, const std::function<bool(const BoundingBoxf&)>& visible) const {
+		Frustumf frustum{ view_projection };
+
+		// The root also holds items outside the region, so only its children are tested as a whole
+		std::vector<std::pair<uint32_t, bool>> stack{ { 0, false } };
+		while (!stack.empty()) {
+			auto [cell_index, inside] = stack.back();
+			stack.pop_back();
+
+			const Cell& cell = m_cells[cell_index];
+			BoundingBoxf cell_bounds = loose_bounds(cell.origin, cell.size);
+			if (cell_index != 0) {
+				if (!inside) {
+					FrustumContainment containment = frustum.classify(cell_bounds);
+					if (containment == FrustumContainment::Outside) {
+						continue;
+					}
+
+					inside = containment == FrustumContainment::Inside;
+				}
+
+				if (visible && !visible(cell_bounds)) {
+					continue;
+				}
+			}
+
+			for (uint32_t item = cell.first_item; item != LooseOctree::no_cell; item = m_placements[item].next) {
+				const BoundingBoxf& box = m_item_bounds[item];
+				if (!inside && frustum.classify(box) == FrustumContainment::Outside) {
+					continue;
+				}
+
+				if (!visible || visible(box)) {
+					items.push_back(item);
+				}
+			}
+
+			for (uint32_t child : cell.children) {
+				if (child != LooseOctree::no_cell && m_cells[child].item_count > 0) {
+					stack.emplace_back(child, inside);
+				}
+			}
+		}
+	}
+
+	const BoundingBoxf& LooseOctree::region() const {
+		return m_region;
+	}
+
+	const BoundingBoxf& LooseOctree::bounds(uint32_t item) const {
+		assert(item < m_item_bounds.size());
+
+		return m_item_bounds[item];
+	}
+
+	uint32_t LooseOctree::max_depth() const {
+		return m_max_depth;
+	}
+
+	size_t LooseOctree::cell_count() const {
+		return m_cells.size() - m_free_cells.size();
+	}
+
+	size_t LooseOctree::size() const {
+		return m_size;
+	}
+
+	BoundingBoxf LooseOctree::loose_bounds(const Vector3f& origin, float size) {
+		Vector3f margin{ size * 0.5f, size * 0.5f, size * 0.5f };
+
+		return BoundingBoxf{ origin - margin, origin + Vector3f{ size, size, size } + margin };
+	}
+
+	uint32_t LooseOctree::fit_depth(const BoundingBoxf& bounds) const {
+		if (!m_region.contains(bounds.center())) {
+			return 0;
+		}
+
+		// The item then fits the loose cell around its center
+		Vector3f size = bounds.max - bounds.min;
+		float item_size = std::max({ size.x, size.y, size.z });
+
+		uint32_t depth = 0;
+		float cell_size = m_region_size;
+		while (depth < m_max_depth && item_size <= cell_size * 0.5f) {
+			cell_size *= 0.5f;
+			++depth;
+		}
+
+		return depth;
+	}
+
+	uint32_t LooseOctree::move_to_cell(const Vector3f& center, uint32_t depth, uint32_t from_cell) {
+		auto holds = [&](const Cell& cell) {
+			return center.x >= cell.origin.x && center.x <= cell.origin.x + cell.size &&
+				center.y >= cell.origin.y && center.y <= cell.origin.y + cell.size &&
+				center.z >= cell.origin.z && center.z <= cell.origin.z + cell.size;
+		};
+
+		// New items come down from the root, which holds items centered outside the region too
+		uint32_t cell_index = from_cell;
+		if (cell_index == LooseOctree::no_cell) {
+			cell_index = 0;
+			++m_cells[0].item_count;
+		}
+
+		while (cell_index != 0 && (m_cells[cell_index].depth > depth || !holds(m_cells[cell_index]))) {
+			--m_cells[cell_index].item_count;
+			cell_index = m_cells[cell_index].parent;
+		}
+
+		while (m_cells[cell_index].depth < depth) {
+			float octant_size = m_cells[cell_index].size * 0.5f;
+			Vector3f origin = m_cells[cell_index].origin;
+
+			uint32_t octant = 0;
+			if (center.x >= origin.x + octant_size) {
+				octant |= 1;
+				origin.x += octant_size;
+			}
+			if (center.y >= origin.y + octant_size) {
+				octant |= 2;
+				origin.y += octant_size;
+			}
+			if (center.z >= origin.z + octant_size) {
+				octant |= 4;
+				origin.z += octant_size;
+			}
+
+			uint32_t child = m_cells[cell_index].children[octant];
+			if (child == LooseOctree::no_cell) {
+				child = add_cell(cell_index, octant, origin, octant_size);
+			}
+
+			++m_cells[child].item_count;
+			cell_index = child;
+		}
+
+		return cell_index;
+	}
+
+	uint32_t LooseOctree::add_cell(uint32_t parent, uint32_t octant, const Vector3f& origin, float size) {
+		uint32_t cell_index;
+		if (!m_free_cells.empty()) {
+			cell_index = m_free_cells.back();
+			m_free_cells.pop_back();
+		}
+		else {
+			cell_index = static_cast<uint32_t>(m_cells.size());
+			m_cells.emplace_back();
+		}
+
+		Cell& cell = m_cells[cell_index];
+		cell.origin = origin;
+		cell.size = size;
+		cell.depth = parent == LooseOctree::no_cell ? 0 : m_cells[parent].depth + 1;
+		cell.parent = parent;
+		cell.item_count = 0;
+		cell.children.fill(LooseOctree::no_cell);
+		cell.first_item = LooseOctree::no_cell;
+
+		if (parent != LooseOctree::no_cell) {
+			m_cells[parent].children[octant] = cell_index;
+		}
+
+		return cell_index;
+	}
+
+	void LooseOctree::insert(uint32_t item, uint32_t cell_index) {
+		Cell& cell = m_cells[cell_index];
+
+		m_placements[item] = Placement{ cell_index, LooseOctree::no_cell, cell.first_item, cell.depth, cell.origin, cell.size };
+		if (cell.first_item != LooseOctree::no_cell) {
+			m_placements[cell.first_item].previous = item;
+		}
+		cell.first_item = item;
+	}
+
+	void LooseOctree::erase(uint32_t item) {
+		Placement& placement = m_placements[item];
+
+		if (placement.previous != LooseOctree::no_cell) {
+			m_placements[placement.previous].next = placement.next;
+		}
+		else {
+			m_cells[placement.cell].first_item = placement.next;
+		}
+
+		if (placement.next != LooseOctree::no_cell) {
+			m_placements[placement.next].previous = placement.previous;
+		}
+
+		placement.cell = LooseOctree::no_cell;
+	}
+
+	void LooseOctree::free_cell(uint32_t cell_index) {
+		Cell& cell = m_cells[cell_index];
+
+		std::array<uint32_t, 8>& siblings = m_cells[cell.parent].children;
+		*std::find(siblings.begin(), siblings.end(), cell_index) = LooseOctree::no_cell;
+
+		// The whole subtree is empty
+		std::vector<uint32_t> stack{ cell_index };
+		while (!stack.empty()) {
+			uint32_t freed_index = stack.back();
+			Cell& freed = m_cells[freed_index];
+			m_free_cells.push_back(freed_index);
+			stack.pop_back();
+
+			assert(freed.first_item == LooseOctree::no_cell && freed.item_count == 0);
+			for (uint32_t child : freed.children) {
+				if (child != LooseOctree::no_cell) {
+					stack.push_back(child);
+				}
+			}
+			freed.children.fill(LooseOctree::no_cell);
+		}
+	}
+}
@@ -2,13 +2,17 @@
 
 #include <Renderer/Vulkan/Device.hpp>
 #include <Renderer/Vertex.hpp>
+#include <Renderer/QuantizedVertex.hpp>
+#include <Renderer/SceneParameters.hpp>
 
-#include <Utils/Reader.hpp>
+#include <Utils/AssetFile.hpp>
 
 #include <iostream>
 
 namespace Nth {
-	void Material::create_pipeline(const Vk::Device& device, const Vk::RenderPass& render_pass, const std::filesystem::path& vertex_shader_name, const std::filesystem::path& fragment_shader_name, const std::vector<VkDescriptorSetLayout>& descriptor_set_layouts) {
+	void Material::create_pipeline(const Vk::Device& device, const Vk::RenderPass& render_pass, const std::filesystem::path& vertex_shader_name, const std::filesystem::path& fragment_shader_name, const std::vector<VkDescriptorSetLayout>& descriptor_set_layouts, VertexFormat format, InstanceFormat instance_format) {
+		vertex_format = format;
+
 		Vk::ShaderModule vertex_shader_module = create_shader_module(device, vertex_shader_name);
 		Vk::ShaderModule fragment_shader_module = create_shader_module(device, fragment_shader_name);
 
@@ -16,6 +20,21 @@ namespace Nth {
 			throw std::runtime_error("Can't create vertex or shader module");
 		}
 
+		// Constant 0 of the vertex shaders selects how object data is decoded
+		VkBool32 compact_instances = instance_format == InstanceFormat::Affine ? VK_TRUE : VK_FALSE;
+		VkSpecializationMapEntry specialization_entry = {
+			0,                                                          // uint32_t                                       constantID
+			0,                                                          // uint32_t                                       offset
+			sizeof(VkBool32)                                            // size_t                                         size
+		};
+
+		VkSpecializationInfo specialization_info = {
+			1,                                                          // uint32_t                                       mapEntryCount
+			&specialization_entry,                                      // const VkSpecializationMapEntry                *pMapEntries
+			sizeof(VkBool32),                                           // size_t                                         dataSize
+			&compact_instances                                          // const void                                    *pData
+		};
+
 		std::vector<VkPipelineShaderStageCreateInfo> shaderStageCreateInfos = {
 			// Vertex shader
 			{
@@ -25,7 +44,7 @@ namespace Nth {
 				VK_SHADER_STAGE_VERTEX_BIT,                                 // VkShaderStageFlagBits                          stage
 				vertex_shader_module(),                                       // VkShaderModule                                 module
 				"main",                                                     // const char                                    *pName
-				nullptr                                                     // const VkSpecializationInfo                    *pSpecializationInfo
+				&specialization_info                                        // const VkSpecializationInfo                    *pSpecializationInfo
 			},
 			// Fragment shader
 			{
@@ -39,7 +58,7 @@ namespace Nth {
 			}
 		};
 
-		VertexInputDescription vertex_input_description = Vertex::get_vertex_description();
+		VertexInputDescription vertex_input_description = (vertex_format == VertexFormat::Quantized) ? QuantizedVertex::get_vertex_description() : Vertex::get_vertex_description();
 		VkPipelineVertexInputStateCreateInfo vertexInputStateCreateInfo = {
 			VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,       // VkStructureType                                sType
 			nullptr,                                                         // const void                                    *pNext
@@ -172,21 +191,29 @@ namespace Nth {
 	}
 
 	void Material::create_pipeline_layout(const Vk::Device& device, const std::vector<VkDescriptorSetLayout>& descriptor_set_layouts) {
+		VkPushConstantRange push_constant_range = {
+			VK_SHADER_STAGE_VERTEX_BIT,                                 // VkShaderStageFlags                             stageFlags
+			0,                                                          // uint32_t                                       offset
+			sizeof(MeshGpuObject)                                       // uint32_t                                       size
+		};
+
 		pipeline_layout.create(
 			device,
 			0,
 			static_cast<uint32_t>(descriptor_set_layouts.size()),
 			descriptor_set_layouts.data(),
-			0,
-			nullptr
+			1,
+			&push_constant_range
 		);
 	}
 
 	Vk::ShaderModule Material::create_shader_module(const Vk::Device& device, const std::filesystem::path& path) const {
-		std::vector<char> code{ read_binary_file(path) };
+		// SPIR-V is read in place, mappings and decompressed content are aligned for its words
+		AssetFile code = AssetFile::Open(path);
+		code.advise(MappedFile::Access::Sequential);
 
 		Vk::ShaderModule shader;
-		shader.create(device, code.size(), reinterpret_cast<const uint32_t*>(&code[0]));
+		shader.create(device, code.size(), reinterpret_cast<const uint32_t*>(code.data()));
 
 		return shader;
 	}
@@ -4,17 +4,133 @@
 
 #include <tiny_obj_loader.h>
 
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+
 namespace Nth {
 	Mesh::Mesh(std::vector<Vertex> vertices, std::vector<uint32_t> indices, std::vector<size_t> texturesIndex) :
 		vertices(std::move(vertices)),
 		indices(std::move(indices)),
-		textures_index(std::move(texturesIndex)) { }
+		textures_index(std::move(texturesIndex)) {
+		update_bounds();
+	}
 
 	void Mesh::add_texture_index(size_t index) {
 		textures_index.push_back(index);
 	}
 
-	Mesh Mesh::FromOBJ(std::string_view filename) {
+	void Mesh::update_bounds() {
+		bounds = BoundingBoxf{};
+		for (const Vertex& vertex : vertices) {
+			bounds.extend(vertex.pos);
+		}
+	}
+
+	void Mesh::generate_lods(size_t count, float reduction) {
+		lods.clear();
+
+		size_t index_count = indices.size();
+		for (size_t i = 0; i < count; ++i) {
+			size_t target = static_cast<size_t>(static_cast<float>(index_count) * reduction) / 3 * 3;
+
+			MeshLod lod = simplify_mesh(vertices, indices, target);
+			if (lod.indices.size() >= index_count) {
+				break;
+			}
+
+			index_count = lod.indices.size();
+			lods.push_back(std::move(lod));
+		}
+	}
+
+	void Mesh::quantize() {
+		quantized_vertices.clear();
+		quantized_vertices.reserve(vertices.size());
+		for (const Vertex& vertex : vertices) {
+			quantized_vertices.push_back(quantize_vertex(vertex, bounds));
+		}
+	}
+
+	MeshOptimizationReport Mesh::optimize() {
+		// Reordering would leave the meshlets pointing at other triangles
+		if (!meshlets.empty()) {
+			throw std::runtime_error("Can't optimize a mesh once its meshlets are built");
+		}
+
+		MeshOptimizationReport report;
+		report.before = analyze_vertex_cache(indices, vertices.size());
+
+		optimize_vertex_cache(indices, vertices.size());
+		optimize_overdraw(indices, vertices);
+
+		std::vector<uint32_t> remap = optimize_vertex_fetch(vertices, indices);
+		for (MeshLod& lod : lods) {
+			for (uint32_t& index : lod.indices) {
+				index = remap[index];
+			}
+		}
+
+		update_bounds();
+		if (!quantized_vertices.empty()) {
+			quantize();
+		}
+
+		report.after = analyze_vertex_cache(indices, vertices.size());
+
+		return report;
+	}
+
+	void Mesh::prepare(const ImportOptions& options) {
+		if (options.optimize_meshes) {
+			optimize();
+		}
+
+		// Levels are simplified from the optimized order, meshlets and quantization then see the final vertices
+		if (options.lod_count > 0) {
+			generate_lods(options.lod_count, options.lod_reduction);
+		}
+
+		if (options.build_meshlets) {
+			generate_meshlets();
+		}
+
+		if (options.quantize_vertices) {
+			quantize();
+		}
+	}
+
+	void Mesh::generate_meshlets(uint32_t max_vertices, uint32_t max_triangles) {
+		meshlets = build_meshlets(vertices, indices, max_vertices, max_triangles);
+	}
+
+	IndexFormat Mesh::index_format() const {
+		return vertices.size() <= std::numeric_limits<uint16_t>::max() ? IndexFormat::UInt16 : IndexFormat::UInt32;
+	}
+
+	std::vector<uint8_t> Mesh::pack_indices(const std::vector<uint32_t>& indices, IndexFormat format) {
+		if (format == IndexFormat::UInt32) {
+			std::vector<uint8_t> packed(indices.size() * sizeof(uint32_t));
+			std::memcpy(packed.data(), indices.data(), packed.size());
+
+			return packed;
+		}
+
+		std::vector<uint8_t> packed(indices.size() * sizeof(uint16_t));
+		for (size_t i = 0; i < indices.size(); ++i) {
+			assert(indices[i] <= std::numeric_limits<uint16_t>::max());
+
+			uint16_t index = static_cast<uint16_t>(indices[i]);
+			std::memcpy(packed.data() + i * sizeof(uint16_t), &index, sizeof(uint16_t));
+		}
+
+		return packed;
+	}
+
+	Mesh Mesh::FromOBJ(std::string_view filename, const ImportOptions& options) {
 		tinyobj::attrib_t attrib;
 		std::vector<tinyobj::shape_t> shapes;
 		std::vector<tinyobj::material_t> materials;
@@ -26,6 +142,17 @@ namespace Nth {
 
 		Mesh newMesh;
 
+		// Corners are welded on their full attributes, compared bit for bit
+		using VertexKey = std::array<uint32_t, 8>;
+		auto hash_key = [](const VertexKey& key) {
+			size_t hash = 14695981039346656037ull;
+			for (uint32_t value : key) {
+				hash = (hash ^ value) * 1099511628211ull;
+			}
+			return hash;
+		};
+		std::unordered_map<VertexKey, uint32_t, decltype(hash_key)> unique_vertices(0, hash_key);
+
 		for (const auto& shape : shapes) {
 			for (const auto& index : shape.mesh.indices) {
 				Vertex vertex{};
@@ -50,12 +177,27 @@ namespace Nth {
 						attrib.normals[3 * index.normal_index + 2],
 					};
 				}
-				
-				newMesh.vertices.push_back(vertex);
-				newMesh.indices.push_back(static_cast<unsigned int>(newMesh.indices.size()));
+
+				const float attributes[8] = {
+					vertex.pos.x, vertex.pos.y, vertex.pos.z,
+					vertex.texture_pos.x, vertex.texture_pos.y,
+					vertex.normal.x, vertex.normal.y, vertex.normal.z
+				};
+				VertexKey key;
+				std::memcpy(key.data(), attributes, sizeof(attributes));
+
+				auto inserted = unique_vertices.emplace(key, static_cast<uint32_t>(newMesh.vertices.size()));
+				if (inserted.second) {
+					newMesh.vertices.push_back(vertex);
+				}
+
+				newMesh.indices.push_back(inserted.first->second);
 			}
 		}
 
+		newMesh.update_bounds();
+		newMesh.prepare(options);
+
 		return newMesh;
 	}
 
@@ -87,6 +229,7 @@ namespace Nth {
 		mesh.vertices.push_back(std::move(right_bot));
 
 		mesh.indices = { 0, 1, 3, 0, 2, 3 };
+		mesh.update_bounds();
 
 		return mesh;
 	}
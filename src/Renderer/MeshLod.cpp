@@ -0,0 +1,434 @@
+#include <Renderer/MeshLod.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace Nth {
+	// Symmetric 4x4 error matrix (a00 a01 a02 a03 a11 a12 a13 a22 a23 a33) and the weight it was built with
+	using Quadric = std::array<double, 11>;
+
+	using Position = std::array<double, 3>;
+
+	MeshLod simplify_mesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, size_t target_index_count) {
+		assert(indices.size() % 3 == 0);
+
+		MeshLod lod;
+		lod.indices = indices;
+		lod.error = 0.f;
+
+		if (indices.size() <= target_index_count || vertices.empty()) {
+			return lod;
+		}
+
+		const size_t vertex_count = vertices.size();
+
+		// Vertices with identical attributes are welded, vertices sharing only a position are wedges of the same corner
+		auto position_of = [&](uint32_t index) {
+			const Vertex& vertex = vertices[index];
+			return std::array<float, 3>{ vertex.pos.x, vertex.pos.y, vertex.pos.z };
+		};
+		auto attributes_of = [&](uint32_t index) {
+			const Vertex& vertex = vertices[index];
+			return std::array<float, 8>{
+				vertex.pos.x, vertex.pos.y, vertex.pos.z,
+				vertex.texture_pos.x, vertex.texture_pos.y,
+				vertex.normal.x, vertex.normal.y, vertex.normal.z
+			};
+		};
+
+		std::vector<uint32_t> order(vertex_count);
+		for (uint32_t i = 0; i < vertex_count; ++i) {
+			order[i] = i;
+		}
+
+		std::vector<uint32_t> wedge_of(vertex_count);
+		std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return attributes_of(a) < attributes_of(b); });
+		for (size_t i = 0; i < vertex_count; ++i) {
+			bool same = i > 0 && attributes_of(order[i]) == attributes_of(order[i - 1]);
+			wedge_of[order[i]] = same ? wedge_of[order[i - 1]] : order[i];
+		}
+
+		std::vector<uint32_t> position_id(vertex_count);
+		std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return position_of(a) < position_of(b); });
+		for (size_t i = 0; i < vertex_count; ++i) {
+			bool same = i > 0 && position_of(order[i]) == position_of(order[i - 1]);
+			position_id[order[i]] = same ? position_id[order[i - 1]] : order[i];
+		}
+
+		// Work in a unit sized space so the quadric costs don't depend on the mesh scale
+		std::array<float, 3> min = position_of(0);
+		std::array<float, 3> max = min;
+		for (uint32_t i = 1; i < vertex_count; ++i) {
+			std::array<float, 3> position = position_of(i);
+			for (size_t axis = 0; axis < 3; ++axis) {
+				min[axis] = std::min(min[axis], position[axis]);
+				max[axis] = std::max(max[axis], position[axis]);
+			}
+		}
+
+		double scale = std::max({ max[0] - min[0], max[1] - min[1], max[2] - min[2] });
+		if (scale <= 0.0) {
+			scale = 1.0;
+		}
+
+		std::vector<Position> positions(vertex_count);
+		for (uint32_t i = 0; i < vertex_count; ++i) {
+			std::array<float, 3> position = position_of(i);
+			for (size_t axis = 0; axis < 3; ++axis) {
+				positions[i][axis] = (position[axis] - min[axis]) / scale;
+			}
+		}
+
+		auto sub = [](const Position& a, const Position& b) {
+			return Position{ a[0] - b[0], a[1] - b[1], a[2] - b[2] };
+		};
+		auto cross = [](const Position& a, const Position& b) {
+			return Position{ a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0] };
+		};
+		auto dot = [](const Position& a, const Position& b) {
+			return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+		};
+
+		auto add_plane = [](Quadric& quadric, const Position& normal, double distance, double weight) {
+			const double a = normal[0], b = normal[1], c = normal[2], d = distance;
+			quadric[0] += weight * a * a; quadric[1] += weight * a * b; quadric[2] += weight * a * c; quadric[3] += weight * a * d;
+			quadric[4] += weight * b * b; quadric[5] += weight * b * c; quadric[6] += weight * b * d;
+			quadric[7] += weight * c * c; quadric[8] += weight * c * d;
+			quadric[9] += weight * d * d;
+			quadric[10] += weight;
+		};
+		auto evaluate = [](const Quadric& q, const Position& p) {
+			const double x = p[0], y = p[1], z = p[2];
+			double error = q[0] * x * x + 2.0 * q[1] * x * y + 2.0 * q[2] * x * z + 2.0 * q[3] * x
+				+ q[4] * y * y + 2.0 * q[5] * y * z + 2.0 * q[6] * y
+				+ q[7] * z * z + 2.0 * q[8] * z
+				+ q[9];
+			return std::max(error, 0.0) / std::max(q[10], std::numeric_limits<double>::min());
+		};
+
+		std::vector<std::array<uint32_t, 3>> triangles(indices.size() / 3);
+		for (size_t i = 0; i < triangles.size(); ++i) {
+			for (size_t corner = 0; corner < 3; ++corner) {
+				triangles[i][corner] = wedge_of[indices[3 * i + corner]];
+			}
+		}
+
+		auto edge_key = [](uint32_t a, uint32_t b) {
+			return std::make_pair(std::min(a, b), std::max(a, b));
+		};
+
+		// Face planes weighted by area, plus perpendicular planes on borders and attribute seams to keep them in place
+		std::vector<Quadric> quadrics(vertex_count, Quadric{});
+		{
+			std::vector<std::pair<uint32_t, uint32_t>> wedge_edges;
+			wedge_edges.reserve(triangles.size() * 3);
+			for (const auto& triangle : triangles) {
+				for (size_t corner = 0; corner < 3; ++corner) {
+					wedge_edges.push_back(edge_key(triangle[corner], triangle[(corner + 1) % 3]));
+				}
+			}
+			std::sort(wedge_edges.begin(), wedge_edges.end());
+
+			for (const auto& triangle : triangles) {
+				const Position& p0 = positions[triangle[0]];
+				const Position& p1 = positions[triangle[1]];
+				const Position& p2 = positions[triangle[2]];
+
+				Position normal = cross(sub(p1, p0), sub(p2, p0));
+				double length = std::sqrt(dot(normal, normal));
+				if (length <= 0.0) {
+					continue;
+				}
+
+				normal = { normal[0] / length, normal[1] / length, normal[2] / length };
+				double area = length * 0.5;
+				for (size_t corner = 0; corner < 3; ++corner) {
+					add_plane(quadrics[position_id[triangle[corner]]], normal, -dot(normal, p0), area);
+				}
+
+				for (size_t corner = 0; corner < 3; ++corner) {
+					uint32_t a = triangle[corner];
+					uint32_t b = triangle[(corner + 1) % 3];
+
+					auto range = std::equal_range(wedge_edges.begin(), wedge_edges.end(), edge_key(a, b));
+					if (range.second - range.first != 1) {
+						continue;
+					}
+
+					Position edge = sub(positions[b], positions[a]);
+					Position side = cross(edge, normal);
+					double side_length = std::sqrt(dot(side, side));
+					if (side_length <= 0.0) {
+						continue;
+					}
+
+					side = { side[0] / side_length, side[1] / side_length, side[2] / side_length };
+					double weight = 10.0 * dot(edge, edge);
+					add_plane(quadrics[position_id[a]], side, -dot(side, positions[a]), weight);
+					add_plane(quadrics[position_id[b]], side, -dot(side, positions[a]), weight);
+				}
+			}
+		}
+
+		struct Collapse {
+			uint32_t from;
+			uint32_t to;
+			double cost;
+		};
+
+		std::vector<std::pair<uint32_t, uint32_t>> edges;
+		std::vector<std::pair<uint32_t, uint32_t>> border_edges;
+		std::vector<bool> border(vertex_count);
+		std::vector<bool> touched(vertex_count);
+		std::vector<uint32_t> wedge_remap(vertex_count);
+		std::vector<uint32_t> adjacency_offsets(vertex_count + 1);
+		std::vector<uint32_t> adjacency;
+		std::vector<Collapse> collapses;
+		std::vector<std::pair<uint32_t, uint32_t>> wedge_pairs;
+		double max_cost = 0.0;
+
+		size_t triangle_count = triangles.size();
+		const size_t target_triangle_count = target_index_count / 3;
+
+		while (triangle_count > target_triangle_count) {
+			// Edges between corners, counted to find the open borders
+			edges.clear();
+			for (const auto& triangle : triangles) {
+				for (size_t corner = 0; corner < 3; ++corner) {
+					edges.push_back(edge_key(position_id[triangle[corner]], position_id[triangle[(corner + 1) % 3]]));
+				}
+			}
+			std::sort(edges.begin(), edges.end());
+
+			border_edges.clear();
+			std::fill(border.begin(), border.end(), false);
+			for (size_t i = 0; i < edges.size();) {
+				size_t j = i + 1;
+				while (j < edges.size() && edges[j] == edges[i]) {
+					++j;
+				}
+
+				// Non manifold edges are kept like borders
+				if (j - i != 2) {
+					border_edges.push_back(edges[i]);
+					border[edges[i].first] = true;
+					border[edges[i].second] = true;
+				}
+
+				i = j;
+			}
+			edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+			std::fill(adjacency_offsets.begin(), adjacency_offsets.end(), 0);
+			for (const auto& triangle : triangles) {
+				for (uint32_t wedge : triangle) {
+					++adjacency_offsets[position_id[wedge] + 1];
+				}
+			}
+			for (size_t i = 0; i < vertex_count; ++i) {
+				adjacency_offsets[i + 1] += adjacency_offsets[i];
+			}
+			adjacency.resize(adjacency_offsets.back());
+			{
+				std::vector<uint32_t> cursor(adjacency_offsets.begin(), adjacency_offsets.end() - 1);
+				for (uint32_t i = 0; i < triangles.size(); ++i) {
+					for (uint32_t wedge : triangles[i]) {
+						adjacency[cursor[position_id[wedge]]++] = i;
+					}
+				}
+			}
+
+			auto is_border_edge = [&](uint32_t a, uint32_t b) {
+				return std::binary_search(border_edges.begin(), border_edges.end(), edge_key(a, b));
+			};
+			auto can_move = [&](uint32_t from, uint32_t to) {
+				// Border corners may only slide along the border
+				return !border[from] || is_border_edge(from, to);
+			};
+
+			collapses.clear();
+			for (const auto& edge : edges) {
+				uint32_t a = edge.first;
+				uint32_t b = edge.second;
+
+				Quadric quadric = quadrics[a];
+				for (size_t i = 0; i < quadric.size(); ++i) {
+					quadric[i] += quadrics[b][i];
+				}
+
+				double cost_ab = can_move(a, b) ? evaluate(quadric, positions[b]) : std::numeric_limits<double>::infinity();
+				double cost_ba = can_move(b, a) ? evaluate(quadric, positions[a]) : std::numeric_limits<double>::infinity();
+				if (std::isinf(cost_ab) && std::isinf(cost_ba)) {
+					continue;
+				}
+
+				if (cost_ab <= cost_ba) {
+					collapses.push_back({ a, b, cost_ab });
+				}
+				else {
+					collapses.push_back({ b, a, cost_ba });
+				}
+			}
+			std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.cost < b.cost; });
+
+			std::fill(touched.begin(), touched.end(), false);
+			for (uint32_t i = 0; i < vertex_count; ++i) {
+				wedge_remap[i] = i;
+			}
+
+			size_t remaining = triangle_count;
+			size_t collapsed = 0;
+			for (const Collapse& collapse : collapses) {
+				if (remaining <= target_triangle_count) {
+					break;
+				}
+
+				uint32_t u = collapse.from;
+				uint32_t v = collapse.to;
+				if (touched[u] || touched[v]) {
+					continue;
+				}
+
+				// Every wedge of u must follow a wedge of v along the collapsed edge, otherwise an attribute seam would tear
+				wedge_pairs.clear();
+				size_t removed = 0;
+				bool valid = true;
+				for (uint32_t k = adjacency_offsets[u]; k < adjacency_offsets[u + 1] && valid; ++k) {
+					const auto& triangle = triangles[adjacency[k]];
+
+					uint32_t u_wedge = 0;
+					uint32_t v_wedge = 0;
+					bool has_v = false;
+					for (uint32_t wedge : triangle) {
+						if (position_id[wedge] == u) {
+							u_wedge = wedge;
+						}
+						else if (position_id[wedge] == v) {
+							v_wedge = wedge;
+							has_v = true;
+						}
+					}
+
+					if (has_v) {
+						++removed;
+						wedge_pairs.emplace_back(u_wedge, v_wedge);
+						continue;
+					}
+
+					// Reject collapses folding a triangle over or making it degenerate
+					Position p[3];
+					Position moved[3];
+					for (size_t corner = 0; corner < 3; ++corner) {
+						p[corner] = positions[triangle[corner]];
+						moved[corner] = position_id[triangle[corner]] == u ? positions[v] : p[corner];
+					}
+
+					Position before = cross(sub(p[1], p[0]), sub(p[2], p[0]));
+					Position after = cross(sub(moved[1], moved[0]), sub(moved[2], moved[0]));
+					double after_length = std::sqrt(dot(after, after));
+					double before_length = std::sqrt(dot(before, before));
+					if (after_length <= 1e-12 || dot(before, after) <= 0.25 * before_length * after_length) {
+						valid = false;
+					}
+				}
+
+				std::sort(wedge_pairs.begin(), wedge_pairs.end());
+				wedge_pairs.erase(std::unique(wedge_pairs.begin(), wedge_pairs.end()), wedge_pairs.end());
+				for (size_t i = 1; i < wedge_pairs.size() && valid; ++i) {
+					if (wedge_pairs[i].first == wedge_pairs[i - 1].first) {
+						valid = false;
+					}
+				}
+
+				for (uint32_t k = adjacency_offsets[u]; k < adjacency_offsets[u + 1] && valid; ++k) {
+					for (uint32_t wedge : triangles[adjacency[k]]) {
+						if (position_id[wedge] != u) {
+							continue;
+						}
+
+						auto it = std::lower_bound(wedge_pairs.begin(), wedge_pairs.end(), std::make_pair(wedge, 0u));
+						if (it == wedge_pairs.end() || it->first != wedge) {
+							valid = false;
+						}
+					}
+				}
+
+				if (!valid) {
+					continue;
+				}
+
+				for (const auto& pair : wedge_pairs) {
+					wedge_remap[pair.first] = pair.second;
+				}
+
+				for (size_t i = 0; i < quadrics[u].size(); ++i) {
+					quadrics[v][i] += quadrics[u][i];
+				}
+
+				// Neighbourhood is frozen for the rest of the pass so costs and flip checks stay valid
+				touched[v] = true;
+				for (uint32_t k = adjacency_offsets[u]; k < adjacency_offsets[u + 1]; ++k) {
+					for (uint32_t wedge : triangles[adjacency[k]]) {
+						touched[position_id[wedge]] = true;
+					}
+				}
+
+				max_cost = std::max(max_cost, collapse.cost);
+				remaining -= std::min(removed, remaining);
+				++collapsed;
+			}
+
+			if (collapsed == 0) {
+				break;
+			}
+
+			size_t kept = 0;
+			for (const auto& triangle : triangles) {
+				std::array<uint32_t, 3> remapped = { wedge_remap[triangle[0]], wedge_remap[triangle[1]], wedge_remap[triangle[2]] };
+
+				uint32_t a = position_id[remapped[0]];
+				uint32_t b = position_id[remapped[1]];
+				uint32_t c = position_id[remapped[2]];
+				if (a == b || b == c || a == c) {
+					continue;
+				}
+
+				triangles[kept++] = remapped;
+			}
+			triangles.resize(kept);
+			triangle_count = kept;
+		}
+
+		lod.indices.clear();
+		lod.indices.reserve(triangles.size() * 3);
+		for (const auto& triangle : triangles) {
+			lod.indices.insert(lod.indices.end(), triangle.begin(), triangle.end());
+		}
+		lod.error = static_cast<float>(std::sqrt(max_cost) * scale);
+
+		return lod;
+	}
+
+	size_t select_lod(const std::vector<float>& level_errors, float pixels_per_unit, float max_pixel_error, float hysteresis, size_t current_lod) {
+		if (level_errors.empty()) {
+			return 0;
+		}
+
+		size_t lod = std::min(current_lod, level_errors.size() - 1);
+
+		while (lod > 0 && level_errors[lod] * pixels_per_unit > max_pixel_error) {
+			--lod;
+		}
+
+		// Coarser levels must fit well under the threshold, so an object near the limit keeps its level
+		while (lod + 1 < level_errors.size() && level_errors[lod + 1] * pixels_per_unit <= max_pixel_error * (1.f - hysteresis)) {
+			++lod;
+		}
+
+		return lod;
+	}
+}
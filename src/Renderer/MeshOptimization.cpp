@@ -0,0 +1,325 @@
+#include <Renderer/MeshOptimization.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+namespace Nth {
+	float VertexCacheStatistics::acmr() const {
+		return triangle_count > 0 ? static_cast<float>(miss_count) / static_cast<float>(triangle_count) : 0.f;
+	}
+
+	float VertexCacheStatistics::atvr() const {
+		return vertex_count > 0 ? static_cast<float>(miss_count) / static_cast<float>(vertex_count) : 0.f;
+	}
+
+	VertexCacheStatistics& VertexCacheStatistics::operator+=(const VertexCacheStatistics& statistics) {
+		triangle_count += statistics.triangle_count;
+		vertex_count += statistics.vertex_count;
+		miss_count += statistics.miss_count;
+
+		return *this;
+	}
+
+	std::string VertexCacheStatistics::to_string() const {
+		std::stringstream stream;
+
+		stream << "VertexCacheStatistics(ACMR " << acmr() << ", ATVR " << atvr() << ")";
+
+		return stream.str();
+	}
+
+	MeshOptimizationReport& MeshOptimizationReport::operator+=(const MeshOptimizationReport& report) {
+		before += report.before;
+		after += report.after;
+
+		return *this;
+	}
+
+	std::string MeshOptimizationReport::to_string() const {
+		std::stringstream stream;
+
+		stream << "MeshOptimizationReport(ACMR " << before.acmr() << " -> " << after.acmr() << ", ATVR " << before.atvr() << " -> " << after.atvr() << ")";
+
+		return stream.str();
+	}
+
+	VertexCacheStatistics analyze_vertex_cache(const std::vector<uint32_t>& indices, size_t vertex_count, uint32_t cache_size) {
+		assert(indices.size() % 3 == 0);
+
+		VertexCacheStatistics statistics;
+		statistics.triangle_count = indices.size() / 3;
+
+		// Timestamp of the vertex entering the FIFO, it is still cached while fewer than cache_size misses happened since
+		std::vector<size_t> cached_at(vertex_count, std::numeric_limits<size_t>::max());
+		std::vector<bool> used(vertex_count, false);
+
+		for (uint32_t index : indices) {
+			assert(index < vertex_count);
+
+			if (!used[index]) {
+				used[index] = true;
+				++statistics.vertex_count;
+			}
+
+			if (cached_at[index] == std::numeric_limits<size_t>::max() || statistics.miss_count - cached_at[index] >= cache_size) {
+				cached_at[index] = statistics.miss_count;
+				++statistics.miss_count;
+			}
+		}
+
+		return statistics;
+	}
+
+	void optimize_vertex_cache(std::vector<uint32_t>& indices, size_t vertex_count) {
+		assert(indices.size() % 3 == 0);
+
+		constexpr int cache_size = 32;
+		const size_t triangle_count = indices.size() / 3;
+		if (triangle_count == 0) {
+			return;
+		}
+
+		// Triangles still to emit around each vertex, swap-removed as they are emitted
+		std::vector<uint32_t> adjacency_offsets(vertex_count + 1, 0);
+		for (uint32_t index : indices) {
+			++adjacency_offsets[index + 1];
+		}
+		for (size_t i = 0; i < vertex_count; ++i) {
+			adjacency_offsets[i + 1] += adjacency_offsets[i];
+		}
+
+		std::vector<uint32_t> adjacency(indices.size());
+		std::vector<uint32_t> live_count(vertex_count, 0);
+		for (size_t i = 0; i < indices.size(); ++i) {
+			uint32_t vertex = indices[i];
+			adjacency[adjacency_offsets[vertex] + live_count[vertex]++] = static_cast<uint32_t>(i / 3);
+		}
+
+		auto vertex_score = [&](int cache_position, uint32_t remaining) {
+			if (remaining == 0) {
+				return -1.f;
+			}
+
+			float score = 0.f;
+			if (cache_position >= 0) {
+				// Last triangle's vertices get a fixed score so the next triangle doesn't just reuse them
+				score = cache_position < 3 ? 0.75f : std::pow(1.f - static_cast<float>(cache_position - 3) / (cache_size - 3), 1.5f);
+			}
+
+			// Vertices with few triangles left are finished first
+			return score + 2.f * std::pow(static_cast<float>(remaining), -0.5f);
+		};
+
+		std::vector<int> cache_position(vertex_count, -1);
+		std::vector<float> scores(vertex_count);
+		for (size_t i = 0; i < vertex_count; ++i) {
+			scores[i] = vertex_score(-1, live_count[i]);
+		}
+
+		std::vector<float> triangle_scores(triangle_count);
+		for (size_t i = 0; i < triangle_count; ++i) {
+			triangle_scores[i] = scores[indices[3 * i]] + scores[indices[3 * i + 1]] + scores[indices[3 * i + 2]];
+		}
+
+		std::vector<bool> emitted(triangle_count, false);
+		std::vector<uint32_t> cache;
+		std::vector<uint32_t> next_cache;
+		std::vector<uint32_t> result;
+		result.reserve(indices.size());
+
+		size_t cursor = 0;
+		uint32_t best = static_cast<uint32_t>(std::max_element(triangle_scores.begin(), triangle_scores.end()) - triangle_scores.begin());
+
+		while (true) {
+			emitted[best] = true;
+
+			uint32_t triangle[3] = { indices[3 * best], indices[3 * best + 1], indices[3 * best + 2] };
+			result.insert(result.end(), triangle, triangle + 3);
+
+			for (uint32_t vertex : triangle) {
+				uint32_t begin = adjacency_offsets[vertex];
+				uint32_t end = begin + live_count[vertex];
+				for (uint32_t k = begin; k < end; ++k) {
+					if (adjacency[k] == best) {
+						std::swap(adjacency[k], adjacency[end - 1]);
+						--live_count[vertex];
+						break;
+					}
+				}
+			}
+
+			// LRU cache, the emitted triangle moves to the front
+			next_cache.assign(triangle, triangle + 3);
+			for (uint32_t vertex : cache) {
+				if (vertex != triangle[0] && vertex != triangle[1] && vertex != triangle[2]) {
+					next_cache.push_back(vertex);
+				}
+			}
+			std::swap(cache, next_cache);
+
+			// Evicted vertices lose their cache score too
+			for (size_t i = 0; i < cache.size(); ++i) {
+				uint32_t vertex = cache[i];
+				cache_position[vertex] = i < cache_size ? static_cast<int>(i) : -1;
+				scores[vertex] = vertex_score(cache_position[vertex], live_count[vertex]);
+			}
+
+			best = std::numeric_limits<uint32_t>::max();
+			float best_score = -std::numeric_limits<float>::infinity();
+			for (uint32_t vertex : cache) {
+				for (uint32_t k = adjacency_offsets[vertex]; k < adjacency_offsets[vertex] + live_count[vertex]; ++k) {
+					uint32_t candidate = adjacency[k];
+					float score = scores[indices[3 * candidate]] + scores[indices[3 * candidate + 1]] + scores[indices[3 * candidate + 2]];
+					triangle_scores[candidate] = score;
+
+					if (score > best_score) {
+						best_score = score;
+						best = candidate;
+					}
+				}
+			}
+
+			if (cache.size() > cache_size) {
+				cache.resize(cache_size);
+			}
+
+			// Nothing left around the cache, continue with the next triangle not yet emitted
+			if (best == std::numeric_limits<uint32_t>::max()) {
+				while (cursor < triangle_count && emitted[cursor]) {
+					++cursor;
+				}
+				if (cursor == triangle_count) {
+					break;
+				}
+
+				best = static_cast<uint32_t>(cursor);
+			}
+		}
+
+		indices = std::move(result);
+	}
+
+	void optimize_overdraw(std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices, float threshold) {
+		assert(indices.size() % 3 == 0);
+
+		constexpr uint32_t cache_size = 16;
+		const size_t triangle_count = indices.size() / 3;
+		if (triangle_count == 0) {
+			return;
+		}
+
+		// Cache misses of each triangle in the current order
+		std::vector<uint32_t> misses(triangle_count, 0);
+		{
+			std::vector<size_t> cached_at(vertices.size(), std::numeric_limits<size_t>::max());
+			size_t miss_count = 0;
+			for (size_t i = 0; i < indices.size(); ++i) {
+				uint32_t index = indices[i];
+				if (cached_at[index] == std::numeric_limits<size_t>::max() || miss_count - cached_at[index] >= cache_size) {
+					cached_at[index] = miss_count++;
+					++misses[i / 3];
+				}
+			}
+		}
+
+		Vector3f mesh_centroid{ 0.f, 0.f, 0.f };
+		float mesh_area = 0.f;
+
+		std::vector<Vector3f> centroids(triangle_count);
+		std::vector<Vector3f> normals(triangle_count);
+		std::vector<float> areas(triangle_count);
+		for (size_t i = 0; i < triangle_count; ++i) {
+			const Vector3f& a = vertices[indices[3 * i]].pos;
+			const Vector3f& b = vertices[indices[3 * i + 1]].pos;
+			const Vector3f& c = vertices[indices[3 * i + 2]].pos;
+
+			Vector3f ab = b - a;
+			Vector3f ac = c - a;
+			normals[i] = Vector3f{ ab.y * ac.z - ab.z * ac.y, ab.z * ac.x - ab.x * ac.z, ab.x * ac.y - ab.y * ac.x };
+			areas[i] = normals[i].length() * 0.5f;
+			centroids[i] = (a + b + c) * (1.f / 3.f);
+
+			mesh_centroid += centroids[i] * areas[i];
+			mesh_area += areas[i];
+		}
+		if (mesh_area > 0.f) {
+			mesh_centroid = mesh_centroid * (1.f / mesh_area);
+		}
+
+		VertexCacheStatistics original = analyze_vertex_cache(indices, vertices.size(), cache_size);
+
+		// Clusters start where the cache restarts anyway, a lower miss limit gives more clusters to sort
+		auto reorder = [&](uint32_t boundary_misses) {
+			std::vector<size_t> cluster_starts;
+			for (size_t i = 0; i < triangle_count; ++i) {
+				if (i == 0 || misses[i] >= boundary_misses) {
+					cluster_starts.push_back(i);
+				}
+			}
+			cluster_starts.push_back(triangle_count);
+
+			// Clusters facing away from the mesh center occlude the others, so they are drawn first
+			std::vector<std::pair<float, size_t>> keys;
+			for (size_t cluster = 0; cluster + 1 < cluster_starts.size(); ++cluster) {
+				Vector3f centroid{ 0.f, 0.f, 0.f };
+				Vector3f normal{ 0.f, 0.f, 0.f };
+				float area = 0.f;
+				for (size_t i = cluster_starts[cluster]; i < cluster_starts[cluster + 1]; ++i) {
+					centroid += centroids[i] * areas[i];
+					normal += normals[i];
+					area += areas[i];
+				}
+
+				float key = 0.f;
+				float normal_length = normal.length();
+				if (area > 0.f && normal_length > 0.f) {
+					Vector3f offset = centroid * (1.f / area) - mesh_centroid;
+					key = offset.dot_product(normal) / normal_length;
+				}
+
+				keys.emplace_back(-key, cluster);
+			}
+			std::stable_sort(keys.begin(), keys.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+			std::vector<uint32_t> result;
+			result.reserve(indices.size());
+			for (const auto& key : keys) {
+				result.insert(result.end(), indices.begin() + 3 * cluster_starts[key.second], indices.begin() + 3 * cluster_starts[key.second + 1]);
+			}
+
+			return result;
+		};
+
+		for (uint32_t boundary_misses : { 2u, 3u }) {
+			std::vector<uint32_t> result = reorder(boundary_misses);
+			if (analyze_vertex_cache(result, vertices.size(), cache_size).acmr() <= original.acmr() * threshold) {
+				indices = std::move(result);
+				return;
+			}
+		}
+	}
+
+	std::vector<uint32_t> optimize_vertex_fetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices) {
+		const uint32_t unused = std::numeric_limits<uint32_t>::max();
+
+		std::vector<uint32_t> remap(vertices.size(), unused);
+		std::vector<Vertex> reordered;
+		reordered.reserve(vertices.size());
+
+		for (uint32_t& index : indices) {
+			if (remap[index] == unused) {
+				remap[index] = static_cast<uint32_t>(reordered.size());
+				reordered.push_back(vertices[index]);
+			}
+
+			index = remap[index];
+		}
+
+		vertices = std::move(reordered);
+
+		return remap;
+	}
+}
@@ -0,0 +1,170 @@
+#include <Renderer/Meshlet.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace Nth {
+	std::vector<Meshlet> build_meshlets(const std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, uint32_t max_vertices, uint32_t max_triangles) {
+		assert(indices.size() % 3 == 0);
+		assert(max_vertices >= 3 && max_triangles >= 1);
+
+		const uint32_t invalid = std::numeric_limits<uint32_t>::max();
+		const size_t triangle_count = indices.size() / 3;
+
+		std::vector<uint32_t> adjacency_offsets(vertices.size() + 1, 0);
+		for (uint32_t index : indices) {
+			++adjacency_offsets[index + 1];
+		}
+		for (size_t i = 0; i < vertices.size(); ++i) {
+			adjacency_offsets[i + 1] += adjacency_offsets[i];
+		}
+
+		std::vector<uint32_t> adjacency(indices.size());
+		{
+			std::vector<uint32_t> cursor(adjacency_offsets.begin(), adjacency_offsets.end() - 1);
+			for (size_t i = 0; i < indices.size(); ++i) {
+				adjacency[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+			}
+		}
+
+		std::vector<bool> emitted(triangle_count, false);
+		std::vector<bool> in_meshlet(vertices.size(), false);
+		std::vector<uint32_t> meshlet_vertices;
+		std::vector<uint32_t> meshlet_triangles;
+
+		std::vector<uint32_t> reordered;
+		reordered.reserve(indices.size());
+		std::vector<Meshlet> meshlets;
+
+		auto new_vertex_count = [&](uint32_t triangle) {
+			uint32_t count = 0;
+			for (size_t corner = 0; corner < 3; ++corner) {
+				count += in_meshlet[indices[3 * triangle + corner]] ? 0 : 1;
+			}
+			return count;
+		};
+
+		auto flush = [&]() {
+			if (meshlet_triangles.empty()) {
+				return;
+			}
+
+			Meshlet meshlet;
+			meshlet.first_index = static_cast<uint32_t>(reordered.size());
+			meshlet.index_count = static_cast<uint32_t>(meshlet_triangles.size() * 3);
+
+			for (uint32_t vertex : meshlet_vertices) {
+				meshlet.bounds.extend(vertices[vertex].pos);
+			}
+
+			meshlet.center = meshlet.bounds.center();
+			meshlet.radius = 0.f;
+			for (uint32_t vertex : meshlet_vertices) {
+				meshlet.radius = std::max(meshlet.radius, (vertices[vertex].pos - meshlet.center).length());
+			}
+
+			// Cone around the average face normal, its cutoff is the sine of the widest angle to it
+			std::vector<Vector3f> normals;
+			Vector3f axis{ 0.f, 0.f, 0.f };
+			for (uint32_t triangle : meshlet_triangles) {
+				const Vector3f& a = vertices[indices[3 * triangle + 0]].pos;
+				const Vector3f& b = vertices[indices[3 * triangle + 1]].pos;
+				const Vector3f& c = vertices[indices[3 * triangle + 2]].pos;
+				reordered.insert(reordered.end(), { indices[3 * triangle + 0], indices[3 * triangle + 1], indices[3 * triangle + 2] });
+
+				Vector3f ab = b - a;
+				Vector3f ac = c - a;
+				Vector3f normal{ ab.y * ac.z - ab.z * ac.y, ab.z * ac.x - ab.x * ac.z, ab.x * ac.y - ab.y * ac.x };
+				float length = normal.length();
+				if (length <= 0.f) {
+					continue;
+				}
+
+				normal = Vector3f{ normal.x / length, normal.y / length, normal.z / length };
+				normals.push_back(normal);
+				axis += normal;
+			}
+
+			float axis_length = axis.length();
+			float min_dot = 1.f;
+			if (axis_length > 0.f) {
+				axis = Vector3f{ axis.x / axis_length, axis.y / axis_length, axis.z / axis_length };
+				for (const Vector3f& normal : normals) {
+					min_dot = std::min(min_dot, normal.dot_product(axis));
+				}
+			}
+			else {
+				axis = Vector3f{ 0.f, 0.f, 1.f };
+				min_dot = -1.f;
+			}
+
+			meshlet.cone_axis = axis;
+			meshlet.cone_cutoff = min_dot <= 0.f ? 1.f : std::sqrt(1.f - min_dot * min_dot);
+
+			meshlets.push_back(meshlet);
+
+			for (uint32_t vertex : meshlet_vertices) {
+				in_meshlet[vertex] = false;
+			}
+			meshlet_vertices.clear();
+			meshlet_triangles.clear();
+		};
+
+		size_t seed = 0;
+		while (true) {
+			// Prefer triangles adding the fewest vertices to the current meshlet
+			uint32_t best = invalid;
+			uint32_t best_count = 4;
+			for (uint32_t vertex : meshlet_vertices) {
+				for (uint32_t k = adjacency_offsets[vertex]; k < adjacency_offsets[vertex + 1] && best_count > 0; ++k) {
+					uint32_t triangle = adjacency[k];
+					if (emitted[triangle]) {
+						continue;
+					}
+
+					uint32_t count = new_vertex_count(triangle);
+					if (count < best_count) {
+						best = triangle;
+						best_count = count;
+					}
+				}
+			}
+
+			// Nothing connected left, the next meshlet starts from the first unused triangle
+			if (best == invalid) {
+				flush();
+
+				while (seed < triangle_count && emitted[seed]) {
+					++seed;
+				}
+				if (seed == triangle_count) {
+					break;
+				}
+
+				best = static_cast<uint32_t>(seed);
+			}
+
+			if (meshlet_vertices.size() + new_vertex_count(best) > max_vertices || meshlet_triangles.size() + 1 > max_triangles) {
+				flush();
+			}
+
+			emitted[best] = true;
+			meshlet_triangles.push_back(best);
+			for (size_t corner = 0; corner < 3; ++corner) {
+				uint32_t vertex = indices[3 * best + corner];
+				if (!in_meshlet[vertex]) {
+					in_meshlet[vertex] = true;
+					meshlet_vertices.push_back(vertex);
+				}
+			}
+		}
+
+		flush();
+
+		indices = std::move(reordered);
+
+		return meshlets;
+	}
+}
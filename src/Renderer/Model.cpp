@@ -1,8 +1,10 @@
 #include <Renderer/Model.hpp>
 
+#include <Renderer/AssetIOSystem.hpp>
 #include <Renderer/Mesh.hpp>
 
 #include <Utils/Image.hpp>
+#include <Utils/ReadPool.hpp>
 
 #include <Maths/AssimpConvertion.hpp>
 
@@ -11,6 +13,7 @@
 
 #include <stdexcept>
 #include <iostream>
+#include <utility>
 
 namespace Nth {
 	void Model::add_mesh(Mesh&& mesh) {
@@ -18,60 +21,159 @@ namespace Nth {
 	}
 	
 	size_t Model::add_texture(Texture&& texture) {
-		for (size_t i = 0; i < m_textures_loaded.size(); ++i) {
-			if (m_textures_loaded[i].path == texture.path) {
-				return i;
+		auto [it, inserted] = m_texture_indices.try_emplace(texture.path.generic_string(), m_textures_loaded.size());
+		if (inserted) {
+			m_textures_loaded.push_back(std::move(texture));
+		}
+
+		return it->second;
+	}
+
+	void Model::generate_lods(size_t count, float reduction) {
+		for (Mesh& mesh : meshes) {
+			mesh.generate_lods(count, reduction);
+		}
+	}
+
+	MeshOptimizationReport Model::optimize() {
+		// Checked first so a failure leaves every mesh as it was
+		for (const Mesh& mesh : meshes) {
+			if (!mesh.meshlets.empty()) {
+				throw std::runtime_error("Can't optimize a model once its meshlets are built");
 			}
 		}
-		
-		m_textures_loaded.push_back(std::move(texture));
-		return m_textures_loaded.size() - 1;
+
+		MeshOptimizationReport report;
+		for (Mesh& mesh : meshes) {
+			report += mesh.optimize();
+		}
+
+		return report;
 	}
 
 	const std::vector<Texture>& Model::textures() const {
 		return m_textures_loaded;
 	}
 
-	Model Model::LoadFromFile(const std::filesystem::path& path) {
+	Model Model::LoadFromFile(const std::filesystem::path& path, ReadPool& pool, const ImportOptions& options) {
+		unsigned int flags = aiProcess_Triangulate | aiProcess_FlipUVs;
+		if (options.weld_vertices) {
+			flags |= aiProcess_JoinIdenticalVertices;
+		}
+
+		// The importer owns its IO handler, which reads the model and its buffers from the mounted archives or the disk
 		Assimp::Importer import;
-		const aiScene* scene = import.ReadFile(path.string().c_str(), aiProcess_Triangulate | aiProcess_FlipUVs);
+		import.SetIOHandler(new AssetIOSystem);
+		const aiScene* scene = import.ReadFile(path.string().c_str(), flags);
 
 		if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
 			throw std::runtime_error("ASSIMP::" + std::string{ import.GetErrorString() });
 		}
 
-		return Model{ path.parent_path(), scene };
+		return Model{ path.parent_path(), scene, pool, options };
 	}
 
-	Model::Model(const std::filesystem::path& directory, const aiScene* scene) :
-		m_directory(directory) {
-		process_node(scene->mRootNode, scene, aiMatrix4x4{});
+	Model::Model(const std::filesystem::path& directory, const aiScene* scene, ReadPool& pool, const ImportOptions& options) :
+		m_directory(directory),
+		m_options(options),
+		m_mesh_indices(scene->mNumMeshes, Model::unloaded_mesh) {
+		std::vector<MeshJob> jobs;
+		collect_node(scene->mRootNode, scene, aiMatrix4x4{}, ModelNode::no_parent, jobs);
+
+		// Textures first as they take the longest, every job fills its own slot so the result doesn't depend on threads
+		size_t texture_count = m_textures_loaded.size();
+		meshes.resize(jobs.size());
+
+		// The first failure in job order is rethrown, so the error doesn't depend on threads either
+		pool.run_batch(texture_count + jobs.size(), [&](size_t job) {
+			if (job < texture_count) {
+				decode_texture(job);
+			}
+			else {
+				MeshJob& mesh_job = jobs[job - texture_count];
+				meshes[job - texture_count] = process_mesh(mesh_job.mesh, mesh_job.transformation, std::move(mesh_job.textures));
+			}
+		});
 	}
 
-	void Model::process_node(aiNode* node, const aiScene* scene, const aiMatrix4x4& parent_transformation) {
-		aiMatrix4x4 current_transformation = node->mTransformation * parent_transformation;
-		
+	void Model::collect_node(const aiNode* node, const aiScene* scene, const aiMatrix4x4& parent_transformation, uint32_t parent_index, std::vector<MeshJob>& jobs) {
+		// Assimp transforms column vectors, the parent applies last
+		aiMatrix4x4 current_transformation = parent_transformation * node->mTransformation;
+
+		// Baked meshes are copied for every node using them, otherwise each is loaded once in its own space
+		bool bake = !m_options.keep_hierarchy && !m_options.instance_meshes;
+
+		uint32_t node_index = parent_index;
+		if (m_options.keep_hierarchy) {
+			aiVector3D scaling;
+			aiQuaternion rotation;
+			aiVector3D position;
+			node->mTransformation.Decompose(scaling, rotation, position);
+
+			node_index = static_cast<uint32_t>(nodes.size());
+			nodes.push_back(ModelNode{
+				node->mName.C_Str(),
+				parent_index,
+				to_vector3(position),
+				Vector4f{ rotation.x, rotation.y, rotation.z, rotation.w },
+				to_vector3(scaling),
+				{}
+			});
+		}
+
+		auto material_textures = [&](const aiMesh* mesh) {
+			std::vector<size_t> textures;
+			const aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
+
+			for (auto [type, type_name] : { std::pair{ aiTextureType_DIFFUSE, "texture_diffuse" }, std::pair{ aiTextureType_SPECULAR, "texture_specular" }, std::pair{ aiTextureType_BASE_COLOR, "base_color" } }) {
+				std::vector<size_t> maps = collect_material_textures(material, type, type_name);
+				textures.insert(textures.end(), maps.begin(), maps.end());
+			}
+
+			return textures;
+		};
+
 		for (unsigned int i = 0; i < node->mNumMeshes; ++i) {
-			aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-			meshes.push_back(process_mesh(mesh, scene, current_transformation));
+			const aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
+			if (bake) {
+				jobs.push_back(MeshJob{ mesh, current_transformation, material_textures(mesh) });
+				continue;
+			}
+
+			size_t& mesh_index = m_mesh_indices[node->mMeshes[i]];
+			if (mesh_index == Model::unloaded_mesh) {
+				mesh_index = jobs.size();
+				jobs.push_back(MeshJob{ mesh, aiMatrix4x4{}, material_textures(mesh) });
+			}
+
+			if (m_options.keep_hierarchy) {
+				nodes[node_index].meshes.push_back(mesh_index);
+			}
+
+			instances.push_back(ModelInstance{ mesh_index, to_matrix4(current_transformation) });
 		}
 
 		// then do the same for each of its children
 		for (unsigned int i = 0; i < node->mNumChildren; ++i) {
-			process_node(node->mChildren[i], scene, current_transformation);
+			collect_node(node->mChildren[i], scene, current_transformation, node_index, jobs);
 		}
 	}
 
-	Mesh Model::process_mesh(aiMesh* mesh, const aiScene* scene, const aiMatrix4x4& transformation) {
+	Mesh Model::process_mesh(const aiMesh* mesh, const aiMatrix4x4& transformation, std::vector<size_t> textures) const {
 		std::vector<Vertex> vertices;
 		std::vector<uint32_t> indices;
-		std::vector<size_t> textures;
+		vertices.reserve(mesh->mNumVertices);
+		indices.reserve(mesh->mNumFaces * 3);
+
+		// Normals follow the inverse transpose, a non uniform scale would skew them otherwise
+		aiMatrix3x3 normal_transformation{ transformation };
+		normal_transformation.Inverse().Transpose();
 
 		for (unsigned int i = 0; i < mesh->mNumVertices; ++i) {
 			Vertex vertex;
 			// process vertex positions, normals and texture coordinates
 			vertex.pos = to_vector3(transformation * mesh->mVertices[i]);
-			vertex.normal = to_vector3(transformation * mesh->mNormals[i]);
+			vertex.normal = to_vector3((normal_transformation * mesh->mNormals[i]).Normalize());
 
 			if (mesh->mTextureCoords[0]) { // does the mesh contain texture coordinates?
 				vertex.texture_pos = { mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y };
@@ -84,53 +186,42 @@ namespace Nth {
 		}
 		// process indices
 		for (unsigned int i = 0; i < mesh->mNumFaces; ++i) {
-			aiFace face = mesh->mFaces[i];
+			const aiFace& face = mesh->mFaces[i];
 			for (unsigned int j = 0; j < face.mNumIndices; ++j) {
 				indices.push_back(face.mIndices[j]);
 			}
 		}
-		// process material
-		if (mesh->mMaterialIndex >= 0) {
-			aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
-
-			std::vector<size_t> diffuse_maps = load_material_textures(material, aiTextureType_DIFFUSE, "texture_diffuse");
-			textures.insert(textures.end(), diffuse_maps.begin(), diffuse_maps.end());
 
-			std::vector<size_t> specular_maps = load_material_textures(material, aiTextureType_SPECULAR, "texture_specular");
-			textures.insert(textures.end(), specular_maps.begin(), specular_maps.end());
+		Mesh processed_mesh(std::move(vertices), std::move(indices), std::move(textures));
+		processed_mesh.prepare(m_options);
 
-			std::vector<size_t> base_colors = load_material_textures(material, aiTextureType_BASE_COLOR, "base_color");
-			textures.insert(textures.end(), base_colors.begin(), base_colors.end());
-		}
-
-		return Mesh(vertices, indices, textures);
+		return processed_mesh;
 	}
 
-	std::vector<size_t> Model::load_material_textures(aiMaterial* mat, aiTextureType type, std::string_view type_name) {
+	std::vector<size_t> Model::collect_material_textures(const aiMaterial* mat, aiTextureType type, std::string_view type_name) {
 		std::vector<size_t> textures_index;
 		for (unsigned int i = 0; i < mat->GetTextureCount(type); i++) {
 			aiString str;
 			mat->GetTexture(type, i, &str);
 
-			bool skip = false;
-			for (size_t j = 0; j < m_textures_loaded.size(); ++j) {
-				if (m_textures_loaded[j].path == str.C_Str()) {
-					skip = true;
-					textures_index.push_back(i);
-					break;
-				}
-			}
-			
-			if (!skip) {
-				Texture texture = texture_from_file(m_directory / std::string{ str.C_Str() });
-				texture.type = type_name;
-				texture.path = str.C_Str();
-				m_textures_loaded.push_back(std::move(texture));
-
-				textures_index.push_back(m_textures_loaded.size() - 1);
-			}
+			Texture texture;
+			texture.type = type_name;
+			texture.path = str.C_Str();
+			texture.width = 0;
+			texture.height = 0;
+			textures_index.push_back(add_texture(std::move(texture)));
 		}
 
 		return textures_index;
 	}
-}
\ No newline at end of file
+
+	void Model::decode_texture(size_t index) {
+		Texture& texture = m_textures_loaded[index];
+		Texture decoded = texture_from_file(m_directory / texture.path);
+
+		texture.data = std::move(decoded.data);
+		texture.width = decoded.width;
+		texture.height = decoded.height;
+		texture.content_hash = decoded.content_hash;
+	}
+}
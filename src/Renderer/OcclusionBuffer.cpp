@@ -0,0 +1,303 @@
+#include <Renderer/OcclusionBuffer.hpp>
+
+#include <Maths/Vector4.hpp>
+
+#include <Utils/ReadPool.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NTH_OCCLUSION_SSE
+#include <emmintrin.h>
+#endif
+
+namespace Nth {
+	OcclusionBuffer::OcclusionBuffer() :
+		m_width(0),
+		m_height(0),
+		m_tile_count_x(0),
+		m_tile_count_y(0),
+		m_view_projection(Matrix4f::Identity()) { }
+
+	void OcclusionBuffer::resize(uint32_t width, uint32_t height) {
+		uint32_t tile_count_x = std::max((width + tile_width - 1) / tile_width, 1u);
+		uint32_t tile_count_y = std::max((height + tile_height - 1) / tile_height, 1u);
+		if (tile_count_x == m_tile_count_x && tile_count_y == m_tile_count_y) {
+			return;
+		}
+
+		m_tile_count_x = tile_count_x;
+		m_tile_count_y = tile_count_y;
+		m_width = m_tile_count_x * tile_width;
+		m_height = m_tile_count_y * tile_height;
+
+		m_depth.assign(static_cast<size_t>(m_width) * m_height, 1.f);
+		m_tile_max_depth.assign(static_cast<size_t>(m_tile_count_x) * m_tile_count_y, 1.f);
+		m_bins.resize(m_tile_max_depth.size());
+	}
+
+	void OcclusionBuffer::begin(const Matrix4f& view_projection) {
+		m_view_projection = view_projection;
+
+		std::fill(m_depth.begin(), m_depth.end(), 1.f);
+		std::fill(m_tile_max_depth.begin(), m_tile_max_depth.end(), 1.f);
+
+		m_triangles.clear();
+		for (auto& bin : m_bins) {
+			bin.clear();
+		}
+	}
+
+	void OcclusionBuffer::add_occluder(const std::vector<Vector3f>& vertices, const std::vector<uint32_t>& indices, const Matrix4f& transform) {
+		assert(indices.size() % 3 == 0);
+
+		Matrix4f mvp = m_view_projection * transform;
+
+		// Screen space positions, w set to 0 for vertices that are not in front of the near plane
+		std::vector<Vector4f> positions(vertices.size());
+		for (size_t i = 0; i < vertices.size(); ++i) {
+			Vector4f clip = Vector4f{ vertices[i].x, vertices[i].y, vertices[i].z, 1.f } * mvp;
+			if (clip.w <= 0.f || clip.z < 0.f) {
+				positions[i] = Vector4f{ 0.f, 0.f, 0.f, 0.f };
+				continue;
+			}
+
+			positions[i] = Vector4f{
+				(clip.x / clip.w * 0.5f + 0.5f) * static_cast<float>(m_width),
+				(clip.y / clip.w * 0.5f + 0.5f) * static_cast<float>(m_height),
+				clip.z / clip.w,
+				1.f
+			};
+		}
+
+		for (size_t i = 0; i < indices.size(); i += 3) {
+			const Vector4f* v[3] = { &positions[indices[i]], &positions[indices[i + 1]], &positions[indices[i + 2]] };
+
+			// Triangles crossing the near plane are dropped, an occluder may only miss coverage
+			if (v[0]->w == 0.f || v[1]->w == 0.f || v[2]->w == 0.f) {
+				continue;
+			}
+
+			float area = (v[1]->x - v[0]->x) * (v[2]->y - v[0]->y) - (v[2]->x - v[0]->x) * (v[1]->y - v[0]->y);
+			if (std::abs(area) < 1e-6f) {
+				continue;
+			}
+
+			float min_x = std::max(std::floor(std::min({ v[0]->x, v[1]->x, v[2]->x })), 0.f);
+			float min_y = std::max(std::floor(std::min({ v[0]->y, v[1]->y, v[2]->y })), 0.f);
+			float max_x = std::min(std::ceil(std::max({ v[0]->x, v[1]->x, v[2]->x })), static_cast<float>(m_width));
+			float max_y = std::min(std::ceil(std::max({ v[0]->y, v[1]->y, v[2]->y })), static_cast<float>(m_height));
+			if (min_x >= max_x || min_y >= max_y) {
+				continue;
+			}
+
+			ScreenTriangle triangle;
+
+			// Edge k is opposite to vertex k, its function is the barycentric weight of k scaled by area
+			float orientation = area > 0.f ? 1.f : -1.f;
+			for (int k = 0; k < 3; ++k) {
+				const Vector4f& p0 = *v[(k + 1) % 3];
+				const Vector4f& p1 = *v[(k + 2) % 3];
+
+				triangle.edge_a[k] = (p0.y - p1.y) * orientation;
+				triangle.edge_b[k] = (p1.x - p0.x) * orientation;
+				triangle.edge_c[k] = (p0.x * p1.y - p1.x * p0.y) * orientation;
+			}
+
+			float inv_area = orientation / area;
+			triangle.depth_a = (triangle.edge_a[0] * v[0]->z + triangle.edge_a[1] * v[1]->z + triangle.edge_a[2] * v[2]->z) * inv_area;
+			triangle.depth_b = (triangle.edge_b[0] * v[0]->z + triangle.edge_b[1] * v[1]->z + triangle.edge_b[2] * v[2]->z) * inv_area;
+			triangle.depth_c = (triangle.edge_c[0] * v[0]->z + triangle.edge_c[1] * v[1]->z + triangle.edge_c[2] * v[2]->z) * inv_area;
+
+			triangle.min_x = static_cast<uint32_t>(min_x);
+			triangle.min_y = static_cast<uint32_t>(min_y);
+			triangle.max_x = static_cast<uint32_t>(max_x);
+			triangle.max_y = static_cast<uint32_t>(max_y);
+
+			uint32_t triangle_index = static_cast<uint32_t>(m_triangles.size());
+			m_triangles.push_back(triangle);
+
+			for (uint32_t tile_y = triangle.min_y / tile_height; tile_y <= (triangle.max_y - 1) / tile_height; ++tile_y) {
+				for (uint32_t tile_x = triangle.min_x / tile_width; tile_x <= (triangle.max_x - 1) / tile_width; ++tile_x) {
+					m_bins[tile_y * m_tile_count_x + tile_x].push_back(triangle_index);
+				}
+			}
+		}
+	}
+
+	void OcclusionBuffer::rasterize(ReadPool* pool) {
+		uint32_t tile_count = m_tile_count_x * m_tile_count_y;
+
+		// Tiles don't share pixels, each thread takes the next free one
+		if (pool) {
+			pool->run_batch(tile_count, [this](size_t tile) { rasterize_tile(static_cast<uint32_t>(tile)); });
+			return;
+		}
+
+		for (uint32_t tile = 0; tile < tile_count; ++tile) {
+			rasterize_tile(tile);
+		}
+	}
+
+	bool OcclusionBuffer::is_visible(const BoundingBoxf& bounds, const Matrix4f& transform) const {
+		Matrix4f mvp = m_view_projection * transform;
+
+		Vector3f ndc_min{ std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+		Vector3f ndc_max{ std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+		for (int i = 0; i < 8; ++i) {
+			Vector4f corner{
+				(i & 1) ? bounds.max.x : bounds.min.x,
+				(i & 2) ? bounds.max.y : bounds.min.y,
+				(i & 4) ? bounds.max.z : bounds.min.z,
+				1.f
+			};
+			Vector4f clip = corner * mvp;
+
+			// Box crosses the near plane, its projection is unbounded
+			if (clip.w <= 0.f || clip.z < 0.f) {
+				return true;
+			}
+
+			Vector3f ndc{ clip.x / clip.w, clip.y / clip.w, clip.z / clip.w };
+			ndc_min = Vector3f{ std::min(ndc_min.x, ndc.x), std::min(ndc_min.y, ndc.y), std::min(ndc_min.z, ndc.z) };
+			ndc_max = Vector3f{ std::max(ndc_max.x, ndc.x), std::max(ndc_max.y, ndc.y), std::max(ndc_max.z, ndc.z) };
+		}
+
+		if (ndc_max.x < -1.f || ndc_min.x > 1.f || ndc_max.y < -1.f || ndc_min.y > 1.f || ndc_min.z > 1.f) {
+			return false;
+		}
+
+		uint32_t begin_x = static_cast<uint32_t>(std::clamp(std::floor((ndc_min.x * 0.5f + 0.5f) * m_width), 0.f, static_cast<float>(m_width - 1)));
+		uint32_t begin_y = static_cast<uint32_t>(std::clamp(std::floor((ndc_min.y * 0.5f + 0.5f) * m_height), 0.f, static_cast<float>(m_height - 1)));
+		uint32_t end_x = static_cast<uint32_t>(std::clamp(std::ceil((ndc_max.x * 0.5f + 0.5f) * m_width), static_cast<float>(begin_x + 1), static_cast<float>(m_width)));
+		uint32_t end_y = static_cast<uint32_t>(std::clamp(std::ceil((ndc_max.y * 0.5f + 0.5f) * m_height), static_cast<float>(begin_y + 1), static_cast<float>(m_height)));
+
+		float box_depth = ndc_min.z;
+
+		for (uint32_t tile_y = begin_y / tile_height; tile_y <= (end_y - 1) / tile_height; ++tile_y) {
+			for (uint32_t tile_x = begin_x / tile_width; tile_x <= (end_x - 1) / tile_width; ++tile_x) {
+				// Whole tile is in front of the box
+				if (box_depth > m_tile_max_depth[tile_y * m_tile_count_x + tile_x]) {
+					continue;
+				}
+
+				uint32_t y_end = std::min(end_y, (tile_y + 1) * tile_height);
+				uint32_t x_end = std::min(end_x, (tile_x + 1) * tile_width);
+				for (uint32_t y = std::max(begin_y, tile_y * tile_height); y < y_end; ++y) {
+					for (uint32_t x = std::max(begin_x, tile_x * tile_width); x < x_end; ++x) {
+						if (box_depth <= m_depth[y * m_width + x]) {
+							return true;
+						}
+					}
+				}
+			}
+		}
+
+		return false;
+	}
+
+	float OcclusionBuffer::depth(uint32_t x, uint32_t y) const {
+		assert(x < m_width && y < m_height);
+
+		return m_depth[y * m_width + x];
+	}
+
+	uint32_t OcclusionBuffer::width() const {
+		return m_width;
+	}
+
+	uint32_t OcclusionBuffer::height() const {
+		return m_height;
+	}
+
+	void OcclusionBuffer::rasterize_tile(uint32_t tile_index) {
+		uint32_t tile_x = tile_index % m_tile_count_x;
+		uint32_t tile_y = tile_index / m_tile_count_x;
+
+		uint32_t begin_x = tile_x * tile_width;
+		uint32_t begin_y = tile_y * tile_height;
+		uint32_t end_x = begin_x + tile_width;
+		uint32_t end_y = begin_y + tile_height;
+
+		for (uint32_t triangle_index : m_bins[tile_index]) {
+			const ScreenTriangle& triangle = m_triangles[triangle_index];
+
+			rasterize_triangle(
+				triangle,
+				std::max(begin_x, triangle.min_x),
+				std::max(begin_y, triangle.min_y),
+				std::min(end_x, triangle.max_x),
+				std::min(end_y, triangle.max_y)
+			);
+		}
+
+		float max_depth = 0.f;
+		for (uint32_t y = begin_y; y < end_y; ++y) {
+			for (uint32_t x = begin_x; x < end_x; ++x) {
+				max_depth = std::max(max_depth, m_depth[y * m_width + x]);
+			}
+		}
+		m_tile_max_depth[tile_index] = max_depth;
+	}
+
+	void OcclusionBuffer::rasterize_triangle(const ScreenTriangle& triangle, uint32_t begin_x, uint32_t begin_y, uint32_t end_x, uint32_t end_y) {
+#ifdef NTH_OCCLUSION_SSE
+		// Tiles are multiple of 4 pixels wide, pixels outside the triangle fail the edge tests
+		begin_x &= ~3u;
+
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+		const __m128 edge_a0 = _mm_set1_ps(triangle.edge_a[0]);
+		const __m128 edge_a1 = _mm_set1_ps(triangle.edge_a[1]);
+		const __m128 edge_a2 = _mm_set1_ps(triangle.edge_a[2]);
+		const __m128 depth_a = _mm_set1_ps(triangle.depth_a);
+
+		for (uint32_t y = begin_y; y < end_y; ++y) {
+			float py = static_cast<float>(y) + 0.5f;
+			const __m128 row0 = _mm_set1_ps(triangle.edge_b[0] * py + triangle.edge_c[0]);
+			const __m128 row1 = _mm_set1_ps(triangle.edge_b[1] * py + triangle.edge_c[1]);
+			const __m128 row2 = _mm_set1_ps(triangle.edge_b[2] * py + triangle.edge_c[2]);
+			const __m128 row_depth = _mm_set1_ps(triangle.depth_b * py + triangle.depth_c);
+
+			float* row = &m_depth[y * m_width];
+			for (uint32_t x = begin_x; x < end_x; x += 4) {
+				__m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), offsets);
+
+				__m128 inside = _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edge_a0, px), row0), zero);
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edge_a1, px), row1), zero));
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edge_a2, px), row2), zero));
+				if (_mm_movemask_ps(inside) == 0) {
+					continue;
+				}
+
+				__m128 depth = _mm_add_ps(_mm_mul_ps(depth_a, px), row_depth);
+				__m128 previous = _mm_loadu_ps(row + x);
+				__m128 nearest = _mm_min_ps(previous, depth);
+
+				_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, previous)));
+			}
+		}
+#else
+		for (uint32_t y = begin_y; y < end_y; ++y) {
+			float py = static_cast<float>(y) + 0.5f;
+
+			float* row = &m_depth[y * m_width];
+			for (uint32_t x = begin_x; x < end_x; ++x) {
+				float px = static_cast<float>(x) + 0.5f;
+
+				bool inside = true;
+				for (int k = 0; k < 3; ++k) {
+					inside = inside && (triangle.edge_a[k] * px + triangle.edge_b[k] * py + triangle.edge_c[k] >= 0.f);
+				}
+
+				if (inside) {
+					row[x] = std::min(row[x], triangle.depth_a * px + triangle.depth_b * py + triangle.depth_c);
+				}
+			}
+		}
+#endif
+	}
+}
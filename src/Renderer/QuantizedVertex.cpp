@@ -0,0 +1,163 @@
+#include <Renderer/QuantizedVertex.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace Nth {
+	static_assert(sizeof(QuantizedVertex) == 16, "QuantizedVertex must match its vertex input description");
+
+	VertexInputDescription QuantizedVertex::get_vertex_description() {
+		VertexInputDescription description;
+
+		VkVertexInputBindingDescription mainBinding = {};
+		mainBinding.binding = 0;
+		mainBinding.stride = sizeof(QuantizedVertex);
+		mainBinding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+		description.bindings.push_back(mainBinding);
+
+		VkVertexInputAttributeDescription positionAttribute = {};
+		positionAttribute.binding = 0;
+		positionAttribute.location = 0;
+		positionAttribute.format = VK_FORMAT_R16G16B16A16_UNORM;
+		positionAttribute.offset = offsetof(QuantizedVertex, pos);
+
+		VkVertexInputAttributeDescription textureAttribute = {};
+		textureAttribute.binding = 0;
+		textureAttribute.location = 1;
+		textureAttribute.format = VK_FORMAT_R16G16_SFLOAT;
+		textureAttribute.offset = offsetof(QuantizedVertex, texture_pos);
+
+		VkVertexInputAttributeDescription normalAttribute = {};
+		normalAttribute.binding = 0;
+		normalAttribute.location = 2;
+		normalAttribute.format = VK_FORMAT_R8G8_SNORM;
+		normalAttribute.offset = offsetof(QuantizedVertex, normal);
+
+		description.attributes.push_back(positionAttribute);
+		description.attributes.push_back(textureAttribute);
+		description.attributes.push_back(normalAttribute);
+
+		return description;
+	}
+
+	QuantizedVertex quantize_vertex(const Vertex& vertex, const BoundingBoxf& bounds) {
+		QuantizedVertex quantized{};
+
+		auto quantize_unorm = [](float value, float min, float max) {
+			float normalized = (max > min) ? (value - min) / (max - min) : 0.f;
+			return static_cast<uint16_t>(std::lround(std::clamp(normalized, 0.f, 1.f) * 65535.f));
+		};
+
+		quantized.pos[0] = quantize_unorm(vertex.pos.x, bounds.min.x, bounds.max.x);
+		quantized.pos[1] = quantize_unorm(vertex.pos.y, bounds.min.y, bounds.max.y);
+		quantized.pos[2] = quantize_unorm(vertex.pos.z, bounds.min.z, bounds.max.z);
+
+		quantized.texture_pos[0] = encode_half(vertex.texture_pos.x);
+		quantized.texture_pos[1] = encode_half(vertex.texture_pos.y);
+
+		// Octahedral mapping, the lower hemisphere is folded over the diagonals
+		const Vector3f& normal = vertex.normal;
+		float norm = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+		float x = norm > 0.f ? normal.x / norm : 0.f;
+		float y = norm > 0.f ? normal.y / norm : 0.f;
+		if (normal.z < 0.f) {
+			float folded_x = (1.f - std::abs(y)) * (x >= 0.f ? 1.f : -1.f);
+			float folded_y = (1.f - std::abs(x)) * (y >= 0.f ? 1.f : -1.f);
+			x = folded_x;
+			y = folded_y;
+		}
+
+		quantized.normal[0] = static_cast<int8_t>(std::lround(std::clamp(x, -1.f, 1.f) * 127.f));
+		quantized.normal[1] = static_cast<int8_t>(std::lround(std::clamp(y, -1.f, 1.f) * 127.f));
+
+		return quantized;
+	}
+
+	Vertex dequantize_vertex(const QuantizedVertex& vertex, const BoundingBoxf& bounds) {
+		Vertex dequantized;
+
+		dequantized.pos = Vector3f{
+			bounds.min.x + (bounds.max.x - bounds.min.x) * (vertex.pos[0] / 65535.f),
+			bounds.min.y + (bounds.max.y - bounds.min.y) * (vertex.pos[1] / 65535.f),
+			bounds.min.z + (bounds.max.z - bounds.min.z) * (vertex.pos[2] / 65535.f)
+		};
+
+		dequantized.texture_pos = Vector2f{ decode_half(vertex.texture_pos[0]), decode_half(vertex.texture_pos[1]) };
+
+		float x = std::max(vertex.normal[0] / 127.f, -1.f);
+		float y = std::max(vertex.normal[1] / 127.f, -1.f);
+		float z = 1.f - std::abs(x) - std::abs(y);
+		float t = std::max(-z, 0.f);
+		x += x >= 0.f ? -t : t;
+		y += y >= 0.f ? -t : t;
+
+		float length = std::sqrt(x * x + y * y + z * z);
+		dequantized.normal = Vector3f{ x / length, y / length, z / length };
+
+		return dequantized;
+	}
+
+	uint16_t encode_half(float value) {
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+
+		uint32_t sign = (bits >> 16) & 0x8000;
+		uint32_t float_exponent = (bits >> 23) & 0xff;
+		uint32_t mantissa = bits & 0x7fffff;
+
+		if (float_exponent == 0xff) {
+			return static_cast<uint16_t>(sign | 0x7c00 | (mantissa != 0 ? 0x200 : 0));
+		}
+
+		int32_t exponent = static_cast<int32_t>(float_exponent) - 127 + 15;
+		if (exponent >= 31) {
+			return static_cast<uint16_t>(sign | 0x7c00);
+		}
+
+		// Too small for a normal half, rounded to a subnormal
+		if (exponent <= 0) {
+			if (exponent < -10) {
+				return static_cast<uint16_t>(sign);
+			}
+
+			mantissa |= 0x800000;
+			uint32_t shift = static_cast<uint32_t>(14 - exponent);
+			uint32_t half_mantissa = mantissa >> shift;
+			uint32_t remainder = mantissa & ((1u << shift) - 1);
+			uint32_t halfway = 1u << (shift - 1);
+			if (remainder > halfway || (remainder == halfway && (half_mantissa & 1))) {
+				++half_mantissa;
+			}
+
+			return static_cast<uint16_t>(sign | half_mantissa);
+		}
+
+		// Round to nearest even, a carry correctly moves to the exponent
+		uint32_t half = sign | (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+		uint32_t remainder = mantissa & 0x1fff;
+		if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1))) {
+			++half;
+		}
+
+		return static_cast<uint16_t>(half);
+	}
+
+	float decode_half(uint16_t value) {
+		float sign = (value & 0x8000) ? -1.f : 1.f;
+		int exponent = (value >> 10) & 0x1f;
+		int mantissa = value & 0x3ff;
+
+		if (exponent == 0) {
+			return sign * std::ldexp(static_cast<float>(mantissa), -24);
+		}
+
+		if (exponent == 31) {
+			return mantissa == 0 ? sign * std::numeric_limits<float>::infinity() : std::numeric_limits<float>::quiet_NaN();
+		}
+
+		return sign * std::ldexp(static_cast<float>(mantissa + 1024), exponent - 25);
+	}
+}
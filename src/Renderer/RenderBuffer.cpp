@@ -8,6 +8,7 @@
 #include <cstring>
 #include <stdexcept>
 #include <cassert>
+#include <vector>
 
 namespace Nth {
 	RenderBuffer::RenderBuffer() :
@@ -17,15 +18,21 @@ namespace Nth {
 	RenderBuffer::RenderBuffer(const RenderDevice& device, VkBufferUsageFlags usage, VkMemoryPropertyFlagBits memory_property, VkDeviceSize size) :
 		m_device(&device),
 		m_memory_property(memory_property) {
+		// Uploads may be written by the transfer queue, sharing avoids an ownership transfer
+		std::vector<uint32_t> queue_families;
+		if (usage & VK_BUFFER_USAGE_TRANSFER_DST_BIT) {
+			queue_families = device.upload_queue_families();
+		}
+
 		VkBufferCreateInfo buffer_create_info = {
 			VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,             // VkStructureType                sType
 			nullptr,                                          // const void                    *pNext
 			0,                                                // VkBufferCreateFlags            flags
 			size,                                             // VkDeviceSize                   size
 			usage,                                            // VkBufferUsageFlags             usage
-			VK_SHARING_MODE_EXCLUSIVE,                        // VkSharingMode                  sharingMode
-			0,                                                // uint32_t                       queueFamilyIndexCount
-			nullptr                                           // const uint32_t                *pQueueFamilyIndices
+			queue_families.empty() ? VK_SHARING_MODE_EXCLUSIVE : VK_SHARING_MODE_CONCURRENT, // VkSharingMode sharingMode
+			static_cast<uint32_t>(queue_families.size()),     // uint32_t                       queueFamilyIndexCount
+			queue_families.data()                             // const uint32_t                *pQueueFamilyIndices
 		};
 
 		handle.create(device.get_handle(), buffer_create_info);
@@ -39,22 +46,56 @@ namespace Nth {
 		}
 	}
 
-	void RenderBuffer::copy(const void* data, size_t size) {
+	void RenderBuffer::copy(const void* data, size_t size, size_t offset) {
+		assert(offset + size <= handle.get_size());
+		if (size == 0) {
+			return;
+		}
+
 		if (m_memory_property & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) {
-			copy_by_staging(data, size);
+			copy_by_staging(data, size, offset);
 		}
 		else {
-			m_memory.map(0, size, 0);
-			void* mappedPtr = m_memory.get_mapped_pointer();
-
-			std::memcpy(mappedPtr, data, size);
+			write_memory(m_memory, data, size, offset);
+		}
+	}
 
-			m_memory.flush_mapped_memory(0, size);
+	void RenderBuffer::upload(const Vk::CommandBuffer& command_buffer, const void* data, size_t size, size_t offset) {
+		assert(offset + size <= handle.get_size());
+		if (size == 0) {
+			return;
+		}
 
-			m_memory.unmap();
+		if (m_memory_property & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) {
+			write_memory(m_staging_memory, data, size, offset);
+			record_copy(command_buffer, size, offset);
+		}
+		else {
+			write_memory(m_memory, data, size, offset);
 		}
 	}
 
+	void RenderBuffer::write_memory(Vk::DeviceMemory& memory, const void* data, size_t size, size_t offset) {
+		// Whole range keeps the flush aligned to the non coherent atom size
+		memory.map(0, VK_WHOLE_SIZE, 0);
+		void* mappedPtr = memory.get_mapped_pointer();
+
+		std::memcpy(static_cast<char*>(mappedPtr) + offset, data, size);
+
+		memory.flush_mapped_memory(0, VK_WHOLE_SIZE);
+
+		memory.unmap();
+	}
+
+	void RenderBuffer::record_copy(const Vk::CommandBuffer& command_buffer, size_t size, size_t offset) const {
+		VkBufferCopy buffer_copy_info = {
+			offset,                           // VkDeviceSize       srcOffset
+			offset,                           // VkDeviceSize       dstOffset
+			size                              // VkDeviceSize       size
+		};
+		command_buffer.copy_buffer(m_staging(), handle(), buffer_copy_info);
+	}
+
 	void RenderBuffer::allocate_buffer_memory(const Vk::Device& device, VkMemoryPropertyFlagBits memory_property, Vk::Buffer& buffer, Vk::DeviceMemory& memory) {
 		VkMemoryRequirements buffer_memory_requirements = buffer.get_memory_requirements();;
 		VkPhysicalDeviceMemoryProperties memory_properties = device.get_physical_device().get_memory_properties();
@@ -95,18 +136,10 @@ namespace Nth {
 		m_staging.bind_buffer_memory(m_staging_memory);
 	}
 
-	void RenderBuffer::copy_by_staging(const void* data, size_t size) {
+	void RenderBuffer::copy_by_staging(const void* data, size_t size, size_t offset) {
 		assert(m_device != nullptr);
 
-		m_staging_memory.map(0, handle.get_size(), 0);
-
-		void* staging_buffer_memory_pointer = m_staging_memory.get_mapped_pointer();
-
-		std::memcpy(staging_buffer_memory_pointer, data, size);
-
-		m_staging_memory.flush_mapped_memory(0, m_staging.get_size());
-
-		m_staging_memory.unmap();
+		write_memory(m_staging_memory, data, size, offset);
 
 		VkCommandBufferBeginInfo command_buffer_begin_info = {
 			VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO, // VkStructureType              sType
@@ -118,12 +151,7 @@ namespace Nth {
 		Vk::CommandBuffer command_buffer{ m_device->allocate_command_buffer() };
 		command_buffer.begin(command_buffer_begin_info);
 
-		VkBufferCopy buffer_copy_info = {
-			0,                                // VkDeviceSize       srcOffset
-			0,                                // VkDeviceSize       dstOffset
-			handle.get_size()                  // VkDeviceSize       size
-		};
-		command_buffer.copy_buffer(m_staging(), handle(), buffer_copy_info);
+		record_copy(command_buffer, size, offset);
 
 		VkBufferMemoryBarrier buffer_memory_barrier = {
 			VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER, // VkStructureType    sType;
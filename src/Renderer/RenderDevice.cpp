@@ -13,17 +13,22 @@ namespace Nth {
 		m_device(instance.get_handle()) { }
 
 	RenderDevice::~RenderDevice() {
+		m_transfer_pool.destroy();
 		m_pool.destroy();
 	}
 
-	void RenderDevice::create(Vk::PhysicalDevice physicalDevice, const VkDeviceCreateInfo& infos, uint32_t presentQueueFamilyIndex, uint32_t graphicQueueFamilyIndex) {
+	void RenderDevice::create(Vk::PhysicalDevice physicalDevice, const VkDeviceCreateInfo& infos, uint32_t presentQueueFamilyIndex, uint32_t graphicQueueFamilyIndex, uint32_t transferQueueFamilyIndex) {
 		m_device.create(std::move(physicalDevice), infos);
 
 		m_present_queue.create(m_device, presentQueueFamilyIndex);
 
 		m_graphics_queue.create(m_device, graphicQueueFamilyIndex);
 
+		m_transfer_queue.create(m_device, transferQueueFamilyIndex);
+
 		m_pool.create(m_device, graphicQueueFamilyIndex, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+
+		m_transfer_pool.create(m_device, transferQueueFamilyIndex, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
 	}
 
 	Vk::CommandBuffer RenderDevice::allocate_command_buffer() const  {
@@ -34,6 +39,22 @@ namespace Nth {
 		return commandBuffer;
 	}
 
+	Vk::CommandBuffer RenderDevice::allocate_transfer_command_buffer() const {
+		Vk::CommandBuffer commandBuffer;
+
+		m_transfer_pool.allocate_command_buffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, commandBuffer);
+
+		return commandBuffer;
+	}
+
+	std::vector<uint32_t> RenderDevice::upload_queue_families() const {
+		if (m_transfer_queue.index() == m_graphics_queue.index()) {
+			return {};
+		}
+
+		return { m_graphics_queue.index(), m_transfer_queue.index() };
+	}
+
 	Vk::Queue& RenderDevice::present_queue() {
 		return m_present_queue;
 	}
@@ -50,6 +71,14 @@ namespace Nth {
 		return m_graphics_queue;
 	}
 
+	Vk::Queue& RenderDevice::transfer_queue() {
+		return m_transfer_queue;
+	}
+
+	const Vk::Queue& RenderDevice::transfer_queue() const {
+		return m_transfer_queue;
+	}
+
 	Vk::Device& RenderDevice::get_handle() {
 		return m_device;
 	}
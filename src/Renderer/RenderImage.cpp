@@ -8,9 +8,16 @@
 #include <cstring>
 #include <iostream>
 #include <cassert>
+#include <vector>
 
 namespace Nth {
-	void RenderImage::create(const RenderDevice& device, uint32_t width, uint32_t height, size_t staging_size, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties) {
+	void RenderImage::create(const RenderDevice& device, uint32_t width, uint32_t height, uint32_t mip_levels, size_t staging_size, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties) {
+		// Uploads may be written by the transfer queue, sharing avoids an ownership transfer
+		std::vector<uint32_t> queue_families;
+		if (usage & VK_IMAGE_USAGE_TRANSFER_DST_BIT) {
+			queue_families = device.upload_queue_families();
+		}
+
 		VkImageCreateInfo image_create_info = {
 			VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,  // VkStructureType        sType;
 			nullptr,                              // const void            *pNext
@@ -22,14 +29,14 @@ namespace Nth {
 				height,                               // uint32_t               height
 				1                                     // uint32_t               depth
 			},
-			1,                                    // uint32_t               mipLevels
+			mip_levels,                           // uint32_t               mipLevels
 			1,                                    // uint32_t               arrayLayers
 			VK_SAMPLE_COUNT_1_BIT,                // VkSampleCountFlagBits  samples
 			tiling,                               // VkImageTiling          tiling
 			usage,                                // VkImageUsageFlags      usage
-			VK_SHARING_MODE_EXCLUSIVE,            // VkSharingMode          sharingMode
-			0,                                    // uint32_t               queueFamilyIndexCount
-			nullptr,                              // const uint32_t        *pQueueFamilyIndices
+			queue_families.empty() ? VK_SHARING_MODE_EXCLUSIVE : VK_SHARING_MODE_CONCURRENT, // VkSharingMode sharingMode
+			static_cast<uint32_t>(queue_families.size()), // uint32_t       queueFamilyIndexCount
+			queue_families.data(),                // const uint32_t        *pQueueFamilyIndices
 			VK_IMAGE_LAYOUT_UNDEFINED             // VkImageLayout          initialLayout
 		};
 
@@ -53,10 +60,16 @@ namespace Nth {
 		}
 
 		m_device = &device;
+		m_mip_levels = mip_levels;
 	}
 
 	void RenderImage::create_view(VkFormat format, VkImageAspectFlags aspectFlags) {
+		view = create_mip_view(format, aspectFlags, 0, m_mip_levels);
+	}
+
+	Vk::ImageView RenderImage::create_mip_view(VkFormat format, VkImageAspectFlags aspectFlags, uint32_t base_mip_level, uint32_t level_count) const {
 		assert(m_device != nullptr);
+		assert(base_mip_level + level_count <= m_mip_levels);
 
 		VkImageViewCreateInfo image_view_create_info = {
 			VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO, // VkStructureType          sType
@@ -73,27 +86,49 @@ namespace Nth {
 			},
 			{                                         // VkImageSubresourceRange  subresourceRange
 				aspectFlags,                              // VkImageAspectFlags       aspectMask
-				0,                                        // uint32_t                 baseMipLevel
-				1,                                        // uint32_t                 levelCount
+				base_mip_level,                           // uint32_t                 baseMipLevel
+				level_count,                              // uint32_t                 levelCount
 				0,                                        // uint32_t                 baseArrayLayer
 				1                                         // uint32_t                 layerCount
 			}
 		};
 
-		view.create(m_device->get_handle(), image_view_create_info);
+		Vk::ImageView mip_view;
+		mip_view.create(m_device->get_handle(), image_view_create_info);
+
+		return mip_view;
+	}
+
+	uint32_t RenderImage::mip_levels() const {
+		return m_mip_levels;
 	}
 
 	void RenderImage::copy(void const* data, size_t size, uint32_t width, uint32_t height) {
-		assert(m_device != nullptr);
+		stage(size, [&](void* staging) {
+			std::memcpy(staging, data, size);
+		});
 
+		copy_staged(width, height);
+	}
+
+	void RenderImage::stage(size_t size, const std::function<void(void*)>& write) {
 		m_staging_memory.map(0, size, 0);
-		void* stagingBufferMemoryPointer = m_staging_memory.get_mapped_pointer();
 
-		std::memcpy(stagingBufferMemoryPointer, data, size);
+		try {
+			write(m_staging_memory.get_mapped_pointer());
+		}
+		catch (...) {
+			m_staging_memory.unmap();
+			throw;
+		}
 
 		m_staging_memory.flush_mapped_memory(0, size);
 
 		m_staging_memory.unmap();
+	}
+
+	void RenderImage::copy_staged(uint32_t width, uint32_t height) {
+		assert(m_device != nullptr);
 
 		// Prepare command buffer to copy data from staging buffer to a vertex buffer
 		VkCommandBufferBeginInfo command_buffer_begin_info = {
@@ -106,64 +141,7 @@ namespace Nth {
 		Vk::CommandBuffer command_buffer{ m_device->allocate_command_buffer() };
 		command_buffer.begin(command_buffer_begin_info);
 
-		VkImageSubresourceRange image_subresource_range = {
-			VK_IMAGE_ASPECT_COLOR_BIT,              // VkImageAspectFlags        aspectMask
-			0,                                      // uint32_t                  baseMipLevel
-			1,                                      // uint32_t                  levelCount
-			0,                                      // uint32_t                  baseArrayLayer
-			1                                       // uint32_t                  layerCount
-		};
-
-		VkImageMemoryBarrier image_memory_barrier_from_undefined_to_transfer_dst = {
-			VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER, // VkStructureType           sType
-			nullptr,                                // const void               *pNext
-			0,                                      // VkAccessFlags             srcAccessMask
-			VK_ACCESS_TRANSFER_WRITE_BIT,           // VkAccessFlags             dstAccessMask
-			VK_IMAGE_LAYOUT_UNDEFINED,              // VkImageLayout             oldLayout
-			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,   // VkImageLayout             newLayout
-			VK_QUEUE_FAMILY_IGNORED,                // uint32_t                  srcQueueFamilyIndex
-			VK_QUEUE_FAMILY_IGNORED,                // uint32_t                  dstQueueFamilyIndex
-			handle(),                               // VkImage                   image
-			image_subresource_range                 // VkImageSubresourceRange   subresourceRange
-		};
-		command_buffer.pipeline_barrier(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &image_memory_barrier_from_undefined_to_transfer_dst);
-
-		VkBufferImageCopy buffer_image_copy_info = {
-			0,                                  // VkDeviceSize               bufferOffset
-			0,                                  // uint32_t                   bufferRowLength
-			0,                                  // uint32_t                   bufferImageHeight
-			{                                   // VkImageSubresourceLayers   imageSubresource
-				VK_IMAGE_ASPECT_COLOR_BIT,          // VkImageAspectFlags         aspectMask
-				0,                                  // uint32_t                   mipLevel
-				0,                                  // uint32_t                   baseArrayLayer
-				1                                   // uint32_t                   layerCount
-			},
-			{                                   // VkOffset3D                 imageOffset
-				0,                                  // int32_t                    x
-				0,                                  // int32_t                    y
-				0                                   // int32_t                    z
-			},
-			{                                   // VkExtent3D                 imageExtent
-				width,                              // uint32_t                   width
-				height,                             // uint32_t                   height
-				1                                   // uint32_t                   depth
-			}
-		};
-		command_buffer.copy_buffer_to_image(m_staging(), handle(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &buffer_image_copy_info);
-
-		VkImageMemoryBarrier image_memory_barrier_from_transfer_to_shader_read = {
-			VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,   // VkStructureType              sType
-			nullptr,                                  // const void                  *pNext
-			VK_ACCESS_TRANSFER_WRITE_BIT,             // VkAccessFlags                srcAccessMask
-			VK_ACCESS_SHADER_READ_BIT,                // VkAccessFlags                dstAccessMask
-			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,     // VkImageLayout                oldLayout
-			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, // VkImageLayout                newLayout
-			VK_QUEUE_FAMILY_IGNORED,                  // uint32_t                     srcQueueFamilyIndex
-			VK_QUEUE_FAMILY_IGNORED,                  // uint32_t                     dstQueueFamilyIndex
-			handle(),                                 // VkImage                      image
-			image_subresource_range                   // VkImageSubresourceRange      subresourceRange
-		};
-		command_buffer.pipeline_barrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &image_memory_barrier_from_transfer_to_shader_read);
+		record_copy(command_buffer, width, height, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
 
 		command_buffer.end();
 
@@ -186,6 +164,17 @@ namespace Nth {
 		m_device->get_handle().wait_idle();
 	}
 
+	void RenderImage::upload(const Vk::CommandBuffer& command_buffer, void const* data, size_t size, uint32_t width, uint32_t height) {
+		assert(m_device != nullptr);
+
+		stage(size, [&](void* staging) {
+			std::memcpy(staging, data, size);
+		});
+
+		// Transfer queues have no shader stage, the semaphore makes the copy visible to them
+		record_copy(command_buffer, width, height, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0);
+	}
+
 	uint32_t RenderImage::find_memory_type(const Vk::Device& device, uint32_t memory_type_bit, VkMemoryPropertyFlags properties) const {
 		VkPhysicalDeviceMemoryProperties mem_properties = device.get_physical_device().get_memory_properties();
 
@@ -224,4 +213,65 @@ namespace Nth {
 
 		m_staging.bind_buffer_memory(m_staging_memory);
 	}
-}
+
+	void RenderImage::record_copy(const Vk::CommandBuffer& command_buffer, uint32_t width, uint32_t height, VkPipelineStageFlags dst_stage, VkAccessFlags dst_access) const {
+		VkImageSubresourceRange image_subresource_range = {
+			VK_IMAGE_ASPECT_COLOR_BIT,              // VkImageAspectFlags        aspectMask
+			0,                                      // uint32_t                  baseMipLevel
+			1,                                      // uint32_t                  levelCount
+			0,                                      // uint32_t                  baseArrayLayer
+			1                                       // uint32_t                  layerCount
+		};
+
+		VkImageMemoryBarrier image_memory_barrier_from_undefined_to_transfer_dst = {
+			VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER, // VkStructureType           sType
+			nullptr,                                // const void               *pNext
+			0,                                      // VkAccessFlags             srcAccessMask
+			VK_ACCESS_TRANSFER_WRITE_BIT,           // VkAccessFlags             dstAccessMask
+			VK_IMAGE_LAYOUT_UNDEFINED,              // VkImageLayout             oldLayout
+			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,   // VkImageLayout             newLayout
+			VK_QUEUE_FAMILY_IGNORED,                // uint32_t                  srcQueueFamilyIndex
+			VK_QUEUE_FAMILY_IGNORED,                // uint32_t                  dstQueueFamilyIndex
+			handle(),                               // VkImage                   image
+			image_subresource_range                 // VkImageSubresourceRange   subresourceRange
+		};
+		command_buffer.pipeline_barrier(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &image_memory_barrier_from_undefined_to_transfer_dst);
+
+		VkBufferImageCopy buffer_image_copy_info = {
+			0,                                  // VkDeviceSize               bufferOffset
+			0,                                  // uint32_t                   bufferRowLength
+			0,                                  // uint32_t                   bufferImageHeight
+			{                                   // VkImageSubresourceLayers   imageSubresource
+				VK_IMAGE_ASPECT_COLOR_BIT,          // VkImageAspectFlags         aspectMask
+				0,                                  // uint32_t                   mipLevel
+				0,                                  // uint32_t                   baseArrayLayer
+				1                                   // uint32_t                   layerCount
+			},
+			{                                   // VkOffset3D                 imageOffset
+				0,                                  // int32_t                    x
+				0,                                  // int32_t                    y
+				0                                   // int32_t                    z
+			},
+			{                                   // VkExtent3D                 imageExtent
+				width,                              // uint32_t                   width
+				height,                             // uint32_t                   height
+				1                                   // uint32_t                   depth
+			}
+		};
+		command_buffer.copy_buffer_to_image(m_staging(), handle(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &buffer_image_copy_info);
+
+		VkImageMemoryBarrier image_memory_barrier_from_transfer_to_shader_read = {
+			VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,   // VkStructureType              sType
+			nullptr,                                  // const void                  *pNext
+			VK_ACCESS_TRANSFER_WRITE_BIT,             // VkAccessFlags                srcAccessMask
+			dst_access,                               // VkAccessFlags                dstAccessMask
+			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,     // VkImageLayout                oldLayout
+			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, // VkImageLayout                newLayout
+			VK_QUEUE_FAMILY_IGNORED,                  // uint32_t                     srcQueueFamilyIndex
+			VK_QUEUE_FAMILY_IGNORED,                  // uint32_t                     dstQueueFamilyIndex
+			handle(),                                 // VkImage                      image
+			image_subresource_range                   // VkImageSubresourceRange      subresourceRange
+		};
+		command_buffer.pipeline_barrier(VK_PIPELINE_STAGE_TRANSFER_BIT, dst_stage, 0, 0, nullptr, 0, nullptr, 1, &image_memory_barrier_from_transfer_to_shader_read);
+	}
+}
\ No newline at end of file
@@ -105,11 +105,38 @@ namespace Nth {
 			});
 		}
 
+		// A family doing only transfers runs uploads on the copy engine, alongside rendering
+		uint32_t transfer_queue_family_index = graphics_queue_family_index;
+		std::vector<VkQueueFamilyProperties> queue_families_properties{ physical_device.get_queue_family_properties() };
+		for (size_t i{ 0 }; i < queue_families_properties.size(); ++i) {
+			VkQueueFlags flags = queue_families_properties[i].queueFlags;
+			if ((flags & VK_QUEUE_TRANSFER_BIT) && !(flags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)) && queue_families_properties[i].queueCount > 0) {
+				transfer_queue_family_index = static_cast<uint32_t>(i);
+				break;
+			}
+		}
+
+		if (transfer_queue_family_index != graphics_queue_family_index && transfer_queue_family_index != present_queue_family_index) {
+			queue_create_infos.push_back({
+				VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,  // VkStructureType              sType
+				nullptr,                                     // const void                  *pNext
+				0,                                           // VkDeviceQueueCreateFlags     flags
+				transfer_queue_family_index,                 // uint32_t                     queueFamilyIndex
+				1,                                           // uint32_t                     queueCount
+				queue_priorities.data()                       // const float                 *pQueuePriorities
+			});
+		}
+
 		std::vector<const char*> extensions = {
 			VK_KHR_SWAPCHAIN_EXTENSION_NAME,
 			VK_KHR_SHADER_DRAW_PARAMETERS_EXTENSION_NAME
 		};
 
+		// Occlusion culling writes object index as first instance of indirect draws, meshlets of a mesh are drawn in one call
+		VkPhysicalDeviceFeatures enabled_features{};
+		enabled_features.drawIndirectFirstInstance = VK_TRUE;
+		enabled_features.multiDrawIndirect = VK_TRUE;
+
 		VkDeviceCreateInfo device_create_info = {
 			VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,             // VkStructureType                    sType
 			nullptr,                                          // const void                        *pNext
@@ -120,10 +147,10 @@ namespace Nth {
 			nullptr,                                          // const char * const                *ppEnabledLayerNames
 			static_cast<uint32_t>(extensions.size()),         // uint32_t                           enabledExtensionCount
 			extensions.data(),                                // const char * const                *ppEnabledExtensionNames
-			nullptr                                           // const VkPhysicalDeviceFeatures    *pEnabledFeatures
+			&enabled_features                                 // const VkPhysicalDeviceFeatures    *pEnabledFeatures
 		};
 
-		m_device.create(std::move(physical_device), device_create_info, present_queue_family_index, graphics_queue_family_index);
+		m_device.create(std::move(physical_device), device_create_info, present_queue_family_index, graphics_queue_family_index, transfer_queue_family_index);
 	}
 
 	Vk::Instance& RenderInstance::get_handle() {
@@ -163,6 +190,16 @@ namespace Nth {
 			return false;
 		}
 
+		if (!features.drawIndirectFirstInstance) {
+			std::cerr << "Warning: physical device " << physical_device() << " don't support indirect draw first instance" << std::endl;
+			return false;
+		}
+
+		if (!features.multiDrawIndirect) {
+			std::cerr << "Warning: physical device " << physical_device() << " don't support multi draw indirect" << std::endl;
+			return false;
+		}
+
 		std::vector<VkQueueFamilyProperties> queueFamiliesProperities{ physical_device.get_queue_family_properties() };
 
 		for (size_t i{ 0 }; i < queueFamiliesProperities.size(); ++i) {
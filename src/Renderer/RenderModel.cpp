@@ -1,7 +1,42 @@
 #include <Renderer/RenderModel.hpp>
 
+#include <Renderer/RenderObject.hpp>
+
+#include <cassert>
+
 namespace Nth {
-	RenderModel::RenderModel(std::vector<RenderMesh>&& meshes, std::vector<RenderTexture>&& textures) :
+	const RenderMesh* RenderMeshRange::begin() const {
+		return first;
+	}
+
+	const RenderMesh* RenderMeshRange::end() const {
+		return last;
+	}
+
+	RenderModel::RenderModel(std::vector<RenderMesh>&& meshes, std::vector<std::shared_ptr<const RenderTexture>>&& textures) :
 		meshes(std::move(meshes)),
-		textures(std::move(textures)) { }
+		textures(std::move(textures)) {
+		for (const RenderMesh& mesh : this->meshes) {
+			bounds.extend(mesh.bounds);
+		}
+	}
+
+	RenderMeshRange RenderModel::meshes_of(size_t mesh_index) const {
+		if (mesh_index == RenderObject::all_meshes) {
+			return RenderMeshRange{ meshes.data(), meshes.data() + meshes.size() };
+		}
+
+		// Not resident yet, objects of the model have nothing to draw
+		if (meshes.empty()) {
+			return RenderMeshRange{ meshes.data(), meshes.data() };
+		}
+
+		assert(mesh_index < meshes.size());
+		return RenderMeshRange{ meshes.data() + mesh_index, meshes.data() + mesh_index + 1 };
+	}
+
+	const BoundingBoxf& RenderModel::bounds_of(size_t mesh_index) const {
+		// Empty bounds of a model not resident yet keep its objects out of the spatial indices
+		return mesh_index == RenderObject::all_meshes || meshes.empty() ? bounds : meshes[mesh_index].bounds;
+	}
 }
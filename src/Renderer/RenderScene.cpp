@@ -0,0 +1,165 @@
+#include <Renderer/RenderScene.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+
+namespace Nth {
+	bool RenderObjectHandle::operator==(const RenderObjectHandle& handle) const {
+		return index == handle.index && generation == handle.generation;
+	}
+
+	bool RenderObjectHandle::operator!=(const RenderObjectHandle& handle) const {
+		return !(*this == handle);
+	}
+
+	RenderScene::RenderScene(size_t frame_count) :
+		m_objects(),
+		m_generations(),
+		m_alive(),
+		m_free_slots(),
+		m_size(0),
+		m_dirty_frames(),
+		m_dirty_slots(frame_count + 1) {
+		assert(frame_count > 0 && frame_count < 32);
+
+		static std::atomic<uint64_t> next_id{ 1 };
+		m_id = next_id++;
+	}
+
+	RenderObjectHandle RenderScene::add(const RenderObject& object) {
+		uint32_t slot;
+		if (!m_free_slots.empty()) {
+			slot = m_free_slots.back();
+			m_free_slots.pop_back();
+
+			m_objects[slot] = object;
+			m_alive[slot] = true;
+		}
+		else {
+			slot = static_cast<uint32_t>(m_objects.size());
+
+			m_objects.push_back(object);
+			m_generations.push_back(0);
+			m_alive.push_back(true);
+			m_dirty_frames.push_back(0);
+		}
+
+		++m_size;
+		mark_dirty(slot);
+
+		return RenderObjectHandle{ slot, m_generations[slot] };
+	}
+
+	void RenderScene::remove(RenderObjectHandle handle) {
+		assert(contains(handle));
+
+		// Nothing to upload, dead slots are never drawn
+		m_alive[handle.index] = false;
+		++m_generations[handle.index];
+		m_free_slots.push_back(handle.index);
+		--m_size;
+
+		mark_dirty(handle.index, frame_count());
+	}
+
+	bool RenderScene::contains(RenderObjectHandle handle) const {
+		return handle.index < m_objects.size() && m_alive[handle.index] && m_generations[handle.index] == handle.generation;
+	}
+
+	const RenderObject& RenderScene::get(RenderObjectHandle handle) const {
+		assert(contains(handle));
+
+		return m_objects[handle.index];
+	}
+
+	void RenderScene::set(RenderObjectHandle handle, const RenderObject& object) {
+		assert(contains(handle));
+
+		m_objects[handle.index] = object;
+		mark_dirty(handle.index);
+	}
+
+	void RenderScene::set_transform(RenderObjectHandle handle, const Matrix4f& transform) {
+		assert(contains(handle));
+
+		m_objects[handle.index].transform_matrix = transform;
+		mark_dirty(handle.index);
+	}
+
+	const std::vector<RenderObject>& RenderScene::objects() const {
+		return m_objects;
+	}
+
+	bool RenderScene::is_alive(size_t slot) const {
+		return m_alive[slot];
+	}
+
+	RenderObjectHandle RenderScene::handle_of(size_t slot) const {
+		assert(is_alive(slot));
+
+		return RenderObjectHandle{ static_cast<uint32_t>(slot), m_generations[slot] };
+	}
+
+	size_t RenderScene::slot_count() const {
+		return m_objects.size();
+	}
+
+	size_t RenderScene::size() const {
+		return m_size;
+	}
+
+	uint64_t RenderScene::id() const {
+		return m_id;
+	}
+
+	size_t RenderScene::frame_count() const {
+		return m_dirty_slots.size() - 1;
+	}
+
+	std::vector<RenderSceneRange> RenderScene::take_dirty_ranges(size_t frame_index) {
+		assert(frame_index < frame_count());
+
+		std::vector<uint32_t>& slots = m_dirty_slots[frame_index];
+		std::sort(slots.begin(), slots.end());
+
+		std::vector<RenderSceneRange> ranges;
+		for (uint32_t slot : slots) {
+			m_dirty_frames[slot] &= ~(1u << frame_index);
+
+			if (!ranges.empty() && ranges.back().first + ranges.back().count == slot) {
+				++ranges.back().count;
+			}
+			else {
+				ranges.push_back(RenderSceneRange{ slot, 1 });
+			}
+		}
+		slots.clear();
+
+		return ranges;
+	}
+
+	std::vector<uint32_t> RenderScene::take_changed_slots() {
+		std::vector<uint32_t> slots;
+		std::swap(slots, m_dirty_slots.back());
+
+		for (uint32_t slot : slots) {
+			m_dirty_frames[slot] &= ~(1u << frame_count());
+		}
+
+		return slots;
+	}
+
+	void RenderScene::mark_dirty(uint32_t slot) {
+		for (size_t i = 0; i < m_dirty_slots.size(); ++i) {
+			mark_dirty(slot, i);
+		}
+	}
+
+	void RenderScene::mark_dirty(uint32_t slot, size_t channel) {
+		if ((m_dirty_frames[slot] & (1u << channel)) == 0) {
+			m_dirty_frames[slot] |= 1u << channel;
+			m_dirty_slots[channel].push_back(slot);
+		}
+	}
+}
@@ -43,6 +43,14 @@ namespace Nth {
 		return m_render_pass;
 	}
 
+	const Vk::RenderPass& RenderSurface::get_late_render_pass() const {
+		return m_late_render_pass;
+	}
+
+	const DepthImage& RenderSurface::get_depth() const {
+		return m_depth;
+	}
+
 	RenderingResource& RenderSurface::aquire_next_image(const Vector2ui& size) {
 		if (m_swapchain_size != size) {
 			on_window_size_changed(size);
@@ -82,7 +90,7 @@ namespace Nth {
 
 		create_depth_ressource();
 
-		create_render_pass();
+		create_render_passes();
 
 		create_rendering_resources();
 	}
@@ -163,29 +171,35 @@ namespace Nth {
 		m_swapchain_size = size;
 	}
 
-	void RenderSurface::create_render_pass() {
+	void RenderSurface::create_render_passes() {
+		create_render_pass(m_render_pass, true);
+		create_render_pass(m_late_render_pass, false);
+	}
+
+	void RenderSurface::create_render_pass(Vk::RenderPass& render_pass, bool first_pass) const {
+		// The first pass clears and keeps depth for the depth pyramid, the second one loads both attachments and presents
 		std::vector<VkAttachmentDescription> attachment_descriptions = {
 			{
-				0,                                   // VkAttachmentDescriptionFlags   flags
-				m_swapchain.get_format(),            // VkFormat                       format
-				VK_SAMPLE_COUNT_1_BIT,               // VkSampleCountFlagBits          samples
-				VK_ATTACHMENT_LOAD_OP_CLEAR,         // VkAttachmentLoadOp             loadOp
-				VK_ATTACHMENT_STORE_OP_STORE,        // VkAttachmentStoreOp            storeOp
-				VK_ATTACHMENT_LOAD_OP_DONT_CARE,     // VkAttachmentLoadOp             stencilLoadOp
-				VK_ATTACHMENT_STORE_OP_DONT_CARE,    // VkAttachmentStoreOp            stencilStoreOp
-				VK_IMAGE_LAYOUT_UNDEFINED,           // VkImageLayout                  initialLayout;
-				VK_IMAGE_LAYOUT_PRESENT_SRC_KHR      // VkImageLayout                  finalLayout
+				0,                                                                                           // VkAttachmentDescriptionFlags   flags
+				m_swapchain.get_format(),                                                                    // VkFormat                       format
+				VK_SAMPLE_COUNT_1_BIT,                                                                       // VkSampleCountFlagBits          samples
+				first_pass ? VK_ATTACHMENT_LOAD_OP_CLEAR : VK_ATTACHMENT_LOAD_OP_LOAD,                       // VkAttachmentLoadOp             loadOp
+				VK_ATTACHMENT_STORE_OP_STORE,                                                                // VkAttachmentStoreOp            storeOp
+				VK_ATTACHMENT_LOAD_OP_DONT_CARE,                                                             // VkAttachmentLoadOp             stencilLoadOp
+				VK_ATTACHMENT_STORE_OP_DONT_CARE,                                                            // VkAttachmentStoreOp            stencilStoreOp
+				first_pass ? VK_IMAGE_LAYOUT_UNDEFINED : VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,           // VkImageLayout                  initialLayout;
+				first_pass ? VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR      // VkImageLayout                  finalLayout
 			},
 			{
-				0,                                                // VkAttachmentDescriptionFlags   flags
-				m_depth.format(),                                 // VkFormat                       format
-				VK_SAMPLE_COUNT_1_BIT,                            // VkSampleCountFlagBits          samples
-				VK_ATTACHMENT_LOAD_OP_CLEAR,                      // VkAttachmentLoadOp             loadOp
-				VK_ATTACHMENT_STORE_OP_DONT_CARE,                 // VkAttachmentStoreOp            storeOp
-				VK_ATTACHMENT_LOAD_OP_DONT_CARE,                  // VkAttachmentLoadOp             stencilLoadOp
-				VK_ATTACHMENT_STORE_OP_DONT_CARE,                 // VkAttachmentStoreOp            stencilStoreOp
-				VK_IMAGE_LAYOUT_UNDEFINED,                        // VkImageLayout                  initialLayout;
-				VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL  // VkImageLayout                  finalLayout
+				0,                                                                                           // VkAttachmentDescriptionFlags   flags
+				m_depth.format(),                                                                            // VkFormat                       format
+				VK_SAMPLE_COUNT_1_BIT,                                                                       // VkSampleCountFlagBits          samples
+				first_pass ? VK_ATTACHMENT_LOAD_OP_CLEAR : VK_ATTACHMENT_LOAD_OP_LOAD,                       // VkAttachmentLoadOp             loadOp
+				first_pass ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE,                // VkAttachmentStoreOp            storeOp
+				VK_ATTACHMENT_LOAD_OP_DONT_CARE,                                                             // VkAttachmentLoadOp             stencilLoadOp
+				VK_ATTACHMENT_STORE_OP_DONT_CARE,                                                            // VkAttachmentStoreOp            stencilStoreOp
+				first_pass ? VK_IMAGE_LAYOUT_UNDEFINED : VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,    // VkImageLayout                  initialLayout;
+				VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL                                              // VkImageLayout                  finalLayout
 			}
 		};
 
@@ -214,6 +228,8 @@ namespace Nth {
 			}
 		};
 
+		VkAccessFlags color_dst_access_mask = first_pass ? VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT : VK_ACCESS_MEMORY_READ_BIT;
+
 		std::vector<VkSubpassDependency> dependencies = {
 			{
 				VK_SUBPASS_EXTERNAL,                            // uint32_t                       srcSubpass
@@ -225,22 +241,31 @@ namespace Nth {
 				VK_DEPENDENCY_BY_REGION_BIT                     // VkDependencyFlags              dependencyFlags
 			},
 			{
-				VK_SUBPASS_EXTERNAL,                                                                     // uint32_t                       srcSubpass
-				0,                                                                                       // uint32_t                       dstSubpass
-				VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,  // VkPipelineStageFlags           srcStageMask
-				VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,  // VkPipelineStageFlags           dstStageMask
-				0,                                                                                       // VkAccessFlags                  srcAccessMask
-				VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,                                            // VkAccessFlags                  dstAccessMask
-				VK_DEPENDENCY_BY_REGION_BIT                                                              // VkDependencyFlags              dependencyFlags
+				VK_SUBPASS_EXTERNAL,                                                                                                        // uint32_t                       srcSubpass
+				0,                                                                                                                          // uint32_t                       dstSubpass
+				VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,  // VkPipelineStageFlags           srcStageMask
+				VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,                                     // VkPipelineStageFlags           dstStageMask
+				0,                                                                                                                          // VkAccessFlags                  srcAccessMask
+				VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,                                 // VkAccessFlags                  dstAccessMask
+				VK_DEPENDENCY_BY_REGION_BIT                                                                                                 // VkDependencyFlags              dependencyFlags
 			},
 			{
-				0,                                              // uint32_t                       srcSubpass
-				VK_SUBPASS_EXTERNAL,                            // uint32_t                       dstSubpass
-				VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,  // VkPipelineStageFlags           srcStageMask
-				VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,           // VkPipelineStageFlags           dstStageMask
-				VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,           // VkAccessFlags                  srcAccessMask
-				VK_ACCESS_MEMORY_READ_BIT,                      // VkAccessFlags                  dstAccessMask
-				VK_DEPENDENCY_BY_REGION_BIT                     // VkDependencyFlags              dependencyFlags
+				0,                                                                                           // uint32_t                       srcSubpass
+				VK_SUBPASS_EXTERNAL,                                                                         // uint32_t                       dstSubpass
+				VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,                                               // VkPipelineStageFlags           srcStageMask
+				first_pass ? VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,  // VkPipelineStageFlags           dstStageMask
+				VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,                                                        // VkAccessFlags                  srcAccessMask
+				color_dst_access_mask,                                                                       // VkAccessFlags                  dstAccessMask
+				VK_DEPENDENCY_BY_REGION_BIT                                                                  // VkDependencyFlags              dependencyFlags
+			},
+			{
+				0,                                                                                           // uint32_t                       srcSubpass
+				VK_SUBPASS_EXTERNAL,                                                                         // uint32_t                       dstSubpass
+				VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,      // VkPipelineStageFlags           srcStageMask
+				VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT,           // VkPipelineStageFlags           dstStageMask
+				VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,                                                // VkAccessFlags                  srcAccessMask
+				VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT,                     // VkAccessFlags                  dstAccessMask
+				0                                                                                            // VkDependencyFlags              dependencyFlags
 			}
 		};
 
@@ -256,7 +281,7 @@ namespace Nth {
 			dependencies.data()                                   // const VkSubpassDependency     *pDependencies
 		};
 
-		m_render_pass.create(m_vulkan.get_device().get_handle(), render_pass_create_info);
+		render_pass.create(m_vulkan.get_device().get_handle(), render_pass_create_info);
 	}
 
 	void RenderSurface::create_depth_ressource() {
@@ -7,7 +7,7 @@
 
 namespace Nth {
 	void RenderTexture::create(const RenderDevice& device, uint32_t width, uint32_t height, size_t size, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties) {
-		image.create(device, width, height, size, format, tiling, usage, properties);
+		image.create(device, width, height, 1, size, format, tiling, usage, properties);
 
 		create_sampler(device.get_handle());
 	}
@@ -2,40 +2,73 @@
 #include <Renderer/RenderingResource.hpp>
 #include <Renderer/RenderObject.hpp>
 #include <Renderer/Model.hpp>
+#include <Renderer/CookedModel.hpp>
 #include <Renderer/Texture.hpp>
+#include <Renderer/InstanceTransform.hpp>
 
 #include <Window/Window.hpp>
 #include <Window/WindowHandle.hpp>
 
 #include <Maths/Angle.hpp>
 
+#include <Utils/AssetFile.hpp>
+#include <Utils/Hash.hpp>
 #include <Utils/Image.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <cstring>
 #include <iostream>
+#include <optional>
 
 namespace Nth {
 	Renderer::Renderer() :
 		m_vulkan(),
 		m_render_surface(m_vulkan),
 		m_resource_index(0),
+		m_instance_format(InstanceFormat::Matrix),
 		m_renders(),
 		m_descriptor_allocator(),
 		m_light_bindings(), 
 		m_light_buffers(),
+		m_model_buffer_idle_frames(),
+		m_model_buffer_scenes(),
+		m_immediate_scene(Renderer::resource_count),
+		m_immediate_handles(),
+		m_scene_bvh(),
+		m_scene_octree(octree_region),
+		m_octree_region(octree_region),
+		m_spatial_scene(0),
 		light(),
+		point_lights(),
 		camera(),
-		m_window(nullptr) { }
+		occlusion_culling(true),
+		software_occlusion_culling(false),
+		cluster_cone_culling(false),
+		lod_pixel_error(1.f),
+		lod_hysteresis(0.2f),
+		instance_format(InstanceFormat::Matrix),
+		octree_region(Vector3f{ -1024.f, -1024.f, -1024.f }, Vector3f{ 1024.f, 1024.f, 1024.f }),
+		m_window(nullptr),
+		m_read_pool(std::make_unique<ReadPool>()) { }
 
 	void Renderer::set_render_on(Window& window) {
 		m_window = &window;
+		m_instance_format = instance_format;
 		m_render_surface.create(window.handle());
 		m_vulkan.create_device(m_render_surface.get_handle());
 		m_render_surface.init_render_pipeline(window.size());
 
 		size_t viewLayoutIndex = add_descriptor_set_layout({ BindingInfo{ ShaderType::Vertex, BindingType::Uniform, 0, 0 } });
 		size_t modelLayoutIndex = add_descriptor_set_layout({ BindingInfo{ ShaderType::Vertex, BindingType::Storage, 1, 0 } });
-		size_t lightLayoutIndex = add_descriptor_set_layout({ BindingInfo{ ShaderType::Fragment, BindingType::Uniform, 2, 0 } });
+		size_t lightLayoutIndex = add_descriptor_set_layout({
+			BindingInfo{ ShaderType::Fragment, BindingType::Uniform, 2, 0 },
+			BindingInfo{ ShaderType::Fragment, BindingType::Uniform, 2, 1 },
+			BindingInfo{ ShaderType::Fragment, BindingType::Storage, 2, 2 },
+			BindingInfo{ ShaderType::Fragment, BindingType::Storage, 2, 3 },
+			BindingInfo{ ShaderType::Fragment, BindingType::Storage, 2, 4 }
+		});
 		add_descriptor_set_layout({ BindingInfo{ ShaderType::Fragment, BindingType::Texture, 3, 0 } });
 
 		m_descriptor_allocator.init(m_vulkan.get_device().get_handle());
@@ -59,15 +92,32 @@ namespace Nth {
 				sizeof(ViewerGpuObject)
 			};
 
-			m_model_buffers[i] = RenderBuffer{
-				m_vulkan.get_device(),
-				VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
-				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
-				10000 * sizeof(ModelGpuObject)
-			};
+			reserve_model_buffer(i, Renderer::min_object_capacity);
 		}
 
 		update_descriptor_set();
+
+		// TODO: Shader paths hardcoded
+		m_light_clusters.init(m_vulkan.get_device(), m_descriptor_allocator, "light_cluster.comp.spv", Renderer::resource_count);
+
+		m_depth_pyramid.init(m_vulkan.get_device(), m_descriptor_allocator, "depth_pyramid.comp.spv");
+		m_depth_pyramid.create(m_render_surface.get_depth(), m_render_surface.size());
+
+		m_culling_layout = create_descriptor_set_layout(m_vulkan.get_device().get_handle(), {
+			BindingInfo{ ShaderType::Compute, BindingType::Uniform, 0, 0 },
+			BindingInfo{ ShaderType::Compute, BindingType::Storage, 0, 1 },
+			BindingInfo{ ShaderType::Compute, BindingType::Storage, 0, 2 },
+			BindingInfo{ ShaderType::Compute, BindingType::Storage, 0, 3 },
+			BindingInfo{ ShaderType::Compute, BindingType::Storage, 0, 4 },
+			BindingInfo{ ShaderType::Compute, BindingType::Texture, 0, 5 }
+		});
+		m_culling.create(m_vulkan.get_device().get_handle(), "occlusion_cull.comp.spv", { m_culling_layout() }, 4 * sizeof(uint32_t) + 2 * sizeof(float), { m_instance_format == InstanceFormat::Affine ? 1u : 0u });
+
+		for (size_t i = 0; i < Renderer::resource_count; ++i) {
+			m_culling_bindings[i] = ShaderBinding{ m_descriptor_allocator.allocate(m_culling_layout) };
+
+			reserve_draw_buffers(i, 1024);
+		}
 	}
 
 	Material Renderer::create_material(const MaterialInfos& infos) {
@@ -77,20 +127,82 @@ namespace Nth {
 		}
 
 		Material material;
-		material.create_pipeline(m_vulkan.get_device().get_handle(), m_render_surface.get_render_pass(), infos.vertexShaderName, infos.fragmentShaderName, vk_descritptor_layouts);
+		material.create_pipeline(m_vulkan.get_device().get_handle(), m_render_surface.get_render_pass(), infos.vertexShaderName, infos.fragmentShaderName, vk_descritptor_layouts, infos.vertexFormat, m_instance_format);
 
 		return material;
 	}
 
+	// Only one of the models is set, cooked textures are decoded along with the file
+	struct Renderer::StreamedModel {
+		std::optional<Model> model;
+		std::optional<CookedModel> cooked;
+		std::vector<Texture> cooked_textures;
+	};
+
 	size_t Renderer::register_model(const Model& model) {
-		std::vector<RenderTexture> textures;
+		m_renders.push_back(create_render_model(model, nullptr));
+
+		return m_renders.size() - 1;
+	}
+
+	size_t Renderer::register_model(const CookedModel& model) {
+		model.prefetch();
+
+		// Decoded straight into staging, pixels never go through a Texture
+		std::vector<std::shared_ptr<const RenderTexture>> textures;
+		for (size_t i = 0; i < model.texture_count(); ++i) {
+			textures.push_back(register_texture_file(model.texture_file(i)));
+		}
+
+		m_renders.push_back(create_render_model(model, std::move(textures), nullptr));
+
+		return m_renders.size() - 1;
+	}
+
+	size_t Renderer::async_load_model(const std::filesystem::path& path, const ImportOptions& options) {
+		m_renders.emplace_back();
+		m_renders.back().status = ModelStatus::Loading;
+
+		ModelUpload upload;
+		upload.model_index = m_renders.size() - 1;
+		upload.loading = m_read_pool->submit([path, options, &pool = *m_read_pool]() {
+			auto streamed = std::make_shared<StreamedModel>();
+			if (path.extension() == ".nthc") {
+				streamed->cooked.emplace(CookedModel::LoadFromFile(path));
+				streamed->cooked->prefetch();
+				streamed->cooked_textures = streamed->cooked->load_textures(pool);
+			}
+			else {
+				streamed->model.emplace(Model::LoadFromFile(path, pool, options));
+			}
+
+			return streamed;
+		});
+
+		m_uploads.push_back(std::move(upload));
+
+		return m_renders.size() - 1;
+	}
+
+	ModelStatus Renderer::model_status(size_t model_index) const {
+		assert(model_index < m_renders.size());
+
+		return m_renders[model_index].status;
+	}
+
+	ReadPool& Renderer::read_pool() {
+		return *m_read_pool;
+	}
+
+	RenderModel Renderer::create_render_model(const Model& model, const Vk::CommandBuffer* transfer_commands) {
+		std::vector<std::shared_ptr<const RenderTexture>> textures;
 		for (const auto& texture : model.textures()) {
-			textures.push_back(register_texture(texture));
+			textures.push_back(register_texture(texture, transfer_commands));
 		}
 
 		std::vector<RenderMesh> meshes;
 		for (const auto& mesh : model.meshes) {
-			RenderMesh RenderMesh{ register_mesh(mesh) };
+			RenderMesh RenderMesh{ register_mesh(mesh, transfer_commands) };
 
 			// TODO: Cleanup
 			RenderMesh.texture_index = 0;
@@ -104,73 +216,184 @@ namespace Nth {
 			meshes.emplace_back(std::move(RenderMesh));
 		}
 
-		m_renders.emplace_back(std::move(meshes), std::move(textures));
+		RenderModel render_model{ std::move(meshes), std::move(textures) };
+		for (const ModelInstance& instance : model.instances) {
+			render_model.instances.push_back(RenderMeshInstance{ instance.mesh_index, instance.transform });
+		}
+
+		return render_model;
+	}
 
-		return m_renders.size() - 1;
+	RenderModel Renderer::create_render_model(const CookedModel& model, std::vector<std::shared_ptr<const RenderTexture>>&& textures, const Vk::CommandBuffer* transfer_commands) {
+		std::vector<RenderMesh> meshes;
+		for (const CookedMesh& mesh : model.meshes()) {
+			RenderMesh render_mesh{ register_mesh(model, mesh, transfer_commands) };
+
+			render_mesh.texture_index = 0;
+			for (uint32_t texture_index : model.texture_indices(mesh)) {
+				if (model.texture_type(texture_index) == "base_color") {
+					render_mesh.texture_index = texture_index;
+					break;
+				}
+			}
+
+			meshes.emplace_back(std::move(render_mesh));
+		}
+
+		RenderModel render_model{ std::move(meshes), std::move(textures) };
+		for (const ModelInstance& instance : model.instances()) {
+			render_model.instances.push_back(RenderMeshInstance{ instance.mesh_index, instance.transform });
+		}
+
+		return render_model;
+	}
+
+	std::vector<RenderObject> Renderer::model_instances(size_t model_index, Material& material, const Matrix4f& transform) const {
+		assert(model_index < m_renders.size());
+
+		const RenderModel& model = m_renders[model_index];
+		if (model.instances.empty()) {
+			return { RenderObject{ model_index, &material, transform } };
+		}
+
+		// Instances share the model's buffers, each one only gets its own transform
+		std::vector<RenderObject> objects;
+		objects.reserve(model.instances.size());
+		for (const RenderMeshInstance& instance : model.instances) {
+			objects.push_back(RenderObject{ model_index, &material, transform * instance.transform, instance.mesh_index });
+		}
+
+		return objects;
+	}
+
+	RenderScene Renderer::create_scene() const {
+		return RenderScene{ Renderer::resource_count };
 	}
 
 	void Renderer::draw(const std::vector<RenderObject>& objects) {
+		// Diffed against the previous call, so unchanged objects are not uploaded again
+		while (m_immediate_handles.size() > objects.size()) {
+			m_immediate_scene.remove(m_immediate_handles.back());
+			m_immediate_handles.pop_back();
+		}
+
+		for (size_t i = 0; i < objects.size(); ++i) {
+			if (i == m_immediate_handles.size()) {
+				m_immediate_handles.push_back(m_immediate_scene.add(objects[i]));
+				continue;
+			}
+
+			const RenderObject& current = m_immediate_scene.get(m_immediate_handles[i]);
+			if (current.model_index != objects[i].model_index || current.mesh_index != objects[i].mesh_index || current.material != objects[i].material || current.transform_matrix != objects[i].transform_matrix || current.spatial_index != objects[i].spatial_index) {
+				m_immediate_scene.set(m_immediate_handles[i], objects[i]);
+			}
+		}
+
+		draw(m_immediate_scene);
+	}
+
+	void Renderer::draw(RenderScene& scene) {
 		assert(m_window != nullptr);
 		RenderingResource& image = m_render_surface.aquire_next_image(m_window->size());
 
+		// The frame which last used this resource waited on their semaphores, its fence was waited on when acquiring
+		m_retired_uploads[m_resource_index].clear();
+		std::vector<VkSemaphore> upload_semaphores = update_streaming();
+
+		if (m_depth_pyramid.depth_size() != m_render_surface.size()) {
+			m_vulkan.get_device().get_handle().wait_idle();
+			m_depth_pyramid.create(m_render_surface.get_depth(), m_render_surface.size());
+		}
+
 		ViewerGpuObject viewer = get_viewer_data();
 
-		// TODO: Move this logic
-		image.prepare([this, &objects, &viewer](Vk::CommandBuffer& command_buffer) {
-			std::vector<ModelGpuObject> storage_objects(objects.size());
-			for (size_t i = 0; i < storage_objects.size(); ++i) {
-				storage_objects[i].model = objects[i].transform_matrix;
-			}
+		const std::vector<RenderObject>& objects = scene.objects();
+		update_spatial_indices(scene);
+		std::vector<size_t> visible_objects = software_cull(scene, viewer);
+		update_lods(objects, visible_objects, viewer);
+
+		upload_objects(scene);
+
+		// One draw per mesh, or per meshlet at full detail, culling only toggles its instance count
+		std::vector<DrawGpuObject> draws;
+		std::vector<VkDrawIndexedIndirectCommand> commands;
+		std::vector<uint32_t> mesh_draw_counts;
+		for (size_t object_index : visible_objects) {
+			// Instance data is indexed by scene slot
+			uint32_t instance = static_cast<uint32_t>(object_index);
+
+			size_t lod_index = m_object_lods[object_index];
+			for (const RenderMesh& mesh : m_renders[objects[object_index].model_index].meshes_of(objects[object_index].mesh_index)) {
+				if (lod_index == 0 && !mesh.meshlets.empty()) {
+					for (const Meshlet& meshlet : mesh.meshlets) {
+						draws.push_back(make_draw(meshlet.bounds, meshlet.center, meshlet.radius, meshlet.cone_axis, meshlet.cone_cutoff, instance));
+						commands.push_back(VkDrawIndexedIndirectCommand{ meshlet.index_count, 1, meshlet.first_index, 0, instance });
+					}
 
-			m_model_buffers[m_resource_index].copy(storage_objects.data(), storage_objects.size() * sizeof(ModelGpuObject));
+					mesh_draw_counts.push_back(static_cast<uint32_t>(mesh.meshlets.size()));
+					continue;
+				}
 
-			m_light_buffers[m_resource_index].copy(&light, sizeof(LightGpuObject));
+				const RenderMeshLod& lod = mesh.lods[std::min(lod_index, mesh.lods.size() - 1)];
 
-			m_viewer_buffers[m_resource_index].copy(&viewer, sizeof(ViewerGpuObject));
+				draws.push_back(make_draw(mesh.bounds, mesh.bounds.center(), mesh.bounds.extent().length(), Vector3f{ 0.f, 0.f, 1.f }, 1.f, instance));
+				commands.push_back(VkDrawIndexedIndirectCommand{ lod.index_count, 1, lod.first_index, 0, instance });
 
-			Material* last_material = nullptr;
-			for (size_t i = 0; i < objects.size(); ++i) {
-				if (objects[i].material != last_material) {
-					command_buffer.bind_pipeline(VK_PIPELINE_BIND_POINT_GRAPHICS, objects[i].material->pipeline());
+				mesh_draw_counts.push_back(1);
+			}
+		}
 
-					VkDescriptorSet vk_descriptor_set = m_viewer_bindings[m_resource_index].descriptor_set()();
-					command_buffer.bind_descriptor_sets(objects[i].material->pipeline_layout(), 0, 1, &vk_descriptor_set, 0, nullptr);
+		reserve_draw_buffers(m_resource_index, draws.size());
 
-					VkDescriptorSet vk_ssbo_descriptor_set = m_model_bindings[m_resource_index].descriptor_set()();
-					command_buffer.bind_descriptor_sets(objects[i].material->pipeline_layout(), 1, 1, &vk_ssbo_descriptor_set, 0, nullptr);
+		m_light_buffers[m_resource_index].copy(&light, sizeof(LightGpuObject));
+		m_viewer_buffers[m_resource_index].copy(&viewer, sizeof(ViewerGpuObject));
+		m_light_clusters.update(m_resource_index, m_viewer_buffers[m_resource_index], point_lights, m_render_surface.size(), Renderer::z_near, Renderer::z_far);
+		m_draw_buffers[m_resource_index].copy(draws.data(), draws.size() * sizeof(DrawGpuObject));
+		m_early_command_buffers[m_resource_index].copy(commands.data(), commands.size() * sizeof(VkDrawIndexedIndirectCommand));
+		m_late_command_buffers[m_resource_index].copy(commands.data(), commands.size() * sizeof(VkDrawIndexedIndirectCommand));
 
-					VkDescriptorSet vk_light_descriptor_set = m_light_bindings[m_resource_index].descriptor_set()();
-					command_buffer.bind_descriptor_sets(objects[i].material->pipeline_layout(), 2, 1, &vk_light_descriptor_set, 0, nullptr);
+		update_culling_descriptor_set();
+		update_light_descriptor_set();
 
-					last_material = objects[i].material;
-				}
+		uint32_t draw_count = static_cast<uint32_t>(draws.size());
 
-				RenderTexture const* last_texture = nullptr;
-				const RenderModel& model = m_renders[objects[i].model_index];
-				for (const RenderMesh& mesh : model.meshes) {
-					VkDeviceSize offset = 0;
-					command_buffer.bind_vertex_buffer(mesh.vertex_buffer.handle(), offset);
+		image.begin();
 
-					command_buffer.bind_index_buffer(mesh.index_buffer.handle(), 0, VK_INDEX_TYPE_UINT32);
+		m_light_clusters.build(image.command_buffer, m_resource_index);
 
-					const RenderTexture& texture{ model.textures[mesh.texture_index] };
-					if (&texture != last_texture) {
-						VkDescriptorSet vk_texture_descriptor_set = texture.binding.descriptor_set()();
-						command_buffer.bind_descriptor_sets(objects[i].material->pipeline_layout(), 3, 1, &vk_texture_descriptor_set, 0, nullptr);
+		// Early pass draws what was visible last frame, then the late pass draws what the new pyramid reveals
+		cull(image.command_buffer, 0, draw_count);
 
-						last_texture = &texture;
-					}
+		image.begin_render_pass(m_render_surface.get_render_pass());
+		record_draws(image.command_buffer, objects, visible_objects, mesh_draw_counts, m_early_command_buffers[m_resource_index]);
+		image.end_render_pass();
 
-					command_buffer.draw_indexed(static_cast<uint32_t>(mesh.indices.size()), 1, 0, 0, static_cast<uint32_t>(i));
-				}
-			}
-		});
+		m_depth_pyramid.build(image.command_buffer);
+
+		cull(image.command_buffer, 1, draw_count);
+
+		image.begin_render_pass(m_render_surface.get_late_render_pass());
+		record_draws(image.command_buffer, objects, visible_objects, mesh_draw_counts, m_late_command_buffers[m_resource_index]);
+		image.end_render_pass();
 
-		image.present(m_window->size());
+		image.end();
+
+		image.present(m_window->size(), upload_semaphores);
 		
 		m_resource_index = (m_resource_index + 1) % Renderer::resource_count;
 	}
 
+	DrawGpuObject Renderer::make_draw(const BoundingBoxf& bounds, const Vector3f& center, float radius, const Vector3f& cone_axis, float cone_cutoff, uint32_t object_index) {
+		return DrawGpuObject{
+			Vector4f{ bounds.min.x, bounds.min.y, bounds.min.z, 1.f },
+			Vector4f{ bounds.max.x, bounds.max.y, bounds.max.z, 1.f },
+			Vector4f{ center.x, center.y, center.z, radius },
+			Vector4f{ cone_axis.x, cone_axis.y, cone_axis.z, cone_cutoff },
+			object_index,
+			{ 0, 0, 0 }
+		};
+	}
+
 	void Renderer::wait_idle() const {
 		m_vulkan.get_device().get_handle().wait_idle();
 	}
@@ -181,7 +404,7 @@ namespace Nth {
 		Vector2ui size = m_render_surface.size();
 
 		ubo.view = camera.get_view_matrix();
-		ubo.proj = Matrix4f::Perspective(to_radians(45.0f), static_cast<float>(size.x) / static_cast<float>(size.y), 0.1f, 10.0f);
+		ubo.proj = Matrix4f::Perspective(to_radians(45.0f), static_cast<float>(size.x) / static_cast<float>(size.y), Renderer::z_near, Renderer::z_far);
 		ubo.proj.a22 *= -1;
 
 		return ubo;
@@ -191,62 +414,478 @@ namespace Nth {
 		for (size_t i = 0; i < Renderer::resource_count; ++i) {
 			UniformBinding viewerUniform{ m_viewer_buffers[i], 0, m_viewer_buffers[i].handle.get_size() };
 			m_viewer_bindings[i].update({ Binding{ viewerUniform, 0 } });
+		}
+	}
+
+	void Renderer::update_light_descriptor_set() {
+		const RenderBuffer& cluster_buffer = m_light_clusters.cluster_buffer(m_resource_index);
+		const RenderBuffer& light_buffer = m_light_clusters.light_buffer(m_resource_index);
+		const RenderBuffer& grid_buffer = m_light_clusters.grid_buffer(m_resource_index);
+		const RenderBuffer& index_buffer = m_light_clusters.index_buffer(m_resource_index);
+
+		UniformBinding light_uniform{ m_light_buffers[m_resource_index], 0, m_light_buffers[m_resource_index].handle.get_size() };
+		UniformBinding cluster_uniform{ cluster_buffer, 0, cluster_buffer.handle.get_size() };
+		StorageBinding light_storage{ light_buffer, 0, light_buffer.handle.get_size() };
+		StorageBinding grid_storage{ grid_buffer, 0, grid_buffer.handle.get_size() };
+		StorageBinding index_storage{ index_buffer, 0, index_buffer.handle.get_size() };
+
+		m_light_bindings[m_resource_index].update({
+			Binding{ light_uniform, 0 },
+			Binding{ cluster_uniform, 1 },
+			Binding{ light_storage, 2 },
+			Binding{ grid_storage, 3 },
+			Binding{ index_storage, 4 }
+		});
+	}
+
+	std::vector<VkSemaphore> Renderer::update_streaming() {
+		std::vector<VkSemaphore> upload_semaphores;
 
-			StorageBinding modelStorage{ m_model_buffers[i], 0, m_model_buffers[i].handle.get_size() };
-			m_model_bindings[i].update({ Binding{ modelStorage, 0 } });
+		for (auto it = m_uploads.begin(); it != m_uploads.end();) {
+			ModelUpload& upload = *it;
+			RenderModel& model = m_renders[upload.model_index];
+
+			try {
+				if (model.status == ModelStatus::Loading) {
+					if (upload.loading.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+						start_upload(upload);
+					}
 
-			UniformBinding lightUniform{ m_light_buffers[i], 0, m_light_buffers[i].handle.get_size() };
-			m_light_bindings[i].update({ Binding{ lightUniform, 0 } });
+					++it;
+					continue;
+				}
+
+				if (!upload.fence.is_signaled()) {
+					++it;
+					continue;
+				}
+			}
+			catch (const std::exception& e) {
+				std::cerr << "Error: can't load model " << upload.model_index << ", " << e.what() << std::endl;
+				model.status = ModelStatus::Failed;
+				it = m_uploads.erase(it);
+				continue;
+			}
+
+			model.meshes = std::move(upload.model.meshes);
+			model.textures = std::move(upload.model.textures);
+			model.bounds = upload.model.bounds;
+			model.instances = std::move(upload.model.instances);
+			model.status = ModelStatus::Resident;
+			share_resources(model);
+
+			// Bounds of objects already in the scene changed, the spatial indices are built again
+			m_spatial_scene = 0;
+
+			upload_semaphores.push_back(upload.semaphore());
+			m_retired_uploads[m_resource_index].push_back(std::move(upload));
+			it = m_uploads.erase(it);
 		}
+
+		return upload_semaphores;
 	}
 
-	size_t Renderer::add_descriptor_set_layout(const std::vector<BindingInfo>& bindings) {
-		// Use "set" information
-		std::vector<VkDescriptorSetLayoutBinding> layout_bindings;
-		for (const auto& binding : bindings) {
-			VkDescriptorSetLayoutBinding layout_binding;
-			layout_binding.binding = binding.binding_index;
-
-			switch (binding.binding_type) {
-			case BindingType::Uniform:
-				layout_binding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-				break;
-			case BindingType::Texture:
-				layout_binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-				break;
-			case BindingType::Storage:
-				layout_binding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-				break;
+	void Renderer::start_upload(ModelUpload& upload) {
+		std::shared_ptr<StreamedModel> streamed = upload.loading.get();
+		const RenderDevice& device = m_vulkan.get_device();
+
+		VkCommandBufferBeginInfo command_buffer_begin_info = {
+			VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO, // VkStructureType              sType
+			nullptr,                                     // const void                  *pNext
+			VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, // VkCommandBufferUsageFlags    flags
+			nullptr                                      // const VkCommandBufferInheritanceInfo  *pInheritanceInfo
+		};
+
+		// Every copy of the model goes in one submit
+		upload.command_buffer = device.allocate_transfer_command_buffer();
+		upload.command_buffer.begin(command_buffer_begin_info);
+
+		if (streamed->cooked) {
+			std::vector<std::shared_ptr<const RenderTexture>> textures;
+			for (const Texture& texture : streamed->cooked_textures) {
+				textures.push_back(register_texture(texture, &upload.command_buffer));
+			}
+
+			upload.model = create_render_model(*streamed->cooked, std::move(textures), &upload.command_buffer);
+		}
+		else {
+			upload.model = create_render_model(*streamed->model, &upload.command_buffer);
+		}
+
+		upload.command_buffer.end();
+
+		upload.fence.create(device.get_handle(), 0);
+		upload.semaphore.create(device.get_handle());
+
+		VkCommandBuffer vk_command_buffer = upload.command_buffer();
+		VkSemaphore vk_semaphore = upload.semaphore();
+		VkSubmitInfo submit_info = {
+			VK_STRUCTURE_TYPE_SUBMIT_INFO,    // VkStructureType    sType
+			nullptr,                          // const void        *pNext
+			0,                                // uint32_t           waitSemaphoreCount
+			nullptr,                          // const VkSemaphore *pWaitSemaphores
+			nullptr,                          // const VkPipelineStageFlags *pWaitDstStageMask;
+			1,                                // uint32_t           commandBufferCount
+			&vk_command_buffer,               // const VkCommandBuffer *pCommandBuffers
+			1,                                // uint32_t           signalSemaphoreCount
+			&vk_semaphore                     // const VkSemaphore *pSignalSemaphores
+		};
+
+		device.transfer_queue().submit(submit_info, upload.fence());
+
+		m_renders[upload.model_index].status = ModelStatus::Uploading;
+	}
+
+	const BoundingVolumeHierarchy& Renderer::scene_bvh(RenderScene& scene) {
+		update_spatial_indices(scene);
+
+		return m_scene_bvh;
+	}
+
+	const LooseOctree& Renderer::scene_octree(RenderScene& scene) {
+		update_spatial_indices(scene);
+
+		return m_scene_octree;
+	}
+
+	void Renderer::update_spatial_indices(RenderScene& scene) {
+		const std::vector<RenderObject>& objects = scene.objects();
+
+		if (m_spatial_scene != scene.id() || m_octree_region != octree_region) {
+			scene.take_changed_slots();
+
+			m_scene_octree = LooseOctree{ octree_region };
+			m_octree_region = octree_region;
+
+			std::vector<BoundingBoxf> bounds(objects.size());
+			for (size_t i = 0; i < objects.size(); ++i) {
+				if (!scene.is_alive(i)) {
+					continue;
+				}
+
+				if (objects[i].spatial_index == SpatialIndex::LooseOctree) {
+					m_scene_octree.set(static_cast<uint32_t>(i), world_bounds(objects[i]));
+				}
+				else {
+					bounds[i] = world_bounds(objects[i]);
+				}
+			}
+
+			m_scene_bvh.build(bounds);
+			m_spatial_scene = scene.id();
+
+			return;
+		}
+
+		// An object is only in one of them, an empty box takes it out of the other
+		for (uint32_t slot : scene.take_changed_slots()) {
+			BoundingBoxf bounds = scene.is_alive(slot) ? world_bounds(objects[slot]) : BoundingBoxf{};
+			bool in_octree = objects[slot].spatial_index == SpatialIndex::LooseOctree;
+
+			m_scene_bvh.set(slot, in_octree ? BoundingBoxf{} : bounds);
+			m_scene_octree.set(slot, in_octree ? bounds : BoundingBoxf{});
+		}
+
+		m_scene_bvh.refresh();
+		m_scene_octree.refresh();
+	}
+
+	BoundingBoxf Renderer::world_bounds(const RenderObject& object) const {
+		return m_renders[object.model_index].bounds_of(object.mesh_index).transform(object.transform_matrix);
+	}
+
+	std::vector<size_t> Renderer::software_cull(const RenderScene& scene, const ViewerGpuObject& viewer) {
+		const std::vector<RenderObject>& objects = scene.objects();
+		Matrix4f view_projection = viewer.proj * viewer.view;
+
+		std::vector<uint32_t> slots;
+		slots.reserve(scene.size());
+		m_scene_bvh.cull(view_projection, slots);
+		m_scene_octree.cull(view_projection, slots);
+
+		if (software_occlusion_culling) {
+			Vector2ui size = m_render_surface.size();
+			m_occlusion_buffer.resize(Renderer::occlusion_buffer_width, Renderer::occlusion_buffer_width * size.y / std::max(size.x, 1u));
+			m_occlusion_buffer.begin(view_projection);
+
+			// Occluders outside the frustum can't hide anything
+			for (uint32_t slot : slots) {
+				for (const RenderMesh& mesh : m_renders[objects[slot].model_index].meshes_of(objects[slot].mesh_index)) {
+					if (!mesh.occluder_vertices.empty()) {
+						m_occlusion_buffer.add_occluder(mesh.occluder_vertices, mesh.indices, objects[slot].transform_matrix);
+					}
+				}
+			}
+
+			m_occlusion_buffer.rasterize(m_read_pool.get());
+
+			// Walked again so a hidden node rejects its whole subtree
+			auto visible = [&](const BoundingBoxf& bounds) {
+				return m_occlusion_buffer.is_visible(bounds, Matrix4f::Identity());
+			};
+
+			slots.clear();
+			m_scene_bvh.cull(view_projection, slots, visible);
+			m_scene_octree.cull(view_projection, slots, visible);
+		}
+
+		// Slot order keeps the draws in the order objects were uploaded
+		std::sort(slots.begin(), slots.end());
+
+		return std::vector<size_t>(slots.begin(), slots.end());
+	}
+
+	void Renderer::update_lods(const std::vector<RenderObject>& objects, const std::vector<size_t>& visible_objects, const ViewerGpuObject& viewer) {
+		m_object_lods.resize(objects.size(), 0);
+
+		Matrix4f inverse_view = viewer.view.inv();
+		Vector3f camera_position{ inverse_view.a41, inverse_view.a42, inverse_view.a43 };
+
+		// Size of a world unit on screen at distance 1, must match the projection of get_viewer_data
+		float pixels_per_unit = static_cast<float>(m_render_surface.size().y) / (2.f * std::tan(to_radians(45.0f) * 0.5f));
+
+		std::vector<float> level_errors;
+		for (size_t object_index : visible_objects) {
+			const RenderObject& object = objects[object_index];
+			const RenderModel& model = m_renders[object.model_index];
+			const BoundingBoxf& bounds = model.bounds_of(object.mesh_index);
+
+			// Errors are taken at the worst mesh of the model, so every mesh switches at once
+			level_errors.clear();
+			for (const RenderMesh& mesh : model.meshes_of(object.mesh_index)) {
+				level_errors.resize(std::max(level_errors.size(), mesh.lods.size()), 0.f);
+			}
+			for (const RenderMesh& mesh : model.meshes_of(object.mesh_index)) {
+				for (size_t i = 0; i < level_errors.size(); ++i) {
+					level_errors[i] = std::max(level_errors[i], mesh.lods[std::min(i, mesh.lods.size() - 1)].error);
+				}
+			}
+
+			if (level_errors.size() <= 1 || !bounds.is_valid()) {
+				m_object_lods[object_index] = 0;
+				continue;
 			}
 
-			layout_binding.descriptorCount = 1;
+			BoundingBoxf world_bounds = bounds.transform(object.transform_matrix);
+			float local_radius = bounds.extent().length();
+			float world_radius = world_bounds.extent().length();
+			float distance = (world_bounds.center() - camera_position).length();
 
-			switch (binding.shader_type) {
-			case ShaderType::Vertex:
-				layout_binding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
-				break;
-			case ShaderType::Fragment:
-				layout_binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
-				break;
+			if (distance <= world_radius || local_radius <= 0.f) {
+				m_object_lods[object_index] = 0;
+				continue;
 			}
 
-			layout_binding.pImmutableSamplers = nullptr;
+			float scale = world_radius / local_radius;
+			m_object_lods[object_index] = select_lod(level_errors, scale * pixels_per_unit / distance, lod_pixel_error, lod_hysteresis, m_object_lods[object_index]);
+		}
+	}
+
+	void Renderer::update_culling_descriptor_set() {
+		UniformBinding viewer_uniform{ m_viewer_buffers[m_resource_index], 0, m_viewer_buffers[m_resource_index].handle.get_size() };
+		StorageBinding model_storage{ m_model_buffers[m_resource_index], 0, m_model_buffers[m_resource_index].handle.get_size() };
+		StorageBinding draw_storage{ m_draw_buffers[m_resource_index], 0, m_draw_buffers[m_resource_index].handle.get_size() };
+		StorageBinding early_storage{ m_early_command_buffers[m_resource_index], 0, m_early_command_buffers[m_resource_index].handle.get_size() };
+		StorageBinding late_storage{ m_late_command_buffers[m_resource_index], 0, m_late_command_buffers[m_resource_index].handle.get_size() };
+		ImageBinding depth_pyramid{ m_depth_pyramid.view(), m_depth_pyramid.sampler(), VK_IMAGE_LAYOUT_GENERAL };
+
+		m_culling_bindings[m_resource_index].update({
+			Binding{ viewer_uniform, 0 },
+			Binding{ model_storage, 1 },
+			Binding{ draw_storage, 2 },
+			Binding{ early_storage, 3 },
+			Binding{ late_storage, 4 },
+			Binding{ depth_pyramid, 5 }
+		});
+	}
+
+	void Renderer::reserve_draw_buffers(size_t index, size_t draw_count) {
+		if (m_draw_buffers[index].handle.get_size() >= draw_count * sizeof(DrawGpuObject)) {
+			return;
+		}
+
+		size_t capacity = std::max<size_t>(draw_count, m_draw_buffers[index].handle.get_size() / sizeof(DrawGpuObject) * 2);
+
+		m_draw_buffers[index] = RenderBuffer{
+			m_vulkan.get_device(),
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+			capacity * sizeof(DrawGpuObject)
+		};
+
+		m_early_command_buffers[index] = RenderBuffer{
+			m_vulkan.get_device(),
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+			capacity * sizeof(VkDrawIndexedIndirectCommand)
+		};
+
+		m_late_command_buffers[index] = RenderBuffer{
+			m_vulkan.get_device(),
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+			capacity * sizeof(VkDrawIndexedIndirectCommand)
+		};
+	}
+
+	bool Renderer::reserve_model_buffer(size_t index, size_t object_count) {
+		const size_t object_size = m_instance_format == InstanceFormat::Affine ? sizeof(AffineModelGpuObject) : sizeof(ModelGpuObject);
+		const size_t capacity = m_model_buffers[index].handle.get_size() / object_size;
+
+		size_t new_capacity = capacity;
+		if (object_count > capacity) {
+			new_capacity = std::max({ object_count, capacity * 2, Renderer::min_object_capacity });
+			m_model_buffer_idle_frames[index] = 0;
+		}
+		else if (capacity > Renderer::min_object_capacity && object_count <= capacity / 4) {
+			// Only shrink after a while, a scene going back and forth would reallocate every frame
+			if (++m_model_buffer_idle_frames[index] >= Renderer::model_buffer_shrink_frames) {
+				new_capacity = std::max(object_count * 2, Renderer::min_object_capacity);
+				m_model_buffer_idle_frames[index] = 0;
+			}
+		}
+		else {
+			m_model_buffer_idle_frames[index] = 0;
+		}
+
+		if (new_capacity == capacity) {
+			return false;
+		}
+
+		// The frame that last used this buffer is done, its fence was waited on when acquiring
+		m_model_buffers[index] = RenderBuffer{
+			m_vulkan.get_device(),
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+			new_capacity * object_size
+		};
+
+		StorageBinding model_storage{ m_model_buffers[index], 0, m_model_buffers[index].handle.get_size() };
+		m_model_bindings[index].update({ Binding{ model_storage, 0 } });
+
+		return true;
+	}
+
+	void Renderer::upload_objects(RenderScene& scene) {
+		assert(scene.frame_count() == Renderer::resource_count);
+
+		std::vector<RenderSceneRange> ranges = scene.take_dirty_ranges(m_resource_index);
+
+		// A new buffer, or one last filled from another scene, needs every slot
+		bool reallocated = reserve_model_buffer(m_resource_index, scene.slot_count());
+		if (reallocated || m_model_buffer_scenes[m_resource_index] != scene.id()) {
+			ranges = { RenderSceneRange{ 0, static_cast<uint32_t>(scene.slot_count()) } };
+			m_model_buffer_scenes[m_resource_index] = scene.id();
+		}
+
+		const std::vector<RenderObject>& objects = scene.objects();
+		for (const RenderSceneRange& range : ranges) {
+			if (m_instance_format == InstanceFormat::Affine) {
+				std::vector<AffineModelGpuObject> storage_objects(range.count);
+				for (uint32_t i = 0; i < range.count; ++i) {
+					storage_objects[i] = make_affine_model(objects[range.first + i].transform_matrix);
+				}
+
+				m_model_buffers[m_resource_index].copy(storage_objects.data(), storage_objects.size() * sizeof(AffineModelGpuObject), range.first * sizeof(AffineModelGpuObject));
+			}
+			else {
+				std::vector<ModelGpuObject> storage_objects(range.count);
+				for (uint32_t i = 0; i < range.count; ++i) {
+					storage_objects[i].model = objects[range.first + i].transform_matrix;
+				}
+				compute_normal_matrices(storage_objects);
 
-			layout_bindings.push_back(std::move(layout_binding));
+				m_model_buffers[m_resource_index].copy(storage_objects.data(), storage_objects.size() * sizeof(ModelGpuObject), range.first * sizeof(ModelGpuObject));
+			}
 		}
+	}
 
-		VkDescriptorSetLayoutCreateInfo descriptor_set_layout_create_info = {
-			VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,   // VkStructureType                      sType
-			nullptr,                                               // const void                          *pNext
-			0,                                                     // VkDescriptorSetLayoutCreateFlags     flags
-			static_cast<uint32_t>(layout_bindings.size()),         // uint32_t                             bindingCount
-			layout_bindings.data()                                 // const VkDescriptorSetLayoutBinding  *pBindings
+	void Renderer::cull(const Vk::CommandBuffer& command_buffer, uint32_t phase, uint32_t draw_count) const {
+		struct CullingConstants {
+			uint32_t draw_count;
+			uint32_t phase;
+			uint32_t occlusion_enabled;
+			uint32_t cone_culling;
+			float pyramid_width;
+			float pyramid_height;
 		};
 
-		Vk::DescriptorSetLayout layout;
-		layout.create(m_vulkan.get_device().get_handle(), descriptor_set_layout_create_info);
+		command_buffer.bind_pipeline(VK_PIPELINE_BIND_POINT_COMPUTE, m_culling.pipeline());
+
+		VkDescriptorSet vk_descriptor_set = m_culling_bindings[m_resource_index].descriptor_set()();
+		command_buffer.bind_descriptor_sets(VK_PIPELINE_BIND_POINT_COMPUTE, m_culling.pipeline_layout(), 0, 1, &vk_descriptor_set, 0, nullptr);
+
+		const Vector2ui& pyramid_size = m_depth_pyramid.size();
+		CullingConstants constants{
+			draw_count,
+			phase,
+			occlusion_culling ? 1u : 0u,
+			cluster_cone_culling ? 1u : 0u,
+			static_cast<float>(pyramid_size.x),
+			static_cast<float>(pyramid_size.y)
+		};
+		command_buffer.push_constants(m_culling.pipeline_layout(), VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(CullingConstants), &constants);
 
-		m_descriptor_set_layouts.push_back(std::move(layout));
+		command_buffer.dispatch((draw_count + 63) / 64, 1, 1);
+
+		VkMemoryBarrier memory_barrier = {
+			VK_STRUCTURE_TYPE_MEMORY_BARRIER,                               // VkStructureType           sType
+			nullptr,                                                        // const void               *pNext
+			VK_ACCESS_SHADER_WRITE_BIT,                                     // VkAccessFlags             srcAccessMask
+			VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT // VkAccessFlags             dstAccessMask
+		};
+		command_buffer.pipeline_barrier(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memory_barrier, 0, nullptr, 0, nullptr);
+	}
+
+	void Renderer::record_draws(const Vk::CommandBuffer& command_buffer, const std::vector<RenderObject>& objects, const std::vector<size_t>& visible_objects, const std::vector<uint32_t>& mesh_draw_counts, const RenderBuffer& commands) const {
+		size_t mesh_index = 0;
+		size_t draw_index = 0;
+		Material* last_material = nullptr;
+		for (size_t i = 0; i < visible_objects.size(); ++i) {
+			const RenderObject& object = objects[visible_objects[i]];
+			if (object.material != last_material) {
+				command_buffer.bind_pipeline(VK_PIPELINE_BIND_POINT_GRAPHICS, object.material->pipeline());
+
+				VkDescriptorSet vk_descriptor_set = m_viewer_bindings[m_resource_index].descriptor_set()();
+				command_buffer.bind_descriptor_sets(object.material->pipeline_layout(), 0, 1, &vk_descriptor_set, 0, nullptr);
+
+				VkDescriptorSet vk_ssbo_descriptor_set = m_model_bindings[m_resource_index].descriptor_set()();
+				command_buffer.bind_descriptor_sets(object.material->pipeline_layout(), 1, 1, &vk_ssbo_descriptor_set, 0, nullptr);
+
+				VkDescriptorSet vk_light_descriptor_set = m_light_bindings[m_resource_index].descriptor_set()();
+				command_buffer.bind_descriptor_sets(object.material->pipeline_layout(), 2, 1, &vk_light_descriptor_set, 0, nullptr);
+
+				last_material = object.material;
+			}
+
+			RenderTexture const* last_texture = nullptr;
+			const RenderModel& model = m_renders[object.model_index];
+			for (const RenderMesh& mesh : model.meshes_of(object.mesh_index)) {
+				VkDeviceSize offset = 0;
+				command_buffer.bind_vertex_buffer(mesh.geometry->vertex_buffer.handle(), offset);
+
+				command_buffer.bind_index_buffer(mesh.geometry->index_buffer.handle(), 0, mesh.index_type);
+
+				assert(mesh.vertex_format == object.material->vertex_format);
+				command_buffer.push_constants(object.material->pipeline_layout(), VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(MeshGpuObject), &mesh.parameters);
+
+				const RenderTexture& texture{ *model.textures[mesh.texture_index] };
+				if (&texture != last_texture) {
+					VkDescriptorSet vk_texture_descriptor_set = texture.binding.descriptor_set()();
+					command_buffer.bind_descriptor_sets(object.material->pipeline_layout(), 3, 1, &vk_texture_descriptor_set, 0, nullptr);
+
+					last_texture = &texture;
+				}
+
+				uint32_t draw_count = mesh_draw_counts[mesh_index++];
+				command_buffer.draw_indexed_indirect(commands.handle(), draw_index * sizeof(VkDrawIndexedIndirectCommand), draw_count, sizeof(VkDrawIndexedIndirectCommand));
+				draw_index += draw_count;
+			}
+		}
+	}
+
+	size_t Renderer::add_descriptor_set_layout(const std::vector<BindingInfo>& bindings) {
+		m_descriptor_set_layouts.push_back(create_descriptor_set_layout(m_vulkan.get_device().get_handle(), bindings));
 
 		return m_descriptor_set_layouts.size() - 1;
 	}
@@ -257,56 +896,246 @@ namespace Nth {
 		return ShaderBinding(m_descriptor_allocator.allocate(m_descriptor_set_layouts[index]));
 	}
 
-	RenderMesh Renderer::register_mesh(const Mesh& mesh) const {
+	RenderMesh Renderer::register_mesh(const Mesh& mesh, const Vk::CommandBuffer* transfer_commands) {
+		RenderMesh registered_mesh;
+
+		std::vector<uint32_t> indices = mesh.indices;
+		registered_mesh.lods.push_back(RenderMeshLod{ 0, static_cast<uint32_t>(mesh.indices.size()), 0.f });
+		for (const MeshLod& lod : mesh.lods) {
+			registered_mesh.lods.push_back(RenderMeshLod{ static_cast<uint32_t>(indices.size()), static_cast<uint32_t>(lod.indices.size()), lod.error });
+			indices.insert(indices.end(), lod.indices.begin(), lod.indices.end());
+		}
+
+		IndexFormat index_format = mesh.index_format();
+		std::vector<uint8_t> packed_indices = Mesh::pack_indices(indices, index_format);
+		registered_mesh.index_type = index_format == IndexFormat::UInt16 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+
+		if (!mesh.quantized_vertices.empty()) {
+			const Vector3f& min = mesh.bounds.min;
+			const Vector3f& max = mesh.bounds.max;
+			registered_mesh.vertex_format = VertexFormat::Quantized;
+			registered_mesh.parameters = MeshGpuObject{ Vector4f{ min.x, min.y, min.z, 0.f }, Vector4f{ max.x - min.x, max.y - min.y, max.z - min.z, 0.f } };
+			registered_mesh.geometry = register_geometry(mesh.quantized_vertices.data(), mesh.quantized_vertices.size() * sizeof(mesh.quantized_vertices[0]), packed_indices.data(), packed_indices.size(), registered_mesh.vertex_format, index_format, transfer_commands);
+		}
+		else {
+			registered_mesh.vertex_format = VertexFormat::Full;
+			registered_mesh.parameters = MeshGpuObject{ Vector4f{ 0.f, 0.f, 0.f, 0.f }, Vector4f{ 1.f, 1.f, 1.f, 0.f } };
+			registered_mesh.geometry = register_geometry(mesh.vertices.data(), mesh.vertices.size() * sizeof(mesh.vertices[0]), packed_indices.data(), packed_indices.size(), registered_mesh.vertex_format, index_format, transfer_commands);
+		}
+
+		registered_mesh.indices = mesh.indices;
+		registered_mesh.meshlets = mesh.meshlets;
+		registered_mesh.bounds = mesh.bounds;
+
+		if (mesh.occluder) {
+			for (const Vertex& vertex : mesh.vertices) {
+				registered_mesh.occluder_vertices.push_back(vertex.pos);
+			}
+		}
+
+		return registered_mesh;
+	}
+
+	RenderMesh Renderer::register_mesh(const CookedModel& model, const CookedMesh& mesh, const Vk::CommandBuffer* transfer_commands) {
 		RenderMesh registered_mesh;
 
-		registered_mesh.vertex_buffer = RenderBuffer{
+		registered_mesh.geometry = register_geometry(model.vertices(mesh), mesh.vertices_size, model.indices(mesh), mesh.indices_size, mesh.vertex_format, mesh.index_format, transfer_commands);
+		registered_mesh.vertex_format = mesh.vertex_format;
+		registered_mesh.index_type = mesh.index_format == IndexFormat::UInt16 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+
+		if (mesh.vertex_format == VertexFormat::Quantized) {
+			const Vector3f& min = mesh.bounds.min;
+			const Vector3f& max = mesh.bounds.max;
+			registered_mesh.parameters = MeshGpuObject{ Vector4f{ min.x, min.y, min.z, 0.f }, Vector4f{ max.x - min.x, max.y - min.y, max.z - min.z, 0.f } };
+		}
+		else {
+			registered_mesh.parameters = MeshGpuObject{ Vector4f{ 0.f, 0.f, 0.f, 0.f }, Vector4f{ 1.f, 1.f, 1.f, 0.f } };
+		}
+
+		for (const CookedLod& lod : model.lods(mesh)) {
+			registered_mesh.lods.push_back(RenderMeshLod{ lod.first_index, lod.index_count, lod.error });
+		}
+
+		registered_mesh.meshlets = model.meshlets(mesh);
+		registered_mesh.bounds = mesh.bounds;
+
+		// Indices are only needed on CPU by occluders
+		if (mesh.occluder) {
+			registered_mesh.indices = model.unpack_indices(mesh);
+			registered_mesh.occluder_vertices = model.unpack_positions(mesh);
+		}
+
+		return registered_mesh;
+	}
+
+	std::shared_ptr<const RenderGeometry> Renderer::register_geometry(const void* vertices, size_t vertices_size, const void* indices, size_t indices_size, VertexFormat vertex_format, IndexFormat index_format, const Vk::CommandBuffer* transfer_commands) {
+		// Imported and cooked meshes hash the same bytes, so they share buffers too
+		struct GeometryKey {
+			ContentHash vertices;
+			ContentHash indices;
+			uint64_t vertices_size;
+			uint64_t indices_size;
+			uint32_t vertex_format;
+			uint32_t index_format;
+		};
+
+		GeometryKey key{};
+		key.vertices = hash_content(vertices, vertices_size);
+		key.indices = hash_content(indices, indices_size);
+		key.vertices_size = vertices_size;
+		key.indices_size = indices_size;
+		key.vertex_format = static_cast<uint32_t>(vertex_format);
+		key.index_format = static_cast<uint32_t>(index_format);
+		ContentHash content_hash = hash_content(&key, sizeof(GeometryKey));
+
+		auto cached = m_geometry_cache.find(content_hash);
+		if (cached != m_geometry_cache.end()) {
+			std::shared_ptr<const RenderGeometry> geometry = cached->second.lock();
+			if (geometry && geometry->vertices_size == vertices_size && geometry->indices_size == indices_size) {
+				return geometry;
+			}
+		}
+
+		auto geometry = std::make_shared<RenderGeometry>();
+		geometry->content_hash = content_hash;
+		geometry->vertices_size = vertices_size;
+		geometry->indices_size = indices_size;
+
+		geometry->vertex_buffer = RenderBuffer{
 			m_vulkan.get_device(),
 			VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
 			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-			static_cast<uint32_t>(mesh.vertices.size() * sizeof(mesh.vertices[0]))
+			vertices_size
 		};
 
-		registered_mesh.vertex_buffer.copy(mesh.vertices.data(), registered_mesh.vertex_buffer.handle.get_size());
+		upload(geometry->vertex_buffer, vertices, vertices_size, transfer_commands);
 
-		registered_mesh.index_buffer = RenderBuffer{
+		geometry->index_buffer = RenderBuffer{
 			m_vulkan.get_device(),
 			VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
 			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-			sizeof(mesh.indices[0]) * mesh.indices.size()
+			indices_size
 		};
 
-		registered_mesh.index_buffer.copy(mesh.indices.data(), registered_mesh.index_buffer.handle.get_size());
+		upload(geometry->index_buffer, indices, indices_size, transfer_commands);
 
-		registered_mesh.indices = mesh.indices;
+		// A recorded upload is only shared once its fence signaled
+		if (!transfer_commands) {
+			m_geometry_cache[content_hash] = geometry;
+		}
 
-		return registered_mesh;
+		return geometry;
 	}
 
-	RenderTexture Renderer::register_texture(const Texture& texture) {
-		RenderTexture registered_texture;
+	std::shared_ptr<const RenderTexture> Renderer::register_texture(const Texture& texture, const Vk::CommandBuffer* transfer_commands) {
+		// Decoded textures come hashed from the loading threads
+		ContentHash content_hash = texture.content_hash != ContentHash{} ? texture.content_hash : texture_content_hash(texture);
 
-		registered_texture.create(
+		if (std::shared_ptr<const RenderTexture> cached = cached_texture(content_hash, texture.width, texture.height)) {
+			return cached;
+		}
+
+		std::shared_ptr<RenderTexture> registered_texture = create_texture(texture.width, texture.height, texture.data.size(), content_hash);
+
+		if (transfer_commands) {
+			registered_texture->image.upload(*transfer_commands, texture.data.data(), static_cast<uint32_t>(texture.data.size()), texture.width, texture.height);
+		}
+		else {
+			registered_texture->image.copy(texture.data.data(), static_cast<uint32_t>(texture.data.size()), texture.width, texture.height);
+			m_texture_cache[content_hash] = registered_texture;
+		}
+
+		return registered_texture;
+	}
+
+	std::shared_ptr<const RenderTexture> Renderer::register_texture_file(const std::filesystem::path& path) {
+		// Hashed, read and decoded from the same mapping
+		AssetFile file = AssetFile::Open(path);
+		file.advise(MappedFile::Access::Sequential);
+
+		// Pixels are only known once they are in staging, the file bytes give the same key texture_from_file does
+		ContentHash content_hash = texture_file_hash(file);
+
+		ImageInfo info = Image::ReadInfo(file, path, PixelChannel::Rgba);
+		if (std::shared_ptr<const RenderTexture> cached = cached_texture(content_hash, info.width, info.height)) {
+			return cached;
+		}
+
+		size_t size = static_cast<size_t>(info.width) * info.height * info.channels;
+
+		std::shared_ptr<RenderTexture> registered_texture = create_texture(info.width, info.height, size, content_hash);
+
+		registered_texture->image.stage(size, [&](void* staging) {
+			Image::LoadFromFileInto(file, path, PixelChannel::Rgba, staging, size);
+		});
+		registered_texture->image.copy_staged(info.width, info.height);
+
+		m_texture_cache[content_hash] = registered_texture;
+
+		return registered_texture;
+	}
+
+	std::shared_ptr<const RenderTexture> Renderer::cached_texture(const ContentHash& content_hash, uint32_t width, uint32_t height) const {
+		auto cached = m_texture_cache.find(content_hash);
+		if (cached == m_texture_cache.end()) {
+			return nullptr;
+		}
+
+		std::shared_ptr<const RenderTexture> texture = cached->second.lock();
+		return texture && texture->width == width && texture->height == height ? texture : nullptr;
+	}
+
+	std::shared_ptr<RenderTexture> Renderer::create_texture(uint32_t width, uint32_t height, size_t size, const ContentHash& content_hash) {
+		// Created in place, the shader binding refers to it
+		auto registered_texture = std::make_shared<RenderTexture>();
+		registered_texture->content_hash = content_hash;
+		registered_texture->width = width;
+		registered_texture->height = height;
+
+		registered_texture->create(
 			m_vulkan.get_device(),
-			texture.width,
-			texture.height,
-			static_cast<uint32_t>(texture.data.size()),
+			width,
+			height,
+			size,
 			VK_FORMAT_R8G8B8A8_UNORM,
 			VK_IMAGE_TILING_OPTIMAL,
 			VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
 			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
 		);
 
-		registered_texture.create_view(VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_ASPECT_COLOR_BIT);
-
-		registered_texture.image.copy(texture.data.data(), static_cast<uint32_t>(texture.data.size()), texture.width, texture.height);
+		registered_texture->create_view(VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_ASPECT_COLOR_BIT);
 
 		// TODO: descriptor set layout index hardcoded
-		registered_texture.binding = allocate_shader_binding(3);
+		registered_texture->binding = allocate_shader_binding(3);
 
-		TextureBinding textureBind{ registered_texture, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
-		registered_texture.binding.update({ Binding{ textureBind, 0 } });
+		TextureBinding textureBind{ *registered_texture, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+		registered_texture->binding.update({ Binding{ textureBind, 0 } });
 
 		return registered_texture;
 	}
+
+	void Renderer::share_resources(const RenderModel& model) {
+		for (const RenderMesh& mesh : model.meshes) {
+			std::weak_ptr<const RenderGeometry>& cached = m_geometry_cache[mesh.geometry->content_hash];
+			if (cached.expired()) {
+				cached = mesh.geometry;
+			}
+		}
+
+		for (const std::shared_ptr<const RenderTexture>& texture : model.textures) {
+			std::weak_ptr<const RenderTexture>& cached = m_texture_cache[texture->content_hash];
+			if (cached.expired()) {
+				cached = texture;
+			}
+		}
+	}
+
+	void Renderer::upload(RenderBuffer& buffer, const void* data, size_t size, const Vk::CommandBuffer* transfer_commands) {
+		if (transfer_commands) {
+			buffer.upload(*transfer_commands, data, size);
+		}
+		else {
+			buffer.copy(data, size);
+		}
+	}
 }
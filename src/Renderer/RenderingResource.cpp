@@ -28,6 +28,19 @@ namespace Nth {
 	}
 
 	void RenderingResource::prepare(std::function<void(Vk::CommandBuffer&)> action) {
+		begin();
+
+		begin_render_pass(m_surface.get_render_pass());
+		action(command_buffer);
+		end_render_pass();
+
+		begin_render_pass(m_surface.get_late_render_pass());
+		end_render_pass();
+
+		end();
+	}
+
+	void RenderingResource::begin() {
 		VkCommandBufferBeginInfo command_buffer_begin_info = {
 			VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,        // VkStructureType                        sType
 			nullptr,                                            // const void                            *pNext
@@ -63,7 +76,9 @@ namespace Nth {
 
 			command_buffer.pipeline_barrier(VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier_from_present_to_draw);
 		}
+	}
 
+	void RenderingResource::begin_render_pass(const Vk::RenderPass& render_pass) {
 		std::vector<VkClearValue> clear_values(2);
 		clear_values[0].color = { 1.0f, 0.8f, 0.4f, 0.0f };
 		clear_values[1].depthStencil = { 1.0f, 0 };
@@ -73,7 +88,7 @@ namespace Nth {
 		VkRenderPassBeginInfo render_pass_begin_info = {
 			VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,           // VkStructureType                        sType
 			nullptr,                                            // const void                            *pNext
-			m_surface.get_render_pass()(),                      // VkRenderPass                           renderPass
+			render_pass(),                                      // VkRenderPass                           renderPass
 			framebuffer(),                                      // VkFramebuffer                          framebuffer
 			{                                                   // VkRect2D                               renderArea
 				{                                                  // VkOffset2D                             offset
@@ -113,10 +128,22 @@ namespace Nth {
 
 		command_buffer.set_viewport(viewport);
 		command_buffer.set_scissor(scissor);
+	}
 
-		action(command_buffer);
-
+	void RenderingResource::end_render_pass() {
 		command_buffer.end_render_pass();
+	}
+
+	void RenderingResource::end() {
+		VkImageSubresourceRange image_subresource_range = {
+			VK_IMAGE_ASPECT_COLOR_BIT,                          // VkImageAspectFlags                     aspectMask
+			0,                                                  // uint32_t                               baseMipLevel
+			1,                                                  // uint32_t                               levelCount
+			0,                                                  // uint32_t                               baseArrayLayer
+			1                                                   // uint32_t                               layerCount
+		};
+
+		const RenderDevice& device{ m_instance.get_device() };
 
 		if (device.present_queue() != device.graphics_queue()) {
 			VkImageMemoryBarrier barrier_from_draw_to_present = {
@@ -137,18 +164,23 @@ namespace Nth {
 		command_buffer.end();
 	}
 
-	void RenderingResource::present(const Vector2ui& size) {
-		VkPipelineStageFlags wait_dst_stage_mask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	void RenderingResource::present(const Vector2ui& size, const std::vector<VkSemaphore>& upload_semaphores) {
+		// Uploads finished on the transfer queue are made visible to every stage reading them
+		std::vector<VkSemaphore> wait_semaphores{ image_available_semaphore() };
+		std::vector<VkPipelineStageFlags> wait_dst_stage_masks{ VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
+		for (VkSemaphore semaphore : upload_semaphores) {
+			wait_semaphores.push_back(semaphore);
+			wait_dst_stage_masks.push_back(VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+		}
 
-		VkSemaphore vk_image_available_semaphore = image_available_semaphore();
 		VkCommandBuffer vk_command_buffer = command_buffer();
 		VkSemaphore vk_finished_rendering_semaphore = finished_rendering_semaphore();
 		VkSubmitInfo submit_info = {
 			VK_STRUCTURE_TYPE_SUBMIT_INFO,               // VkStructureType              sType
 			nullptr,                                     // const void                  *pNext
-			1,                                           // uint32_t                     waitSemaphoreCount
-			&vk_image_available_semaphore,               // const VkSemaphore           *pWaitSemaphores
-			&wait_dst_stage_mask,                        // const VkPipelineStageFlags  *pWaitDstStageMask;
+			static_cast<uint32_t>(wait_semaphores.size()), // uint32_t                   waitSemaphoreCount
+			wait_semaphores.data(),                      // const VkSemaphore           *pWaitSemaphores
+			wait_dst_stage_masks.data(),                 // const VkPipelineStageFlags  *pWaitDstStageMask;
 			1,                                           // uint32_t                     commandBufferCount
 			&vk_command_buffer,                          // const VkCommandBuffer       *pCommandBuffers
 			1,                                           // uint32_t                     signalSemaphoreCount
@@ -0,0 +1,222 @@
+#include <Renderer/SceneGraph.hpp>
+
+#include <Utils/ReadPool.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NTH_SCENEGRAPH_SSE
+#include <emmintrin.h>
+#endif
+
+namespace Nth {
+	uint32_t SceneGraph::add_node(uint32_t parent, const Vector3f& translation, const Vector4f& rotation, const Vector3f& scale) {
+		assert(parent == SceneGraph::no_parent || parent < m_parents.size());
+
+		uint32_t node = static_cast<uint32_t>(m_parents.size());
+		uint32_t depth = parent == SceneGraph::no_parent ? 0 : m_depths[parent] + 1;
+
+		m_translations.push_back(translation);
+		m_rotations.push_back(rotation);
+		m_scales.push_back(scale);
+
+		m_parents.push_back(parent);
+		m_depths.push_back(depth);
+		m_dirty.push_back(1);
+		m_world_matrices.push_back(Matrix4f::Identity());
+		m_objects.emplace_back();
+
+		m_max_depth = std::max(m_max_depth, depth);
+
+		return node;
+	}
+
+	void SceneGraph::set_translation(uint32_t node, const Vector3f& translation) {
+		m_translations[node] = translation;
+		mark_dirty(node);
+	}
+
+	void SceneGraph::set_rotation(uint32_t node, const Vector4f& rotation) {
+		m_rotations[node] = rotation;
+		mark_dirty(node);
+	}
+
+	void SceneGraph::set_scale(uint32_t node, const Vector3f& scale) {
+		m_scales[node] = scale;
+		mark_dirty(node);
+	}
+
+	const Vector3f& SceneGraph::translation(uint32_t node) const {
+		return m_translations[node];
+	}
+
+	const Vector4f& SceneGraph::rotation(uint32_t node) const {
+		return m_rotations[node];
+	}
+
+	const Vector3f& SceneGraph::scale(uint32_t node) const {
+		return m_scales[node];
+	}
+
+	uint32_t SceneGraph::parent(uint32_t node) const {
+		return m_parents[node];
+	}
+
+	size_t SceneGraph::size() const {
+		return m_parents.size();
+	}
+
+	const Matrix4f& SceneGraph::world_matrix(uint32_t node) const {
+		return m_world_matrices[node];
+	}
+
+	const std::vector<uint32_t>& SceneGraph::update(ReadPool* pool) {
+		m_changed.clear();
+
+		// Parents come first, so a single pass carries the flag down whole subtrees
+		for (uint32_t node = 0; node < m_parents.size(); ++node) {
+			if (m_parents[node] != SceneGraph::no_parent && m_dirty[m_parents[node]]) {
+				m_dirty[node] = 1;
+			}
+
+			if (m_dirty[node]) {
+				m_changed.push_back(node);
+			}
+		}
+
+		if (m_changed.empty()) {
+			return m_changed;
+		}
+
+		// Nodes of one depth only read the level above, each level is split in batches
+		std::vector<std::vector<uint32_t>> levels(m_max_depth + 1);
+		for (uint32_t node : m_changed) {
+			levels[m_depths[node]].push_back(node);
+		}
+
+		auto update_node = [this](uint32_t node) {
+			Matrix4f local = SceneGraph::compose(m_translations[node], m_rotations[node], m_scales[node]);
+
+			uint32_t parent = m_parents[node];
+			// Operands read right to left, the local transform applies first
+			m_world_matrices[node] = parent == SceneGraph::no_parent ? local : SceneGraph::multiply(m_world_matrices[parent], local);
+		};
+
+		// Below this a level is cheaper to do than to hand out
+		constexpr size_t batch_size = 256;
+
+		for (const std::vector<uint32_t>& level : levels) {
+			size_t batch_count = (level.size() + batch_size - 1) / batch_size;
+
+			auto update_batch = [&](size_t batch) {
+				size_t end = std::min(level.size(), (batch + 1) * batch_size);
+				for (size_t i = batch * batch_size; i < end; ++i) {
+					update_node(level[i]);
+				}
+			};
+
+			if (pool && batch_count > 1) {
+				pool->run_batch(batch_count, update_batch);
+				continue;
+			}
+
+			for (size_t batch = 0; batch < batch_count; ++batch) {
+				update_batch(batch);
+			}
+		}
+
+		for (uint32_t node : m_changed) {
+			m_dirty[node] = 0;
+		}
+
+		return m_changed;
+	}
+
+	void SceneGraph::attach(uint32_t node, RenderObjectHandle object) {
+		m_objects[node].push_back(object);
+		mark_dirty(node);
+	}
+
+	void SceneGraph::apply(RenderScene& scene) const {
+		for (uint32_t node : m_changed) {
+			for (RenderObjectHandle object : m_objects[node]) {
+				if (scene.contains(object)) {
+					scene.set_transform(object, m_world_matrices[node]);
+				}
+			}
+		}
+	}
+
+	Matrix4f SceneGraph::compose(const Vector3f& translation, const Vector4f& rotation, const Vector3f& scale) {
+#ifdef NTH_SCENEGRAPH_SSE
+		// Each row is its axis plus two quaternion components times a permutation of the quaternion, the last lane is zeroed by the signs
+		const __m128 q = _mm_setr_ps(rotation.x, rotation.y, rotation.z, rotation.w);
+		const __m128 x2 = _mm_set1_ps(2.f * rotation.x);
+		const __m128 y2 = _mm_set1_ps(2.f * rotation.y);
+		const __m128 z2 = _mm_set1_ps(2.f * rotation.z);
+
+		__m128 row0 = _mm_add_ps(_mm_setr_ps(1.f, 0.f, 0.f, 0.f), _mm_add_ps(
+			_mm_mul_ps(y2, _mm_mul_ps(_mm_shuffle_ps(q, q, _MM_SHUFFLE(3, 3, 0, 1)), _mm_setr_ps(-1.f, 1.f, -1.f, 0.f))),
+			_mm_mul_ps(z2, _mm_mul_ps(_mm_shuffle_ps(q, q, _MM_SHUFFLE(0, 0, 3, 2)), _mm_setr_ps(-1.f, 1.f, 1.f, 0.f)))));
+		__m128 row1 = _mm_add_ps(_mm_setr_ps(0.f, 1.f, 0.f, 0.f), _mm_add_ps(
+			_mm_mul_ps(x2, _mm_mul_ps(_mm_shuffle_ps(q, q, _MM_SHUFFLE(3, 3, 0, 1)), _mm_setr_ps(1.f, -1.f, 1.f, 0.f))),
+			_mm_mul_ps(z2, _mm_mul_ps(_mm_shuffle_ps(q, q, _MM_SHUFFLE(1, 1, 2, 3)), _mm_setr_ps(-1.f, -1.f, 1.f, 0.f)))));
+		__m128 row2 = _mm_add_ps(_mm_setr_ps(0.f, 0.f, 1.f, 0.f), _mm_add_ps(
+			_mm_mul_ps(x2, _mm_mul_ps(_mm_shuffle_ps(q, q, _MM_SHUFFLE(0, 0, 3, 2)), _mm_setr_ps(1.f, -1.f, -1.f, 0.f))),
+			_mm_mul_ps(y2, _mm_mul_ps(_mm_shuffle_ps(q, q, _MM_SHUFFLE(1, 1, 2, 3)), _mm_setr_ps(1.f, 1.f, -1.f, 0.f)))));
+
+		Matrix4f result;
+		float* rows = &result.a11;
+		_mm_storeu_ps(rows, _mm_mul_ps(row0, _mm_set1_ps(scale.x)));
+		_mm_storeu_ps(rows + 4, _mm_mul_ps(row1, _mm_set1_ps(scale.y)));
+		_mm_storeu_ps(rows + 8, _mm_mul_ps(row2, _mm_set1_ps(scale.z)));
+		_mm_storeu_ps(rows + 12, _mm_setr_ps(translation.x, translation.y, translation.z, 1.f));
+
+		return result;
+#else
+		float x = rotation.x;
+		float y = rotation.y;
+		float z = rotation.z;
+		float w = rotation.w;
+
+		// Row vector convention, scale then rotate then translate
+		return Matrix4f{
+			scale.x * (1.f - 2.f * (y * y + z * z)), scale.x * 2.f * (x * y + z * w), scale.x * 2.f * (x * z - y * w), 0.f,
+			scale.y * 2.f * (x * y - z * w), scale.y * (1.f - 2.f * (x * x + z * z)), scale.y * 2.f * (y * z + x * w), 0.f,
+			scale.z * 2.f * (x * z + y * w), scale.z * 2.f * (y * z - x * w), scale.z * (1.f - 2.f * (x * x + y * y)), 0.f,
+			translation.x, translation.y, translation.z, 1.f
+		};
+#endif
+	}
+
+	Matrix4f SceneGraph::multiply(const Matrix4f& parent, const Matrix4f& local) {
+#ifdef NTH_SCENEGRAPH_SSE
+		// Row vectors, each row of local combines the rows of parent
+		const float* parent_rows = &parent.a11;
+		const __m128 parent0 = _mm_loadu_ps(parent_rows);
+		const __m128 parent1 = _mm_loadu_ps(parent_rows + 4);
+		const __m128 parent2 = _mm_loadu_ps(parent_rows + 8);
+		const __m128 parent3 = _mm_loadu_ps(parent_rows + 12);
+
+		Matrix4f result;
+		const float* local_rows = &local.a11;
+		float* rows = &result.a11;
+		for (int i = 0; i < 16; i += 4) {
+			__m128 row = _mm_mul_ps(_mm_set1_ps(local_rows[i]), parent0);
+			row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(local_rows[i + 1]), parent1));
+			row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(local_rows[i + 2]), parent2));
+			row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(local_rows[i + 3]), parent3));
+			_mm_storeu_ps(rows + i, row);
+		}
+
+		return result;
+#else
+		return parent * local;
+#endif
+	}
+
+	void SceneGraph::mark_dirty(uint32_t node) {
+		m_dirty[node] = 1;
+	}
+}
@@ -2,6 +2,8 @@
 
 #include <Renderer/RenderBuffer.hpp>
 #include <Renderer/RenderTexture.hpp>
+#include <Renderer/Vulkan/ImageView.hpp>
+#include <Renderer/Vulkan/Sampler.hpp>
 
 #include <utility>
 
@@ -15,8 +17,11 @@ namespace Nth {
 	void ShaderBinding::update(const std::vector<Binding>& bindings) {
 		std::vector<VkWriteDescriptorSet> descriptor_writes;
 
-		std::vector<VkDescriptorBufferInfo> buffer_infos(bindings.size());
-		std::vector<VkDescriptorImageInfo> image_infos(bindings.size());
+		// Reserve only: writes keep pointers to these infos
+		std::vector<VkDescriptorBufferInfo> buffer_infos;
+		buffer_infos.reserve(bindings.size());
+		std::vector<VkDescriptorImageInfo> image_infos;
+		image_infos.reserve(bindings.size());
 
 		for (const Binding& binding : bindings) {
 			VkWriteDescriptorSet write = {
@@ -59,6 +64,24 @@ namespace Nth {
 
 					write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
 					write.pImageInfo = &texture_info;
+				},
+				[&write, &image_infos](const ImageBinding& image) {
+					VkDescriptorImageInfo& image_info = image_infos.emplace_back();
+					image_info.sampler = image.sampler();
+					image_info.imageView = image.view();
+					image_info.imageLayout = image.layout;
+
+					write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+					write.pImageInfo = &image_info;
+				},
+				[&write, &image_infos](const StorageImageBinding& storage_image) {
+					VkDescriptorImageInfo& image_info = image_infos.emplace_back();
+					image_info.sampler = VK_NULL_HANDLE;
+					image_info.imageView = storage_image.view();
+					image_info.imageLayout = storage_image.layout;
+
+					write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+					write.pImageInfo = &image_info;
 				}
 			}, binding.info);
 
@@ -71,4 +94,59 @@ namespace Nth {
 	const Vk::DescriptorSet& ShaderBinding::descriptor_set() const {
 		return m_descriptor_set;
 	}
+
+	Vk::DescriptorSetLayout create_descriptor_set_layout(const Vk::Device& device, const std::vector<BindingInfo>& bindings) {
+		// Use "set" information
+		std::vector<VkDescriptorSetLayoutBinding> layout_bindings;
+		for (const auto& binding : bindings) {
+			VkDescriptorSetLayoutBinding layout_binding;
+			layout_binding.binding = binding.binding_index;
+
+			switch (binding.binding_type) {
+			case BindingType::Uniform:
+				layout_binding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+				break;
+			case BindingType::Texture:
+				layout_binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+				break;
+			case BindingType::Storage:
+				layout_binding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+				break;
+			case BindingType::StorageImage:
+				layout_binding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+				break;
+			}
+
+			layout_binding.descriptorCount = 1;
+
+			switch (binding.shader_type) {
+			case ShaderType::Vertex:
+				layout_binding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+				break;
+			case ShaderType::Fragment:
+				layout_binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+				break;
+			case ShaderType::Compute:
+				layout_binding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+				break;
+			}
+
+			layout_binding.pImmutableSamplers = nullptr;
+
+			layout_bindings.push_back(std::move(layout_binding));
+		}
+
+		VkDescriptorSetLayoutCreateInfo descriptor_set_layout_create_info = {
+			VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,   // VkStructureType                      sType
+			nullptr,                                               // const void                          *pNext
+			0,                                                     // VkDescriptorSetLayoutCreateFlags     flags
+			static_cast<uint32_t>(layout_bindings.size()),         // uint32_t                             bindingCount
+			layout_bindings.data()                                 // const VkDescriptorSetLayoutBinding  *pBindings
+		};
+
+		Vk::DescriptorSetLayout layout;
+		layout.create(device, descriptor_set_layout_create_info);
+
+		return layout;
+	}
 }
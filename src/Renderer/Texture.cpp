@@ -1,5 +1,6 @@
 #include <Renderer/Texture.hpp>
 
+#include <Utils/AssetFile.hpp>
 #include <Utils/Image.hpp>
 #include <Utils/Color.hpp>
 
@@ -7,20 +8,39 @@
 
 namespace Nth {
 	Texture texture_from_file(const std::filesystem::path& path) {
-		Image image = Image::LoadFromFile(path, PixelChannel::Rgba);
+		AssetFile file = AssetFile::Open(path);
+		file.advise(MappedFile::Access::Sequential);
+
+		return texture_from_file(file, path);
+	}
+
+	Texture texture_from_file(const AssetFile& file, const std::filesystem::path& path) {
+		Image image = Image::LoadFromFile(file, path, PixelChannel::Rgba);
 
 		if (image.pixels().empty()) {
 			throw std::runtime_error("Can't read file " + path.string());
 		}
 
 		Texture texture;
-		texture.data = image.pixels();
 		texture.height = image.height();
 		texture.width = image.width();
+		texture.data = image.take_pixels();
+		texture.content_hash = texture_file_hash(file);
 
 		return texture;
 	}
 
+	ContentHash texture_content_hash(const Texture& texture) {
+		uint64_t size = (static_cast<uint64_t>(texture.width) << 32) | texture.height;
+
+		return hash_content(texture.data.data(), texture.data.size(), size);
+	}
+
+	ContentHash texture_file_hash(const AssetFile& file) {
+		// Unseeded, pixel hashes are seeded by the size which is never zero
+		return hash_content(file.data(), file.size());
+	}
+
 	Texture uniform_texture(const Color& color) {
 		Texture texture;
 		texture.width = 1;
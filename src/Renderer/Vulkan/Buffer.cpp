@@ -10,7 +10,8 @@ namespace Nth {
 	namespace Vk {
 		Buffer::Buffer() :
 			m_buffer(VK_NULL_HANDLE),
-			m_device(nullptr) {
+			m_device(nullptr),
+			m_size(0) {
 		}
 
 		Buffer::Buffer(Buffer&& object) noexcept :
@@ -53,7 +53,11 @@ namespace Nth {
 		}
 
 		void CommandBuffer::bind_descriptor_sets(VkPipelineLayout layout, uint32_t firstSet, uint32_t descriptor_set_count, VkDescriptorSet const* descriptor_sets, uint32_t dynamic_offset_count, uint32_t const* dynamic_offsets) const {
-			m_pool->get_device()->vkCmdBindDescriptorSets(m_command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, firstSet, descriptor_set_count, descriptor_sets, dynamic_offset_count, dynamic_offsets);
+			bind_descriptor_sets(VK_PIPELINE_BIND_POINT_GRAPHICS, layout, firstSet, descriptor_set_count, descriptor_sets, dynamic_offset_count, dynamic_offsets);
+		}
+
+		void CommandBuffer::bind_descriptor_sets(VkPipelineBindPoint pipeline_bind_point, VkPipelineLayout layout, uint32_t firstSet, uint32_t descriptor_set_count, VkDescriptorSet const* descriptor_sets, uint32_t dynamic_offset_count, uint32_t const* dynamic_offsets) const {
+			m_pool->get_device()->vkCmdBindDescriptorSets(m_command_buffer, pipeline_bind_point, layout, firstSet, descriptor_set_count, descriptor_sets, dynamic_offset_count, dynamic_offsets);
 		}
 
 		void CommandBuffer::clear_color_image(VkImage image, VkImageLayout layout, const VkClearColorValue& color, uint32_t range_count, VkImageSubresourceRange const* p_ranges) const {
@@ -76,6 +80,14 @@ namespace Nth {
 			m_pool->get_device()->vkCmdDrawIndexed(m_command_buffer, index_count, instance_count, first_index, vertex_offset, first_instance);
 		}
 
+		void CommandBuffer::draw_indexed_indirect(VkBuffer buffer, VkDeviceSize offset, uint32_t draw_count, uint32_t stride) const {
+			m_pool->get_device()->vkCmdDrawIndexedIndirect(m_command_buffer, buffer, offset, draw_count, stride);
+		}
+
+		void CommandBuffer::dispatch(uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z) const {
+			m_pool->get_device()->vkCmdDispatch(m_command_buffer, group_count_x, group_count_y, group_count_z);
+		}
+
 		void CommandBuffer::end() const {
 			VkResult result{ m_pool->get_device()->vkEndCommandBuffer(m_command_buffer) };
 			if (result != VK_SUCCESS) {
@@ -48,6 +48,16 @@ namespace Nth {
 			}
 		}
 
+		bool Fence::is_signaled() const {
+			assert(m_device != nullptr);
+			VkResult result{ m_device->vkGetFenceStatus((*m_device)(), m_fence) };
+			if (result != VK_SUCCESS && result != VK_NOT_READY) {
+				throw std::runtime_error("Can't get fence status, " + to_string(result));
+			}
+
+			return result == VK_SUCCESS;
+		}
+
 		void Fence::reset() const {
 			VkResult result{ m_device->vkResetFences((*m_device)(), 1, &m_fence) };
 			if (result != VK_SUCCESS) {
@@ -31,6 +31,15 @@ namespace Nth {
 			m_device = &device;
 		}
 
+		void Pipeline::create_compute(const Device& device, VkPipelineCache cache, const VkComputePipelineCreateInfo& infos) {
+			VkResult result{ device.vkCreateComputePipelines(device(), cache, 1, &infos, nullptr, &m_pipeline) };
+			if (result != VK_SUCCESS) {
+				throw std::runtime_error("Can't create compute pipeline, " + to_string(result));
+			}
+
+			m_device = &device;
+		}
+
 		void Pipeline::destroy() {
 			if (m_pipeline != VK_NULL_HANDLE) {
 				m_device->vkDestroyPipeline((*m_device)(), m_pipeline, nullptr);
@@ -19,9 +19,7 @@ namespace Nth {
 		}
 
 		Sampler::~Sampler() {
-			if (m_sampler != VK_NULL_HANDLE) {
-				m_device->vkDestroySampler((*m_device)(), m_sampler, nullptr);
-			}
+			destroy();
 		}
 
 		void Sampler::create(const Device& device, const VkSamplerCreateInfo& info) {
@@ -33,8 +31,26 @@ namespace Nth {
 			m_device = &device;
 		}
 
+		void Sampler::destroy() {
+			if (m_sampler != VK_NULL_HANDLE) {
+				m_device->vkDestroySampler((*m_device)(), m_sampler, nullptr);
+				m_sampler = VK_NULL_HANDLE;
+			}
+		}
+
 		VkSampler Sampler::operator()() const {
 			return m_sampler;
 		}
+
+		Sampler& Sampler::operator=(Sampler&& object) noexcept {
+			destroy();
+
+			m_sampler = object.m_sampler;
+			m_device = object.m_device;
+
+			object.m_sampler = VK_NULL_HANDLE;
+
+			return *this;
+		}
 	}
 }
@@ -0,0 +1,285 @@
+#include <Utils/Archive.hpp>
+
+#include <Utils/Compression.hpp>
+#include <Utils/Reader.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+namespace Nth {
+	const std::vector<ArchiveEntry>& Archive::entries() const {
+		return m_entries;
+	}
+
+	const ArchiveEntry* Archive::find(const std::filesystem::path& path) const {
+		std::string name = entry_name(path);
+
+		auto entry = std::lower_bound(m_entries.begin(), m_entries.end(), name, [&](const ArchiveEntry& lhs, const std::string& rhs) {
+			return entry_path(lhs) < rhs;
+		});
+
+		if (entry == m_entries.end() || entry_path(*entry) != name) {
+			return nullptr;
+		}
+
+		return &*entry;
+	}
+
+	std::string_view Archive::entry_path(const ArchiveEntry& entry) const {
+		return std::string_view{ reinterpret_cast<const char*>(m_file.data() + entry.path), entry.path_size };
+	}
+
+	const uint8_t* Archive::view(const ArchiveEntry& entry) const {
+		assert(&entry >= m_entries.data() && &entry < m_entries.data() + m_entries.size());
+
+		if (!m_in_place[static_cast<size_t>(&entry - m_entries.data())]) {
+			return nullptr;
+		}
+
+		return m_file.data() + block(entry, 0).offset;
+	}
+
+	void Archive::read(const ArchiveEntry& entry, uint64_t offset, void* destination, size_t size) const {
+		if (offset > entry.size || size > entry.size - offset) {
+			throw std::runtime_error("Read past the end of " + std::string{ entry_path(entry) } + " in archive " + m_path.string());
+		}
+
+		uint8_t* output = static_cast<uint8_t*>(destination);
+		std::vector<uint8_t> partial_block;
+
+		while (size > 0) {
+			size_t index = static_cast<size_t>(offset / m_header.block_size);
+			size_t block_offset = static_cast<size_t>(offset % m_header.block_size);
+			size_t block_size = static_cast<size_t>(std::min<uint64_t>(m_header.block_size, entry.size - index * m_header.block_size));
+			size_t count = std::min(size, block_size - block_offset);
+
+			ArchiveBlock stored = block(entry, index);
+			const uint8_t* data = m_file.data() + stored.offset;
+			if (stored.stored_size == block_size) {
+				std::memcpy(output, data + block_offset, count);
+			}
+			else if (count == block_size) {
+				decompress_block(data, stored.stored_size, output, block_size);
+			}
+			else {
+				partial_block.resize(block_size);
+				decompress_block(data, stored.stored_size, partial_block.data(), block_size);
+				std::memcpy(output, partial_block.data() + block_offset, count);
+			}
+
+			output += count;
+			offset += count;
+			size -= count;
+		}
+	}
+
+	std::vector<uint8_t> Archive::read(const ArchiveEntry& entry) const {
+		std::vector<uint8_t> content(static_cast<size_t>(entry.size));
+		read(entry, 0, content.data(), content.size());
+
+		return content;
+	}
+
+	void Archive::advise(const ArchiveEntry& entry, MappedFile::Access access, size_t offset, size_t size) const {
+		if (!view(entry) || offset >= entry.size) {
+			return;
+		}
+
+		size_t remaining = static_cast<size_t>(entry.size) - offset;
+		m_file.advise(access, static_cast<size_t>(block(entry, 0).offset) + offset, size == 0 ? remaining : std::min(size, remaining));
+	}
+
+	Archive Archive::LoadFromFile(const std::filesystem::path& path) {
+		return Archive{ path };
+	}
+
+	std::string Archive::entry_name(const std::filesystem::path& path) {
+		std::filesystem::path name = path.lexically_normal();
+		if (name.is_absolute()) {
+			name = name.lexically_relative(std::filesystem::current_path());
+		}
+
+		return name.generic_string();
+	}
+
+	Archive::Archive(const std::filesystem::path& path) :
+		m_path(path),
+		m_file(path),
+		m_header(),
+		m_entries(),
+		m_in_place() {
+		auto invalid = [&](const std::string& reason) {
+			return std::runtime_error("Archive " + path.string() + " " + reason);
+		};
+
+		if (m_file.size() < sizeof(ArchiveHeader)) {
+			throw invalid("is too small");
+		}
+
+		std::memcpy(&m_header, m_file.data(), sizeof(ArchiveHeader));
+
+		if (m_header.magic != Archive::magic) {
+			throw invalid("has no archive header");
+		}
+		if (m_header.version != Archive::version) {
+			throw invalid("has version " + std::to_string(m_header.version) + ", expected " + std::to_string(Archive::version));
+		}
+		if (m_header.file_size != m_file.size()) {
+			throw invalid("is truncated");
+		}
+		if (m_header.block_size == 0) {
+			throw invalid("has no block size");
+		}
+
+		auto in_file = [&](uint64_t offset, uint64_t size) {
+			return offset <= m_file.size() && size <= m_file.size() - offset;
+		};
+
+		if (!in_file(m_header.entry_table, m_header.entry_count * sizeof(ArchiveEntry))) {
+			throw invalid("has a table of contents outside of the file");
+		}
+
+		m_entries.resize(m_header.entry_count);
+		if (!m_entries.empty()) {
+			std::memcpy(m_entries.data(), m_file.data() + m_header.entry_table, m_entries.size() * sizeof(ArchiveEntry));
+		}
+
+		for (const ArchiveEntry& entry : m_entries) {
+			if (entry.block_count != (entry.size + m_header.block_size - 1) / m_header.block_size ||
+				entry.compressed_blocks > entry.block_count ||
+				!in_file(entry.path, entry.path_size) ||
+				!in_file(entry.blocks, entry.block_count * sizeof(ArchiveBlock))) {
+				throw invalid("has an entry outside of the file");
+			}
+
+			// Every block is checked once here, so reads and views never leave the mapping
+			uint32_t compressed_blocks = 0;
+			bool contiguous = true;
+			for (size_t i = 0; i < entry.block_count; ++i) {
+				ArchiveBlock stored = block(entry, i);
+				uint64_t block_size = std::min<uint64_t>(m_header.block_size, entry.size - i * m_header.block_size);
+				if (!in_file(stored.offset, stored.stored_size) || stored.stored_size > block_size) {
+					throw invalid("has a block outside of the file");
+				}
+
+				compressed_blocks += stored.stored_size < block_size ? 1 : 0;
+				contiguous = contiguous && stored.offset == block(entry, 0).offset + i * m_header.block_size;
+			}
+
+			if (compressed_blocks != entry.compressed_blocks) {
+				throw invalid("has a wrong compressed block count");
+			}
+
+			// Read in place when the stored blocks follow each other, any other layout is still read block by block
+			m_in_place.push_back(entry.block_count > 0 && compressed_blocks == 0 && contiguous && in_file(block(entry, 0).offset, entry.size));
+		}
+
+		bool sorted = std::is_sorted(m_entries.begin(), m_entries.end(), [&](const ArchiveEntry& lhs, const ArchiveEntry& rhs) {
+			return entry_path(lhs) < entry_path(rhs);
+		});
+		if (!sorted) {
+			throw invalid("has an unsorted table of contents");
+		}
+	}
+
+	ArchiveBlock Archive::block(const ArchiveEntry& entry, size_t index) const {
+		// Copied out since the mapping gives no alignment guarantee
+		ArchiveBlock block;
+		std::memcpy(&block, m_file.data() + entry.blocks + index * sizeof(ArchiveBlock), sizeof(ArchiveBlock));
+
+		return block;
+	}
+
+	void save_archive(const std::filesystem::path& root, const std::vector<std::filesystem::path>& files, const std::filesystem::path& path, uint32_t block_size) {
+		if (block_size == 0) {
+			throw std::runtime_error("Archive " + path.string() + " needs a block size");
+		}
+
+		std::vector<std::pair<std::string, std::filesystem::path>> sources;
+		for (const std::filesystem::path& file : files) {
+			sources.emplace_back(Archive::entry_name(std::filesystem::relative(file, root)), file);
+		}
+
+		std::sort(sources.begin(), sources.end());
+		for (size_t i = 1; i < sources.size(); ++i) {
+			if (sources[i].first == sources[i - 1].first) {
+				throw std::runtime_error("File " + sources[i].first + " is packed twice in archive " + path.string());
+			}
+		}
+
+		std::ofstream output(path, std::ios::binary | std::ios::trunc);
+		uint64_t offset = 0;
+
+		// Blocks are written as they are compressed, only the tables are kept until the end
+		auto append = [&](const void* data, size_t size, uint64_t alignment) {
+			static const char zeros[Archive::entry_alignment] = {};
+			uint64_t aligned_offset = (offset + alignment - 1) / alignment * alignment;
+			output.write(zeros, static_cast<std::streamsize>(aligned_offset - offset));
+			output.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+
+			offset = aligned_offset + size;
+			return aligned_offset;
+		};
+
+		ArchiveHeader header{};
+		append(&header, sizeof(ArchiveHeader), 1);
+
+		std::vector<ArchiveEntry> entries;
+		std::vector<std::vector<ArchiveBlock>> blocks;
+		for (const auto& [name, file] : sources) {
+			std::vector<char> content = read_binary_file(file);
+
+			ArchiveEntry entry{};
+			entry.size = content.size();
+			entry.block_count = static_cast<uint32_t>((content.size() + block_size - 1) / block_size);
+
+			std::vector<ArchiveBlock> entry_blocks;
+			for (size_t start = 0; start < content.size(); start += block_size) {
+				size_t size = std::min<size_t>(block_size, content.size() - start);
+				std::vector<uint8_t> compressed = compress_block(content.data() + start, size);
+
+				// The first block starts the entry on its alignment, the others follow without padding
+				uint64_t alignment = start == 0 ? Archive::entry_alignment : 1;
+
+				ArchiveBlock block{};
+				if (compressed.size() < size) {
+					block.stored_size = static_cast<uint32_t>(compressed.size());
+					block.offset = append(compressed.data(), compressed.size(), alignment);
+					++entry.compressed_blocks;
+				}
+				else {
+					block.stored_size = static_cast<uint32_t>(size);
+					block.offset = append(content.data() + start, size, alignment);
+				}
+				entry_blocks.push_back(block);
+			}
+
+			entries.push_back(entry);
+			blocks.push_back(std::move(entry_blocks));
+		}
+
+		for (size_t i = 0; i < entries.size(); ++i) {
+			entries[i].blocks = append(blocks[i].data(), blocks[i].size() * sizeof(ArchiveBlock), alignof(ArchiveBlock));
+			entries[i].path_size = static_cast<uint32_t>(sources[i].first.size());
+			entries[i].path = append(sources[i].first.data(), sources[i].first.size(), 1);
+		}
+
+		header.magic = Archive::magic;
+		header.version = Archive::version;
+		header.entry_count = static_cast<uint32_t>(entries.size());
+		header.block_size = block_size;
+		header.entry_table = append(entries.data(), entries.size() * sizeof(ArchiveEntry), alignof(ArchiveEntry));
+		header.file_size = offset;
+
+		output.seekp(0);
+		output.write(reinterpret_cast<const char*>(&header), sizeof(ArchiveHeader));
+
+		if (!output) {
+			throw std::runtime_error("Can't write file " + path.string());
+		}
+	}
+}
@@ -0,0 +1,104 @@
+#include <Utils/AssetFile.hpp>
+
+#include <Utils/Archive.hpp>
+
+#include <utility>
+
+namespace Nth {
+	AssetFile::AssetFile() :
+		m_file(),
+		m_archive(),
+		m_content(),
+		m_entry(nullptr),
+		m_data(nullptr),
+		m_size(0) {}
+
+	void AssetFile::advise(MappedFile::Access access, size_t offset, size_t size) const {
+		if (m_file.is_valid()) {
+			m_file.advise(access, offset, size);
+		}
+		else if (m_archive) {
+			m_archive->advise(*m_entry, access, offset, size);
+		}
+	}
+
+	const uint8_t* AssetFile::data() const {
+		return m_data;
+	}
+
+	size_t AssetFile::size() const {
+		return m_size;
+	}
+
+	AssetFile AssetFile::Open(const std::filesystem::path& path) {
+		AssetFile file;
+
+		for (const std::shared_ptr<const Archive>& archive : archives()) {
+			const ArchiveEntry* entry = archive->find(path);
+			if (!entry) {
+				continue;
+			}
+
+			file.m_size = static_cast<size_t>(entry->size);
+			if (const uint8_t* view = archive->view(*entry)) {
+				// The archive stays mapped as long as a view into it exists
+				file.m_archive = archive;
+				file.m_entry = entry;
+				file.m_data = view;
+			}
+			else {
+				file.m_content = archive->read(*entry);
+				file.m_data = file.m_content.data();
+			}
+
+			return file;
+		}
+
+		// Empty files can't be mapped
+		std::error_code error;
+		if (std::filesystem::file_size(path, error) == 0 && !error) {
+			return file;
+		}
+
+		file.m_file.open(path);
+		file.m_data = file.m_file.data();
+		file.m_size = file.m_file.size();
+
+		return file;
+	}
+
+	bool AssetFile::Exists(const std::filesystem::path& path) {
+		for (const std::shared_ptr<const Archive>& archive : archives()) {
+			if (archive->find(path)) {
+				return true;
+			}
+		}
+
+		return std::filesystem::is_regular_file(path);
+	}
+
+	void AssetFile::Mount(const std::filesystem::path& archive) {
+		auto mounted = std::make_shared<const Archive>(Archive::LoadFromFile(archive));
+
+		MountedArchives& mounts = mounted_archives();
+		std::lock_guard<std::mutex> lock(mounts.mutex);
+		mounts.archives.insert(mounts.archives.begin(), std::move(mounted));
+	}
+
+	void AssetFile::UnmountAll() {
+		MountedArchives& mounts = mounted_archives();
+		std::lock_guard<std::mutex> lock(mounts.mutex);
+		mounts.archives.clear();
+	}
+
+	AssetFile::MountedArchives& AssetFile::mounted_archives() {
+		static MountedArchives mounts;
+		return mounts;
+	}
+
+	std::vector<std::shared_ptr<const Archive>> AssetFile::archives() {
+		MountedArchives& mounts = mounted_archives();
+		std::lock_guard<std::mutex> lock(mounts.mutex);
+		return mounts.archives;
+	}
+}
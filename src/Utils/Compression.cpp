@@ -0,0 +1,181 @@
+#include <Utils/Compression.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace Nth {
+	std::vector<uint8_t> compress_block(const void* data, size_t size) {
+		if (size > std::numeric_limits<uint32_t>::max()) {
+			throw std::runtime_error("Block of " + std::to_string(size) + " bytes is too large to compress");
+		}
+
+		// Limits from the format, decoders copy 8 bytes at a time near the end
+		constexpr size_t min_match = 4;
+		constexpr size_t last_literals = 5;
+		constexpr size_t match_limit = 12;
+		constexpr size_t max_offset = 65535;
+		constexpr uint32_t hash_bits = 12;
+
+		const uint8_t* input = static_cast<const uint8_t*>(data);
+
+		std::vector<uint8_t> output;
+		output.reserve(size + size / 255 + 16);
+
+		auto read32 = [&](size_t position) {
+			uint32_t value;
+			std::memcpy(&value, input + position, sizeof(uint32_t));
+			return value;
+		};
+
+		auto write_length = [&](size_t length) {
+			for (length -= 15; length >= 255; length -= 255) {
+				output.push_back(255);
+			}
+			output.push_back(static_cast<uint8_t>(length));
+		};
+
+		// The last sequence only has literals, match_length is 0 then
+		auto write_sequence = [&](size_t literal_start, size_t literal_length, size_t offset, size_t match_length) {
+			uint8_t token = static_cast<uint8_t>(std::min<size_t>(literal_length, 15) << 4);
+			if (match_length > 0) {
+				token |= static_cast<uint8_t>(std::min<size_t>(match_length - min_match, 15));
+			}
+
+			output.push_back(token);
+			if (literal_length >= 15) {
+				write_length(literal_length);
+			}
+			output.insert(output.end(), input + literal_start, input + literal_start + literal_length);
+
+			if (match_length > 0) {
+				output.push_back(static_cast<uint8_t>(offset & 0xFF));
+				output.push_back(static_cast<uint8_t>(offset >> 8));
+				if (match_length - min_match >= 15) {
+					write_length(match_length - min_match);
+				}
+			}
+		};
+
+		// Positions are stored plus one, 0 is an empty slot
+		std::vector<uint32_t> table(size_t{ 1 } << hash_bits, 0);
+
+		size_t anchor = 0;
+		size_t position = 0;
+		while (position + match_limit <= size) {
+			uint32_t sequence = read32(position);
+			uint32_t hash = (sequence * 2654435761u) >> (32 - hash_bits);
+			uint32_t candidate = table[hash];
+			table[hash] = static_cast<uint32_t>(position + 1);
+
+			if (candidate == 0 || position - (candidate - 1) > max_offset || read32(candidate - 1) != sequence) {
+				++position;
+				continue;
+			}
+
+			size_t match = candidate - 1;
+			size_t length = min_match;
+			while (position + length < size - last_literals && input[match + length] == input[position + length]) {
+				++length;
+			}
+
+			while (position > anchor && match > 0 && input[position - 1] == input[match - 1]) {
+				--position;
+				--match;
+				++length;
+			}
+
+			write_sequence(anchor, position - anchor, position - match, length);
+
+			position += length;
+			anchor = position;
+		}
+
+		write_sequence(anchor, size - anchor, 0, 0);
+
+		return output;
+	}
+
+	void decompress_block(const void* data, size_t size, void* destination, size_t destination_size) {
+		const uint8_t* input = static_cast<const uint8_t*>(data);
+		uint8_t* output = static_cast<uint8_t*>(destination);
+
+		auto corrupted = []() {
+			return std::runtime_error("Compressed block is corrupted");
+		};
+
+		size_t read = 0;
+		size_t written = 0;
+
+		auto read_length = [&](size_t length) {
+			if (length == 15) {
+				uint8_t extension;
+				do {
+					if (read >= size) {
+						throw corrupted();
+					}
+
+					extension = input[read++];
+					length += extension;
+				} while (extension == 255);
+			}
+
+			return length;
+		};
+
+		while (true) {
+			if (read >= size) {
+				throw corrupted();
+			}
+
+			uint8_t token = input[read++];
+
+			size_t literal_length = read_length(token >> 4);
+			if (literal_length > size - read || literal_length > destination_size - written) {
+				throw corrupted();
+			}
+
+			// Output may be null for an empty block
+			if (literal_length > 0) {
+				std::memcpy(output + written, input + read, literal_length);
+			}
+			read += literal_length;
+			written += literal_length;
+
+			// Only the last sequence ends the block without a match
+			if (read == size) {
+				break;
+			}
+
+			if (size - read < 2) {
+				throw corrupted();
+			}
+
+			size_t offset = static_cast<size_t>(input[read]) | static_cast<size_t>(input[read + 1]) << 8;
+			read += 2;
+
+			size_t match_length = read_length(token & 15) + 4;
+			if (offset == 0 || offset > written || match_length > destination_size - written) {
+				throw corrupted();
+			}
+
+			// Matches closer than their length repeat the bytes just written
+			const uint8_t* match = output + written - offset;
+			if (offset >= match_length) {
+				std::memcpy(output + written, match, match_length);
+			}
+			else {
+				for (size_t i = 0; i < match_length; ++i) {
+					output[written + i] = match[i];
+				}
+			}
+			written += match_length;
+		}
+
+		if (written != destination_size) {
+			throw std::runtime_error("Compressed block decodes to " + std::to_string(written) + " bytes, expected " + std::to_string(destination_size));
+		}
+	}
+}
@@ -0,0 +1,90 @@
+#include <Utils/Hash.hpp>
+
+#include <Utils/MappedFile.hpp>
+
+#include <cstring>
+
+namespace Nth {
+	uint64_t hash_bytes(const void* data, size_t size, uint64_t hash) {
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < size; ++i) {
+			hash = (hash ^ bytes[i]) * 1099511628211ull;
+		}
+
+		return hash;
+	}
+
+	uint64_t hash_file(const std::filesystem::path& path, uint64_t hash) {
+		// Empty files can't be mapped
+		if (std::filesystem::file_size(path) == 0) {
+			return hash;
+		}
+
+		MappedFile file{ path };
+		return hash_bytes(file.data(), file.size(), hash);
+	}
+
+	bool ContentHash::operator==(const ContentHash& other) const {
+		return low == other.low && high == other.high;
+	}
+
+	bool ContentHash::operator!=(const ContentHash& other) const {
+		return !(*this == other);
+	}
+
+	ContentHash hash_content(const void* data, size_t size, uint64_t seed) {
+		// Rounds and avalanche of XXH64, the lanes are merged twice for 128 bits
+		constexpr uint64_t prime1 = 11400714785074694791ull;
+		constexpr uint64_t prime2 = 14029467366897019727ull;
+		constexpr uint64_t prime3 = 1609587929392839161ull;
+		constexpr uint64_t prime4 = 9650029242287828579ull;
+		constexpr uint64_t prime5 = 2870177450012600261ull;
+
+		auto rotate = [](uint64_t value, int bits) {
+			return (value << bits) | (value >> (64 - bits));
+		};
+
+		auto lane_round = [&](uint64_t lane, uint64_t input) {
+			return rotate(lane + input * prime2, 31) * prime1;
+		};
+
+		auto avalanche = [](uint64_t hash) {
+			hash ^= hash >> 33;
+			hash *= prime2;
+			hash ^= hash >> 29;
+			hash *= prime3;
+			hash ^= hash >> 32;
+			return hash;
+		};
+
+		uint64_t lanes[4] = { seed + prime1 + prime2, seed + prime2, seed, seed - prime1 };
+		auto stripe = [&](const uint8_t* bytes) {
+			for (size_t i = 0; i < 4; ++i) {
+				uint64_t word;
+				std::memcpy(&word, bytes + i * sizeof(uint64_t), sizeof(uint64_t));
+				lanes[i] = lane_round(lanes[i], word);
+			}
+		};
+
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		size_t offset = 0;
+		for (; offset + 32 <= size; offset += 32) {
+			stripe(bytes + offset);
+		}
+
+		// The tail is padded with zeros, the size merged below tells it apart from real zeros
+		if (offset < size) {
+			uint8_t tail[32] = {};
+			std::memcpy(tail, bytes + offset, size - offset);
+			stripe(tail);
+		}
+
+		uint64_t length = static_cast<uint64_t>(size) * prime5;
+
+		ContentHash hash;
+		hash.low = avalanche(rotate(lanes[0], 1) + rotate(lanes[1], 7) + rotate(lanes[2], 12) + rotate(lanes[3], 18) + length);
+		hash.high = avalanche((lanes[0] ^ rotate(lanes[1], 29)) * prime4 + (lanes[2] ^ rotate(lanes[3], 37)) * prime3 + rotate(hash.low, 17) + length);
+
+		return hash;
+	}
+}
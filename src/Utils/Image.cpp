@@ -2,10 +2,15 @@
 
 //#include <Utils/Reader.hpp>
 
+#include <Utils/AssetFile.hpp>
+
 #include <stb_image.h>
 
 #include <iostream>
 #include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <utility>
 
 namespace Nth{
 	Image::Image(unsigned int width, unsigned int height, unsigned int channels, std::vector<unsigned char> const& pixels) :
@@ -14,6 +19,12 @@ namespace Nth{
 		m_channels(channels),
 		m_pixels(pixels) { }
 
+	Image::Image(unsigned int width, unsigned int height, unsigned int channels, std::vector<unsigned char>&& pixels) :
+		m_width(width),
+		m_height(height),
+		m_channels(channels),
+		m_pixels(std::move(pixels)) { }
+
 	unsigned int Image::width() const {
 		return m_width;
 	}
@@ -30,24 +41,97 @@ namespace Nth{
 		return m_pixels;
 	}
 
+	std::vector<unsigned char> Image::take_pixels() {
+		return std::exchange(m_pixels, {});
+	}
+
 	Image Image::LoadFromFile(const std::filesystem::path& path, PixelChannel desired_channel) {
+		AssetFile file = open_image(path);
+		file.advise(MappedFile::Access::Sequential);
+
+		return LoadFromFile(file, path, desired_channel);
+	}
+
+	Image Image::LoadFromFile(const AssetFile& file, const std::filesystem::path& path, PixelChannel desired_channel) {
+		ImageInfo info;
+		DecodedPixels image_data = decode(file, path, desired_channel, info);
+
+		// stb allocates its own buffer, this is the only copy
+		const unsigned char* pixels = image_data.get();
+		std::vector<unsigned char> output(pixels, pixels + static_cast<size_t>(info.width) * info.height * info.channels);
+
+		return Image{ info.width, info.height, info.channels, std::move(output) };
+	}
+
+	ImageInfo Image::LoadFromFileInto(const std::filesystem::path& path, PixelChannel desired_channel, void* destination, size_t size) {
+		AssetFile file = open_image(path);
+		file.advise(MappedFile::Access::Sequential);
+
+		return LoadFromFileInto(file, path, desired_channel, destination, size);
+	}
+
+	ImageInfo Image::LoadFromFileInto(const AssetFile& file, const std::filesystem::path& path, PixelChannel desired_channel, void* destination, size_t size) {
+		ImageInfo info;
+		DecodedPixels image_data = decode(file, path, desired_channel, info);
+
+		size_t decoded_size = static_cast<size_t>(info.width) * info.height * info.channels;
+		if (decoded_size != size) {
+			throw std::runtime_error("Image " + path.string() + " doesn't match the destination size");
+		}
+
+		std::memcpy(destination, image_data.get(), size);
+
+		return info;
+	}
+
+	ImageInfo Image::ReadInfo(const std::filesystem::path& path, PixelChannel desired_channel) {
+		// Only the pages of the header are read from a mapped file
+		AssetFile file = open_image(path);
+
+		return ReadInfo(file, path, desired_channel);
+	}
+
+	ImageInfo Image::ReadInfo(const AssetFile& file, const std::filesystem::path& path, PixelChannel desired_channel) {
+		check_size(file, path);
+
 		int width, height, components;
-		unsigned char* image_data = stbi_load(path.string().c_str(), &width, &height, &components, static_cast<int>(desired_channel));
+		if (!stbi_info_from_memory(file.data(), static_cast<int>(file.size()), &width, &height, &components) || width <= 0 || height <= 0 || components <= 0) {
+			throw std::runtime_error("Could not read image header from " + path.string() + " : " + stbi_failure_reason());
+		}
+
+		unsigned int channels = desired_channel == PixelChannel::Unknow ? static_cast<unsigned int>(components) : static_cast<unsigned int>(desired_channel);
+		return ImageInfo{ static_cast<unsigned int>(width), static_cast<unsigned int>(height), channels };
+	}
+
+	Image::DecodedPixels Image::decode(const AssetFile& file, const std::filesystem::path& path, PixelChannel desired_channel, ImageInfo& info) {
+		check_size(file, path);
+
+		int width, height, components;
+		DecodedPixels image_data{ stbi_load_from_memory(file.data(), static_cast<int>(file.size()), &width, &height, &components, static_cast<int>(desired_channel)), stbi_image_free };
 		if ((image_data == nullptr) ||
 			(width <= 0) ||
 			(height <= 0) ||
 			(components <= 0)) {
-			stbi_image_free(image_data);
 			throw std::runtime_error("Could not read image data from " + path.string() + " : " + stbi_failure_reason());
 		}
 
-		int size = (width) * (height) * (static_cast<int>(desired_channel) <= 0 ? components : static_cast<int>(desired_channel));
+		info.width = static_cast<unsigned int>(width);
+		info.height = static_cast<unsigned int>(height);
+		info.channels = desired_channel == PixelChannel::Unknow ? static_cast<unsigned int>(components) : static_cast<unsigned int>(desired_channel);
+
+		return image_data;
+	}
 
-		std::vector<unsigned char> output(size);
-		std::memcpy(&output[0], image_data, size);
+	AssetFile Image::open_image(const std::filesystem::path& path) {
+		AssetFile file = AssetFile::Open(path);
+		check_size(file, path);
 
-		stbi_image_free(image_data);
-		return Image{ static_cast<unsigned>(width), static_cast<unsigned>(height), static_cast<unsigned>(desired_channel), output };
+		return file;
 	}
-}
 
+	void Image::check_size(const AssetFile& file, const std::filesystem::path& path) {
+		if (file.size() > static_cast<size_t>(std::numeric_limits<int>::max())) {
+			throw std::runtime_error("Image " + path.string() + " is too large to decode");
+		}
+	}
+}
@@ -0,0 +1,189 @@
+#include <Utils/MappedFile.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#if defined _WIN32
+// Keeps the min and max macros from hiding std::min
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <Windows.h>
+#elif defined __unix__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Nth {
+	MappedFile::MappedFile() :
+		m_data(nullptr),
+		m_size(0)
+	#if defined _WIN32
+		, m_file(INVALID_HANDLE_VALUE),
+		m_mapping(nullptr)
+	#endif
+		{}
+
+	MappedFile::MappedFile(const std::filesystem::path& path) :
+		MappedFile() {
+		open(path);
+	}
+
+	MappedFile::MappedFile(MappedFile&& other) :
+		m_data(std::exchange(other.m_data, nullptr)),
+		m_size(std::exchange(other.m_size, 0))
+	#if defined _WIN32
+		, m_file(std::exchange(other.m_file, INVALID_HANDLE_VALUE)),
+		m_mapping(std::exchange(other.m_mapping, nullptr))
+	#endif
+		{}
+
+	MappedFile::~MappedFile() {
+		close();
+	}
+
+	void MappedFile::open(const std::filesystem::path& path) {
+		close();
+
+	#if defined _WIN32
+		m_file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (m_file == INVALID_HANDLE_VALUE) {
+			throw std::runtime_error("Can't open file " + path.string());
+		}
+
+		LARGE_INTEGER file_size;
+		if (!GetFileSizeEx(m_file, &file_size) || file_size.QuadPart == 0) {
+			close();
+			throw std::runtime_error("Can't map empty file " + path.string());
+		}
+
+		m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		void* data = m_mapping ? MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+		if (!data) {
+			close();
+			throw std::runtime_error("Can't map file " + path.string());
+		}
+
+		m_data = static_cast<const uint8_t*>(data);
+		m_size = static_cast<size_t>(file_size.QuadPart);
+	#elif defined __unix__
+		int file = ::open(path.c_str(), O_RDONLY);
+		if (file < 0) {
+			throw std::runtime_error("Can't open file " + path.string());
+		}
+
+		struct stat file_stat;
+		if (fstat(file, &file_stat) != 0 || file_stat.st_size == 0) {
+			::close(file);
+			throw std::runtime_error("Can't map empty file " + path.string());
+		}
+
+		// The mapping keeps its own reference to the file
+		void* data = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+		::close(file);
+
+		if (data == MAP_FAILED) {
+			throw std::runtime_error("Can't map file " + path.string());
+		}
+
+		m_data = static_cast<const uint8_t*>(data);
+		m_size = static_cast<size_t>(file_stat.st_size);
+	#else
+		#error "OS not supported"
+	#endif
+	}
+
+	void MappedFile::close() {
+	#if defined _WIN32
+		if (m_data) {
+			UnmapViewOfFile(m_data);
+		}
+		if (m_mapping) {
+			CloseHandle(m_mapping);
+			m_mapping = nullptr;
+		}
+		if (m_file != INVALID_HANDLE_VALUE) {
+			CloseHandle(m_file);
+			m_file = INVALID_HANDLE_VALUE;
+		}
+	#elif defined __unix__
+		if (m_data) {
+			munmap(const_cast<uint8_t*>(m_data), m_size);
+		}
+	#endif
+
+		m_data = nullptr;
+		m_size = 0;
+	}
+
+	void MappedFile::advise(Access access, size_t offset, size_t size) const {
+		if (!m_data || offset >= m_size) {
+			return;
+		}
+
+		size = size == 0 ? m_size - offset : std::min(size, m_size - offset);
+
+	#if defined _WIN32
+		// Windows only takes prefetch requests
+		if (access == Access::WillNeed) {
+			WIN32_MEMORY_RANGE_ENTRY range{ const_cast<uint8_t*>(m_data) + offset, size };
+			PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+		}
+	#elif defined __unix__
+		// Ranges have to start on a page
+		size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+		size_t page_offset = offset - offset % page_size;
+
+		int advice = MADV_NORMAL;
+		switch (access) {
+		case Access::Normal:
+			advice = MADV_NORMAL;
+			break;
+		case Access::Sequential:
+			advice = MADV_SEQUENTIAL;
+			break;
+		case Access::Random:
+			advice = MADV_RANDOM;
+			break;
+		case Access::WillNeed:
+			advice = MADV_WILLNEED;
+			break;
+		}
+
+		madvise(const_cast<uint8_t*>(m_data) + page_offset, size + offset - page_offset, advice);
+	#endif
+	}
+
+	bool MappedFile::is_valid() const {
+		return m_data;
+	}
+
+	const uint8_t* MappedFile::data() const {
+		return m_data;
+	}
+
+	size_t MappedFile::size() const {
+		return m_size;
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) {
+		if (this != &other) {
+			close();
+
+			m_data = std::exchange(other.m_data, nullptr);
+			m_size = std::exchange(other.m_size, 0);
+		#if defined _WIN32
+			m_file = std::exchange(other.m_file, INVALID_HANDLE_VALUE);
+			m_mapping = std::exchange(other.m_mapping, nullptr);
+		#endif
+		}
+
+		return *this;
+	}
+}
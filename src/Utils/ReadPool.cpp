@@ -0,0 +1,129 @@
+#include <Utils/ReadPool.hpp>
+
+#include <Utils/AssetFile.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <utility>
+
+namespace Nth {
+	ReadPool::ReadPool(unsigned int thread_count) :
+		m_threads(),
+		m_jobs(),
+		m_mutex(),
+		m_condition(),
+		m_stopping(false) {
+		size_t worker_count = thread_count == 0 ? std::max(std::thread::hardware_concurrency(), 1u) : thread_count;
+		for (size_t i = 0; i < worker_count; ++i) {
+			m_threads.emplace_back([this]() { work(); });
+		}
+	}
+
+	ReadPool::~ReadPool() {
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stopping = true;
+		}
+		m_condition.notify_all();
+
+		for (auto& thread : m_threads) {
+			thread.join();
+		}
+	}
+
+	void ReadPool::run_batch(size_t count, const std::function<void(size_t)>& job) {
+		if (count == 0) {
+			return;
+		}
+
+		// Shared with helpers still queued once the batch is done, they find no job left and never touch job
+		struct Batch {
+			size_t count;
+			std::atomic<size_t> next;
+			size_t done;
+			std::mutex mutex;
+			std::condition_variable finished;
+			std::vector<std::exception_ptr> errors;
+		};
+
+		auto batch = std::make_shared<Batch>();
+		batch->count = count;
+		batch->next = 0;
+		batch->done = 0;
+		batch->errors.resize(count);
+
+		auto worker = [batch, &job]() {
+			for (size_t i = batch->next++; i < batch->count; i = batch->next++) {
+				try {
+					job(i);
+				}
+				catch (...) {
+					batch->errors[i] = std::current_exception();
+				}
+
+				std::lock_guard<std::mutex> lock(batch->mutex);
+				if (++batch->done == batch->count) {
+					batch->finished.notify_all();
+				}
+			}
+		};
+
+		for (size_t i = 1; i < std::min(m_threads.size() + 1, count); ++i) {
+			push(worker);
+		}
+
+		// Every worker may be busy with a job waiting on its own batch, the caller alone still gets through this one
+		worker();
+
+		{
+			std::unique_lock<std::mutex> lock(batch->mutex);
+			batch->finished.wait(lock, [&]() { return batch->done == batch->count; });
+		}
+
+		for (const std::exception_ptr& error : batch->errors) {
+			if (error) {
+				std::rethrow_exception(error);
+			}
+		}
+	}
+
+	void ReadPool::read_batch(const std::vector<std::filesystem::path>& paths, const std::function<void(size_t, const AssetFile&)>& callback) {
+		run_batch(paths.size(), [&](size_t i) {
+			AssetFile file = AssetFile::Open(paths[i]);
+			file.advise(MappedFile::Access::Sequential);
+			callback(i, file);
+		});
+	}
+
+	size_t ReadPool::thread_count() const {
+		return m_threads.size();
+	}
+
+	void ReadPool::push(std::function<void()>&& job) {
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_jobs.push_back(std::move(job));
+		}
+		m_condition.notify_one();
+	}
+
+	void ReadPool::work() {
+		while (true) {
+			std::function<void()> job;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_condition.wait(lock, [this]() { return m_stopping || !m_jobs.empty(); });
+				if (m_jobs.empty()) {
+					return;
+				}
+
+				job = std::move(m_jobs.front());
+				m_jobs.pop_front();
+			}
+
+			job();
+		}
+	}
+}
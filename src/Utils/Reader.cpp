@@ -1,14 +1,13 @@
 #include <Utils/Reader.hpp>
 
-#include <fstream>
-#include <filesystem>
-#include <iostream>
+#include <Utils/AssetFile.hpp>
 
 namespace Nth{
 	std::vector<char> read_binary_file(std::filesystem::path const& path) {
-		std::ifstream input(path, std::ios::binary);
+		AssetFile file = AssetFile::Open(path);
+		file.advise(MappedFile::Access::Sequential);
 
-		return std::vector<char>(std::istreambuf_iterator<char>(input), {});
+		const char* data = reinterpret_cast<const char*>(file.data());
+		return std::vector<char>(data, data + file.size());
 	}
 }
-
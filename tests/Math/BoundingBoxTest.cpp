@@ -0,0 +1,74 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include <Maths/BoundingBox.hpp>
+#include <Maths/Matrix4.hpp>
+
+using namespace Nth;
+
+TEST_CASE("BoundingBox", "[BoundingBox]") {
+	SECTION("Initialisation") {
+		BoundingBoxf empty;
+		REQUIRE(!empty.is_valid());
+
+		BoundingBoxf box{ { -1.f, -2.f, -3.f }, { 1.f, 2.f, 3.f } };
+		REQUIRE(box.is_valid());
+		REQUIRE(box.center() == Vector3f{ 0.f, 0.f, 0.f });
+		REQUIRE(box.extent() == Vector3f{ 1.f, 2.f, 3.f });
+	}
+
+	SECTION("Extend") {
+		BoundingBoxf box;
+		box.extend(Vector3f{ 1.f, 0.f, 0.f });
+		box.extend(Vector3f{ -1.f, 2.f, 0.5f });
+
+		REQUIRE(box == BoundingBoxf{ { -1.f, 0.f, 0.f }, { 1.f, 2.f, 0.5f } });
+
+		box.extend(BoundingBoxf{});
+		REQUIRE(box == BoundingBoxf{ { -1.f, 0.f, 0.f }, { 1.f, 2.f, 0.5f } });
+
+		box.extend(BoundingBoxf{ { 0.f, 0.f, 0.f }, { 4.f, 1.f, 1.f } });
+		REQUIRE(box == BoundingBoxf{ { -1.f, 0.f, 0.f }, { 4.f, 2.f, 1.f } });
+	}
+
+	SECTION("Query") {
+		BoundingBoxf box{ { 0.f, 0.f, 0.f }, { 1.f, 1.f, 1.f } };
+
+		REQUIRE(box.contains({ 0.5f, 0.5f, 0.5f }));
+		REQUIRE(!box.contains({ 1.5f, 0.5f, 0.5f }));
+
+		REQUIRE(box.intersect(BoundingBoxf{ { 0.5f, 0.5f, 0.5f }, { 2.f, 2.f, 2.f } }));
+		REQUIRE(!box.intersect(BoundingBoxf{ { 1.5f, 0.f, 0.f }, { 2.f, 1.f, 1.f } }));
+	}
+
+	SECTION("Ray") {
+		BoundingBoxf box{ { 0.f, 0.f, 0.f }, { 1.f, 1.f, 1.f } };
+
+		float distance = -1.f;
+		REQUIRE(box.intersect_ray({ -2.f, 0.5f, 0.5f }, { 1.f, 0.f, 0.f }, 10.f, distance));
+		REQUIRE(distance == 2.f);
+
+		REQUIRE(box.intersect_ray({ 0.5f, 0.5f, 0.5f }, { 0.f, 1.f, 0.f }, 10.f, distance));
+		REQUIRE(distance == 0.f);
+
+		REQUIRE(!box.intersect_ray({ -2.f, 0.5f, 0.5f }, { 1.f, 0.f, 0.f }, 1.f, distance));
+		REQUIRE(!box.intersect_ray({ -2.f, 1.5f, 0.5f }, { 1.f, 0.f, 0.f }, 10.f, distance));
+		REQUIRE(!box.intersect_ray({ -2.f, 0.5f, 0.5f }, { -1.f, 0.f, 0.f }, 10.f, distance));
+		REQUIRE(!BoundingBoxf{}.intersect_ray({ 0.f, 0.f, 0.f }, { 1.f, 0.f, 0.f }, 10.f, distance));
+	}
+
+	SECTION("Transformation") {
+		BoundingBoxf box{ { -1.f, -1.f, -1.f }, { 1.f, 1.f, 1.f } };
+
+		BoundingBoxf translated = box.transform(Matrix4f::Translation({ 2.f, 3.f, 4.f }));
+		REQUIRE(translated == BoundingBoxf{ { 1.f, 2.f, 3.f }, { 3.f, 4.f, 5.f } });
+
+		BoundingBoxf scaled = box.transform(Matrix4f::Scale({ 2.f, 1.f, 0.5f }));
+		REQUIRE(scaled == BoundingBoxf{ { -2.f, -1.f, -0.5f }, { 2.f, 1.f, 0.5f } });
+
+		BoundingBoxf rotated = box.transform(Matrix4f::Rotation(3.14159265f / 4.f, { 0.f, 0.f, 1.f }));
+		REQUIRE(rotated.max.x == Catch::Approx(std::sqrt(2.f)));
+		REQUIRE(rotated.max.y == Catch::Approx(std::sqrt(2.f)));
+		REQUIRE(rotated.max.z == Catch::Approx(1.f));
+	}
+}
@@ -0,0 +1,30 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <Maths/Frustum.hpp>
+#include <Maths/BoundingBox.hpp>
+#include <Maths/Matrix4.hpp>
+
+using namespace Nth;
+
+TEST_CASE("Frustum", "[Frustum]") {
+	// Looking down -z from the origin
+	Frustumf frustum{ Matrix4f::Perspective(1.5f, 1.f, 0.1f, 10.f) };
+
+	SECTION("Classification") {
+		REQUIRE(frustum.classify(BoundingBoxf{ { -0.5f, -0.5f, -3.f }, { 0.5f, 0.5f, -2.f } }) == FrustumContainment::Inside);
+		REQUIRE(frustum.classify(BoundingBoxf{ { -0.5f, -0.5f, -12.f }, { 0.5f, 0.5f, -8.f } }) == FrustumContainment::Intersecting);
+		REQUIRE(frustum.classify(BoundingBoxf{ { -0.5f, -0.5f, 1.f }, { 0.5f, 0.5f, 2.f } }) == FrustumContainment::Outside);
+		REQUIRE(frustum.classify(BoundingBoxf{ { -0.5f, -0.5f, -12.f }, { 0.5f, 0.5f, -11.f } }) == FrustumContainment::Outside);
+		REQUIRE(frustum.classify(BoundingBoxf{ { 20.f, -0.5f, -3.f }, { 21.f, 0.5f, -2.f } }) == FrustumContainment::Outside);
+		REQUIRE(frustum.classify(BoundingBoxf{}) == FrustumContainment::Outside);
+	}
+
+	SECTION("View") {
+		// Same volume seen from a camera moved along x
+		Matrix4f view = Matrix4f::Translation({ -5.f, 0.f, 0.f });
+		Frustumf moved{ Matrix4f::Perspective(1.5f, 1.f, 0.1f, 10.f) * view };
+
+		REQUIRE(moved.classify(BoundingBoxf{ { 4.5f, -0.5f, -3.f }, { 5.5f, 0.5f, -2.f } }) == FrustumContainment::Inside);
+		REQUIRE(moved.classify(BoundingBoxf{ { -0.5f, -0.5f, -3.f }, { 0.5f, 0.5f, -2.f } }) == FrustumContainment::Outside);
+	}
+}
@@ -0,0 +1,180 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <Renderer/BoundingVolumeHierarchy.hpp>
+
+#include <Maths/Vector4.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+using namespace Nth;
+
+TEST_CASE("BoundingVolumeHierarchy", "[BoundingVolumeHierarchy]") {
+	std::mt19937 generator{ 42 };
+	std::uniform_real_distribution<float> position{ -50.f, 50.f };
+	std::uniform_real_distribution<float> size{ 0.1f, 2.f };
+
+	auto random_box = [&]() {
+		Vector3f min{ position(generator), position(generator), position(generator) };
+		return BoundingBoxf{ min, min + Vector3f{ size(generator), size(generator), size(generator) } };
+	};
+
+	std::vector<BoundingBoxf> bounds;
+	for (size_t i = 0; i < 1000; ++i) {
+		bounds.push_back(random_box());
+	}
+
+	// Slots of removed objects
+	bounds[10] = BoundingBoxf{};
+	bounds[500] = BoundingBoxf{};
+
+	BoundingVolumeHierarchy bvh;
+	bvh.build(bounds);
+
+	auto brute_force = [&](const BoundingBoxf& box) {
+		std::vector<uint32_t> items;
+		for (size_t i = 0; i < bounds.size(); ++i) {
+			if (bounds[i].intersect(box)) {
+				items.push_back(static_cast<uint32_t>(i));
+			}
+		}
+
+		return items;
+	};
+
+	auto query = [&](const BoundingBoxf& box) {
+		std::vector<uint32_t> items;
+		bvh.query(box, items);
+		std::sort(items.begin(), items.end());
+
+		return items;
+	};
+
+	SECTION("Build") {
+		REQUIRE(bvh.size() == 998);
+		REQUIRE(bvh.node_count() < 2 * bvh.size());
+		REQUIRE(bvh.bounds().contains(bounds[0].min));
+
+		for (size_t i = 0; i < 50; ++i) {
+			BoundingBoxf box = random_box();
+			box.extend(random_box());
+			REQUIRE(query(box) == brute_force(box));
+		}
+	}
+
+	SECTION("Refit") {
+		float built_cost = bvh.cost();
+
+		for (uint32_t item = 0; item < 100; ++item) {
+			bounds[item] = BoundingBoxf{ bounds[item].min + Vector3f{ 1.f, 0.f, 0.f }, bounds[item].max + Vector3f{ 1.f, 0.f, 0.f } };
+			bvh.set(item, bounds[item]);
+		}
+
+		bounds[200] = BoundingBoxf{};
+		bvh.set(200, bounds[200]);
+		bvh.refresh();
+
+		REQUIRE(bvh.size() == 998);
+		REQUIRE(bvh.cost() <= built_cost * BoundingVolumeHierarchy::rebuild_cost_ratio);
+
+		BoundingBoxf everything{ Vector3f{ -100.f, -100.f, -100.f }, Vector3f{ 100.f, 100.f, 100.f } };
+		REQUIRE(query(everything) == brute_force(everything));
+		REQUIRE(query(bounds[5]) == brute_force(bounds[5]));
+	}
+
+	SECTION("Insertion") {
+		bounds[10] = random_box();
+		bounds.push_back(random_box());
+		bvh.set(10, bounds[10]);
+		bvh.set(1000, bounds[1000]);
+
+		// Not in the tree until refreshed
+		REQUIRE(query(bounds[1000]) != brute_force(bounds[1000]));
+
+		bvh.refresh();
+		REQUIRE(bvh.size() == 1000);
+		REQUIRE(query(bounds[1000]) == brute_force(bounds[1000]));
+		REQUIRE(query(bounds[10]) == brute_force(bounds[10]));
+	}
+
+	SECTION("Ray") {
+		Vector3f origin{ -60.f, 0.f, 0.f };
+		Vector3f direction{ 1.f, 0.f, 0.f };
+
+		bounds.push_back(BoundingBoxf{ Vector3f{ -55.f, -1.f, -1.f }, Vector3f{ -54.f, 1.f, 1.f } });
+		bvh.build(bounds);
+
+		std::vector<BoundingVolumeHit> hits;
+		bvh.query(origin, direction, 200.f, hits);
+
+		REQUIRE(!hits.empty());
+		REQUIRE(hits[0].item == 1000);
+		REQUIRE(hits[0].distance == 5.f);
+		REQUIRE(std::is_sorted(hits.begin(), hits.end(), [](const BoundingVolumeHit& a, const BoundingVolumeHit& b) { return a.distance < b.distance; }));
+
+		for (const BoundingVolumeHit& hit : hits) {
+			const BoundingBoxf& box = bounds[hit.item];
+			REQUIRE(box.min.y <= 0.f);
+			REQUIRE(box.max.y >= 0.f);
+			REQUIRE(box.min.z <= 0.f);
+			REQUIRE(box.max.z >= 0.f);
+		}
+
+		// Too short to reach the first box
+		hits.clear();
+		bvh.query(origin, direction, 4.f, hits);
+		REQUIRE(hits.empty());
+	}
+
+	SECTION("Frustum") {
+		// Camera at the origin looking down -z
+		Matrix4f view_projection = Matrix4f::Perspective(1.5f, 1.f, 0.1f, 40.f);
+
+		std::vector<uint32_t> visible;
+		bvh.cull(view_projection, visible);
+		std::sort(visible.begin(), visible.end());
+
+		REQUIRE(!visible.empty());
+		REQUIRE(visible.size() < bvh.size());
+
+		for (size_t i = 0; i < bounds.size(); ++i) {
+			if (!bounds[i].is_valid()) {
+				continue;
+			}
+
+			bool listed = std::binary_search(visible.begin(), visible.end(), static_cast<uint32_t>(i));
+
+			// Boxes with a corner in front of the camera, inside the clip volume, can't be culled
+			bool corner_inside = false;
+			for (int corner = 0; corner < 8; ++corner) {
+				Vector4f point{
+					(corner & 1) ? bounds[i].max.x : bounds[i].min.x,
+					(corner & 2) ? bounds[i].max.y : bounds[i].min.y,
+					(corner & 4) ? bounds[i].max.z : bounds[i].min.z,
+					1.f
+				};
+				Vector4f clip = point * view_projection;
+				corner_inside = corner_inside || (std::abs(clip.x) <= clip.w && std::abs(clip.y) <= clip.w && clip.z >= 0.f && clip.z <= clip.w);
+			}
+
+			if (corner_inside) {
+				REQUIRE(listed);
+			}
+			// Behind the camera
+			if (bounds[i].min.z > 0.f) {
+				REQUIRE(!listed);
+			}
+		}
+
+		// Extra test rejecting subtrees, it must hold for a node whenever it holds for one of its items
+		std::vector<uint32_t> filtered;
+		bvh.cull(view_projection, filtered, [](const BoundingBoxf& box) { return box.min.x < 0.f; });
+		REQUIRE(!filtered.empty());
+		REQUIRE(filtered.size() < visible.size());
+		for (uint32_t item : filtered) {
+			REQUIRE(bounds[item].min.x < 0.f);
+			REQUIRE(std::binary_search(visible.begin(), visible.end(), item));
+		}
+	}
+}
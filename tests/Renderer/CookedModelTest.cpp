@@ -0,0 +1,209 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <Renderer/CookedModel.hpp>
+#include <Renderer/Mesh.hpp>
+#include <Renderer/Model.hpp>
+
+#include <Utils/Archive.hpp>
+#include <Utils/AssetFile.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+using namespace Nth;
+
+TEST_CASE("CookedModel", "[CookedModel]") {
+	std::filesystem::path path = std::filesystem::temp_directory_path() / "nth_cooked_model_test.nthc";
+
+	// Grid with levels of detail and meshlets
+	Mesh grid;
+	const uint32_t size = 16;
+	for (uint32_t y = 0; y <= size; ++y) {
+		for (uint32_t x = 0; x <= size; ++x) {
+			Vertex vertex;
+			vertex.pos = { static_cast<float>(x), static_cast<float>(y), 0.f };
+			vertex.texture_pos = { static_cast<float>(x) / size, static_cast<float>(y) / size };
+			vertex.normal = { 0.f, 0.f, 1.f };
+			grid.vertices.push_back(vertex);
+		}
+	}
+	for (uint32_t y = 0; y < size; ++y) {
+		for (uint32_t x = 0; x < size; ++x) {
+			uint32_t corner = y * (size + 1) + x;
+			grid.indices.insert(grid.indices.end(), { corner, corner + 1, corner + size + 2, corner, corner + size + 2, corner + size + 1 });
+		}
+	}
+	grid.textures_index = { 1 };
+	grid.update_bounds();
+	grid.generate_lods(2, 0.5f);
+	grid.generate_meshlets();
+
+	Mesh occluder = Mesh::Plane();
+	occluder.occluder = true;
+	occluder.quantize();
+
+	std::vector<Texture> textures(2);
+	textures[0].type = "texture_diffuse";
+	textures[0].path = "textures/diffuse.png";
+	textures[1].type = "base_color";
+	textures[1].path = "textures/albedo.png";
+
+	Matrix4f transform = Matrix4f::Translation(Vector3f{ 1.f, 2.f, 3.f });
+	std::vector<ModelInstance> instances{ ModelInstance{ 0, Matrix4f::Identity() }, ModelInstance{ 0, transform }, ModelInstance{ 1, transform } };
+
+	save_cooked_model({ grid, occluder }, textures, instances, path);
+
+	SECTION("Round trip") {
+		CookedModel model = CookedModel::LoadFromFile(path);
+		REQUIRE(model.meshes().size() == 2);
+
+		const CookedMesh& cooked_grid = model.meshes()[0];
+		REQUIRE(cooked_grid.vertex_format == VertexFormat::Full);
+		REQUIRE(cooked_grid.vertex_count == grid.vertices.size());
+		REQUIRE(cooked_grid.bounds == grid.bounds);
+		REQUIRE(cooked_grid.vertices % CookedModel::blob_alignment == 0);
+		REQUIRE(cooked_grid.indices % CookedModel::blob_alignment == 0);
+		REQUIRE(std::memcmp(model.vertices(cooked_grid), grid.vertices.data(), cooked_grid.vertices_size) == 0);
+
+		// Every level is in the index blob, as uploaded
+		std::vector<CookedLod> lods = model.lods(cooked_grid);
+		REQUIRE(lods.size() == grid.lods.size() + 1);
+		REQUIRE(lods[0].index_count == grid.indices.size());
+		REQUIRE(model.unpack_indices(cooked_grid) == grid.indices);
+
+		std::vector<uint32_t> indices = grid.indices;
+		for (size_t i = 0; i < grid.lods.size(); ++i) {
+			REQUIRE(lods[i + 1].first_index == indices.size());
+			REQUIRE(lods[i + 1].error == grid.lods[i].error);
+			indices.insert(indices.end(), grid.lods[i].indices.begin(), grid.lods[i].indices.end());
+		}
+		std::vector<uint8_t> packed = Mesh::pack_indices(indices, grid.index_format());
+		REQUIRE(cooked_grid.index_format == IndexFormat::UInt16);
+		REQUIRE(cooked_grid.indices_size == packed.size());
+		REQUIRE(std::memcmp(model.indices(cooked_grid), packed.data(), packed.size()) == 0);
+
+		std::vector<Meshlet> meshlets = model.meshlets(cooked_grid);
+		REQUIRE(meshlets.size() == grid.meshlets.size());
+		REQUIRE(meshlets.back().first_index == grid.meshlets.back().first_index);
+		REQUIRE(meshlets.back().bounds == grid.meshlets.back().bounds);
+		REQUIRE(model.texture_indices(cooked_grid) == std::vector<uint32_t>{ 1 });
+
+		// Quantized vertices are stored as they are uploaded
+		const CookedMesh& cooked_occluder = model.meshes()[1];
+		REQUIRE(cooked_occluder.vertex_format == VertexFormat::Quantized);
+		REQUIRE(cooked_occluder.occluder == 1);
+		REQUIRE(cooked_occluder.vertices_size == occluder.quantized_vertices.size() * sizeof(QuantizedVertex));
+		REQUIRE(model.unpack_indices(cooked_occluder) == occluder.indices);
+
+		std::vector<Vector3f> positions = model.unpack_positions(cooked_occluder);
+		REQUIRE(positions.size() == occluder.vertices.size());
+		for (size_t i = 0; i < positions.size(); ++i) {
+			REQUIRE((positions[i] - occluder.vertices[i].pos).length() < 1e-3f);
+		}
+
+		REQUIRE(model.texture_count() == 2);
+		REQUIRE(model.texture_path(0) == "textures/diffuse.png");
+		REQUIRE(model.texture_type(0) == "texture_diffuse");
+		REQUIRE(model.texture_path(1) == "textures/albedo.png");
+		REQUIRE(model.texture_type(1) == "base_color");
+
+		std::vector<ModelInstance> loaded_instances = model.instances();
+		REQUIRE(loaded_instances.size() == 3);
+		REQUIRE(loaded_instances[1].mesh_index == 0);
+		REQUIRE(loaded_instances[2].mesh_index == 1);
+		REQUIRE(loaded_instances[2].transform == transform);
+	}
+
+	SECTION("Packed in an archive") {
+		std::filesystem::path archive = std::filesystem::temp_directory_path() / "nth_cooked_model_test.ntha";
+		save_archive(path.parent_path(), { path }, archive);
+
+		std::vector<char> bytes;
+		{
+			std::ifstream input(path, std::ios::binary);
+			bytes.assign(std::istreambuf_iterator<char>(input), {});
+		}
+		std::filesystem::remove(path);
+
+		// Found by the path of the loose file it was packed from
+		std::filesystem::path working_directory = std::filesystem::current_path();
+		std::filesystem::current_path(path.parent_path());
+		AssetFile::Mount(archive);
+
+		CookedModel model = CookedModel::LoadFromFile(path);
+		REQUIRE(model.meshes().size() == 2);
+		REQUIRE(model.texture_file(1) == path.parent_path() / "textures/albedo.png");
+		REQUIRE(std::memcmp(model.vertices(model.meshes()[0]), bytes.data() + model.meshes()[0].vertices, model.meshes()[0].vertices_size) == 0);
+		REQUIRE(model.unpack_indices(model.meshes()[1]) == occluder.indices);
+
+		AssetFile::UnmountAll();
+		std::filesystem::current_path(working_directory);
+		std::filesystem::remove(archive);
+	}
+
+	SECTION("Invalid files") {
+		std::vector<char> bytes;
+		{
+			std::ifstream input(path, std::ios::binary);
+			bytes.assign(std::istreambuf_iterator<char>(input), {});
+		}
+
+		auto write = [&](const std::vector<char>& content) {
+			std::ofstream output(path, std::ios::binary | std::ios::trunc);
+			output.write(content.data(), static_cast<std::streamsize>(content.size()));
+		};
+
+		write(std::vector<char>(bytes.begin(), bytes.end() - 16));
+		REQUIRE_THROWS_AS(CookedModel::LoadFromFile(path), std::runtime_error);
+
+		std::vector<char> wrong_version = bytes;
+		wrong_version[4] = 2;
+		write(wrong_version);
+		REQUIRE_THROWS_AS(CookedModel::LoadFromFile(path), std::runtime_error);
+
+		std::vector<char> wrong_magic = bytes;
+		wrong_magic[0] = 'X';
+		write(wrong_magic);
+		REQUIRE_THROWS_AS(CookedModel::LoadFromFile(path), std::runtime_error);
+
+		CookedHeader header;
+		std::memcpy(&header, bytes.data(), sizeof(CookedHeader));
+
+		std::vector<char> missing_mesh = bytes;
+		uint32_t mesh_index = header.mesh_count;
+		std::memcpy(missing_mesh.data() + header.instance_table + 2 * sizeof(CookedInstance) + offsetof(CookedInstance, mesh_index), &mesh_index, sizeof(uint32_t));
+		write(missing_mesh);
+		REQUIRE_THROWS_AS(CookedModel::LoadFromFile(path), std::runtime_error);
+
+		// The plane is the second mesh, an occluder with 16 bit indices
+		CookedMesh plane;
+		std::memcpy(&plane, bytes.data() + header.mesh_table + sizeof(CookedMesh), sizeof(CookedMesh));
+		REQUIRE(plane.occluder == 1);
+		REQUIRE(plane.index_format == IndexFormat::UInt16);
+
+		std::vector<char> index_outside = bytes;
+		uint16_t vertex_index = static_cast<uint16_t>(plane.vertex_count);
+		std::memcpy(index_outside.data() + plane.indices + sizeof(uint16_t), &vertex_index, sizeof(uint16_t));
+		write(index_outside);
+		REQUIRE_THROWS_AS(CookedModel::LoadFromFile(path), std::runtime_error);
+
+		std::vector<char> partial_triangle = bytes;
+		CookedLod level;
+		std::memcpy(&level, bytes.data() + plane.lods, sizeof(CookedLod));
+		level.index_count -= 1;
+		std::memcpy(partial_triangle.data() + plane.lods, &level, sizeof(CookedLod));
+		write(partial_triangle);
+		REQUIRE_THROWS_AS(CookedModel::LoadFromFile(path), std::runtime_error);
+
+		write(bytes);
+		REQUIRE_NOTHROW(CookedModel::LoadFromFile(path));
+
+		textures[0].type = "normal";
+		REQUIRE_THROWS_AS(save_cooked_model({ grid }, textures, {}, path), std::runtime_error);
+	}
+
+	std::filesystem::remove(path);
+}
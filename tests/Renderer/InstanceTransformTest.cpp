@@ -0,0 +1,61 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <Renderer/InstanceTransform.hpp>
+
+#include <Maths/Vector3.hpp>
+#include <Maths/Vector4.hpp>
+
+#include <cmath>
+
+using namespace Nth;
+
+TEST_CASE("InstanceTransform", "[InstanceTransform]") {
+	SECTION("Inverse transpose") {
+		Matrix4f model = Matrix4f::Scale({ 2.f, 0.5f, 3.f }) * Matrix4f::Rotation(0.7f, { 0.f, 1.f, 0.f }) * Matrix4f::Translation({ 1.f, 2.f, 3.f });
+
+		std::vector<ModelGpuObject> objects(1);
+		objects[0].model = model;
+		compute_normal_matrices(objects);
+
+		// Column j of the GLSL mat3 is column j of the inverse, with the shader reading rows as columns
+		Matrix4f inverse = model.inv();
+		const float expected[3][3] = {
+			{ inverse.a11, inverse.a21, inverse.a31 },
+			{ inverse.a12, inverse.a22, inverse.a32 },
+			{ inverse.a13, inverse.a23, inverse.a33 }
+		};
+
+		for (size_t j = 0; j < 3; ++j) {
+			REQUIRE(std::abs(objects[0].normal[j].x - expected[j][0]) < 1e-5f);
+			REQUIRE(std::abs(objects[0].normal[j].y - expected[j][1]) < 1e-5f);
+			REQUIRE(std::abs(objects[0].normal[j].z - expected[j][2]) < 1e-5f);
+			REQUIRE(objects[0].normal[j].w == 0.f);
+		}
+	}
+
+	SECTION("Degenerate") {
+		std::vector<ModelGpuObject> objects(1);
+		objects[0].model = Matrix4f::Scale({ 1.f, 0.f, 1.f });
+		compute_normal_matrices(objects);
+
+		for (size_t j = 0; j < 3; ++j) {
+			REQUIRE(objects[0].normal[j].x == 0.f);
+			REQUIRE(objects[0].normal[j].y == 0.f);
+			REQUIRE(objects[0].normal[j].z == 0.f);
+		}
+	}
+
+	SECTION("Affine") {
+		Matrix4f model = Matrix4f::Scale({ 2.f, 0.5f, 3.f }) * Matrix4f::Rotation(0.7f, { 0.f, 1.f, 0.f }) * Matrix4f::Translation({ 1.f, 2.f, 3.f });
+		AffineModelGpuObject affine = make_affine_model(model);
+
+		// Each column gives one coordinate of the transformed point
+		Vector4f point{ 0.3f, -1.2f, 4.f, 1.f };
+		Vector4f expected = point * model;
+
+		REQUIRE(std::abs(affine.columns[0].dot_product(point) - expected.x) < 1e-5f);
+		REQUIRE(std::abs(affine.columns[1].dot_product(point) - expected.y) < 1e-5f);
+		REQUIRE(std::abs(affine.columns[2].dot_product(point) - expected.z) < 1e-5f);
+		REQUIRE(expected.w == 1.f);
+	}
+}
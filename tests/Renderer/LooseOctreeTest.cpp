@@ -0,0 +1,241 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <Renderer/LooseOctree.hpp>
+#include <Renderer/BoundingVolumeHierarchy.hpp>
+
+#include <Maths/Frustum.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+
+using namespace Nth;
+
+TEST_CASE("LooseOctree", "[LooseOctree]") {
+	std::mt19937 generator{ 7 };
+	std::uniform_real_distribution<float> position{ -50.f, 50.f };
+	std::uniform_real_distribution<float> size{ 0.1f, 4.f };
+
+	auto random_box = [&]() {
+		Vector3f min{ position(generator), position(generator), position(generator) };
+		return BoundingBoxf{ min, min + Vector3f{ size(generator), size(generator), size(generator) } };
+	};
+
+	LooseOctree octree{ BoundingBoxf{ { -64.f, -64.f, -64.f }, { 64.f, 64.f, 64.f } }, 6 };
+
+	std::vector<BoundingBoxf> bounds;
+	for (uint32_t i = 0; i < 500; ++i) {
+		bounds.push_back(random_box());
+		octree.set(i, bounds[i]);
+	}
+
+	// Partly outside the region
+	bounds.push_back(BoundingBoxf{ { 60.f, 0.f, 0.f }, { 80.f, 1.f, 1.f } });
+	octree.set(500, bounds[500]);
+	// Centered outside of it
+	bounds.push_back(BoundingBoxf{ { 100.f, 0.f, 0.f }, { 101.f, 1.f, 1.f } });
+	octree.set(501, bounds[501]);
+
+	auto brute_force = [&](const BoundingBoxf& box) {
+		std::vector<uint32_t> items;
+		for (size_t i = 0; i < bounds.size(); ++i) {
+			if (octree.contains(static_cast<uint32_t>(i)) && bounds[i].intersect(box)) {
+				items.push_back(static_cast<uint32_t>(i));
+			}
+		}
+
+		return items;
+	};
+
+	auto query = [&](const BoundingBoxf& box) {
+		std::vector<uint32_t> items;
+		octree.query(box, items);
+		std::sort(items.begin(), items.end());
+
+		return items;
+	};
+
+	SECTION("Queries") {
+		REQUIRE(octree.size() == 502);
+
+		for (size_t i = 0; i < 50; ++i) {
+			BoundingBoxf box = random_box();
+			box.extend(random_box());
+			REQUIRE(query(box) == brute_force(box));
+		}
+
+		REQUIRE(query(BoundingBoxf{ { 99.f, 0.f, 0.f }, { 99.5f, 1.f, 1.f } }).empty());
+		REQUIRE(query(BoundingBoxf{ { 100.5f, 0.f, 0.f }, { 110.f, 1.f, 1.f } }) == std::vector<uint32_t>{ 501 });
+		REQUIRE(query(BoundingBoxf{ { 75.f, 0.f, 0.f }, { 76.f, 1.f, 1.f } }) == std::vector<uint32_t>{ 500 });
+	}
+
+	SECTION("Relocation") {
+		// Small moves keep most items in their cell, the result must not depend on it
+		for (size_t frame = 0; frame < 10; ++frame) {
+			for (uint32_t i = 0; i < 500; ++i) {
+				Vector3f offset{ 0.5f, -0.25f, 0.1f };
+				bounds[i] = BoundingBoxf{ bounds[i].min + offset, bounds[i].max + offset };
+				octree.set(i, bounds[i]);
+			}
+		}
+
+		octree.remove(3);
+		octree.set(4, BoundingBoxf{});
+		REQUIRE(!octree.contains(3));
+		REQUIRE(!octree.contains(4));
+		REQUIRE(octree.size() == 500);
+
+		BoundingBoxf everything{ { -200.f, -200.f, -200.f }, { 200.f, 200.f, 200.f } };
+		REQUIRE(query(everything) == brute_force(everything));
+		REQUIRE(query(bounds[10]) == brute_force(bounds[10]));
+
+		// Empty cells are kept for later moves until the tree is pruned
+		size_t cell_count = octree.cell_count();
+		for (uint32_t i = 0; i < bounds.size(); ++i) {
+			octree.remove(i);
+		}
+		REQUIRE(octree.size() == 0);
+		REQUIRE(octree.cell_count() == cell_count);
+		REQUIRE(query(everything).empty());
+
+		octree.refresh();
+		REQUIRE(octree.cell_count() == 1);
+
+		// Pruned cells are recycled
+		octree.set(0, bounds[0]);
+		REQUIRE(octree.cell_count() > 1);
+		REQUIRE(query(everything) == std::vector<uint32_t>{ 0 });
+	}
+
+	SECTION("Ray") {
+		std::vector<BoundingVolumeHit> hits;
+		octree.query(Vector3f{ 90.f, 0.5f, 0.5f }, Vector3f{ 1.f, 0.f, 0.f }, 20.f, hits);
+
+		REQUIRE(hits.size() == 1);
+		REQUIRE(hits[0].item == 501);
+		REQUIRE(hits[0].distance == 10.f);
+
+		hits.clear();
+		octree.query(Vector3f{ -70.f, 0.f, 0.f }, Vector3f{ 1.f, 0.f, 0.f }, 200.f, hits);
+		REQUIRE(std::is_sorted(hits.begin(), hits.end(), [](const BoundingVolumeHit& a, const BoundingVolumeHit& b) { return a.distance < b.distance; }));
+
+		size_t expected = 0;
+		float distance;
+		for (const BoundingBoxf& box : bounds) {
+			expected += box.intersect_ray(Vector3f{ -70.f, 0.f, 0.f }, Vector3f{ 1.f, 0.f, 0.f }, 200.f, distance) ? 1 : 0;
+		}
+		REQUIRE(hits.size() == expected);
+	}
+
+	SECTION("Frustum") {
+		Matrix4f view_projection = Matrix4f::Perspective(1.5f, 1.f, 0.1f, 40.f);
+		Frustumf frustum{ view_projection };
+
+		std::vector<uint32_t> visible;
+		octree.cull(view_projection, visible);
+		std::sort(visible.begin(), visible.end());
+
+		std::vector<uint32_t> expected;
+		for (size_t i = 0; i < bounds.size(); ++i) {
+			if (frustum.classify(bounds[i]) != FrustumContainment::Outside) {
+				expected.push_back(static_cast<uint32_t>(i));
+			}
+		}
+
+		REQUIRE(!visible.empty());
+		REQUIRE(visible == expected);
+	}
+}
+
+TEST_CASE("LooseOctree benchmark", "[.][benchmark]") {
+	// Objects move every frame, the tree structures are compared with testing every box
+	const uint32_t object_count = GENERATE(1000u, 10000u, 100000u);
+	const std::string suffix = " (" + std::to_string(object_count) + " objects)";
+
+	std::mt19937 generator{ 42 };
+	std::uniform_real_distribution<float> position{ -500.f, 500.f };
+	std::uniform_real_distribution<float> size{ 0.5f, 4.f };
+	std::uniform_real_distribution<float> speed{ -1.f, 1.f };
+
+	std::vector<BoundingBoxf> start;
+	std::vector<Vector3f> velocities;
+	for (uint32_t i = 0; i < object_count; ++i) {
+		Vector3f min{ position(generator), position(generator), position(generator) };
+		start.push_back(BoundingBoxf{ min, min + Vector3f{ size(generator), size(generator), size(generator) } });
+		velocities.push_back(Vector3f{ speed(generator), speed(generator), speed(generator) });
+	}
+
+	std::vector<BoundingBoxf> bounds = start;
+	uint32_t frame = 0;
+	auto move = [&](uint32_t i) {
+		Vector3f offset = velocities[i] * static_cast<float>(frame % 64);
+		bounds[i] = BoundingBoxf{ start[i].min + offset, start[i].max + offset };
+	};
+
+	LooseOctree octree{ BoundingBoxf{ { -600.f, -600.f, -600.f }, { 600.f, 600.f, 600.f } } };
+	for (uint32_t i = 0; i < object_count; ++i) {
+		octree.set(i, bounds[i]);
+	}
+
+	BoundingVolumeHierarchy bvh;
+	bvh.build(bounds);
+
+	// Looking down -z from the middle of the objects
+	Matrix4f view_projection = Matrix4f::Perspective(1.f, 16.f / 9.f, 0.1f, 300.f);
+	Frustumf frustum{ view_projection };
+	std::vector<uint32_t> visible;
+	visible.reserve(object_count);
+
+	BENCHMARK("Linear update" + suffix) {
+		++frame;
+		for (uint32_t i = 0; i < object_count; ++i) {
+			move(i);
+		}
+		return bounds.size();
+	};
+
+	BENCHMARK("LooseOctree update" + suffix) {
+		++frame;
+		for (uint32_t i = 0; i < object_count; ++i) {
+			move(i);
+			octree.set(i, bounds[i]);
+		}
+		octree.refresh();
+		return octree.size();
+	};
+
+	BENCHMARK("BoundingVolumeHierarchy update" + suffix) {
+		++frame;
+		for (uint32_t i = 0; i < object_count; ++i) {
+			move(i);
+			bvh.set(i, bounds[i]);
+		}
+		bvh.refresh();
+		return bvh.size();
+	};
+
+	BENCHMARK("Linear query" + suffix) {
+		visible.clear();
+		for (uint32_t i = 0; i < object_count; ++i) {
+			if (frustum.classify(bounds[i]) != FrustumContainment::Outside) {
+				visible.push_back(i);
+			}
+		}
+		return visible.size();
+	};
+
+	BENCHMARK("LooseOctree query" + suffix) {
+		visible.clear();
+		octree.cull(view_projection, visible);
+		return visible.size();
+	};
+
+	BENCHMARK("BoundingVolumeHierarchy query" + suffix) {
+		visible.clear();
+		bvh.cull(view_projection, visible);
+		return visible.size();
+	};
+}
@@ -0,0 +1,119 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <Renderer/ImportOptions.hpp>
+#include <Renderer/Mesh.hpp>
+#include <Renderer/MeshLod.hpp>
+
+#include <cmath>
+#include <set>
+
+using namespace Nth;
+
+TEST_CASE("MeshLod", "[MeshLod]") {
+	// Flat 16x16 grid, every collapse inside it is free
+	const uint32_t size = 16;
+
+	std::vector<Vertex> vertices;
+	for (uint32_t y = 0; y <= size; ++y) {
+		for (uint32_t x = 0; x <= size; ++x) {
+			Vertex vertex{};
+			vertex.pos = { static_cast<float>(x), static_cast<float>(y), 0.f };
+			vertex.normal = { 0.f, 0.f, 1.f };
+			vertices.push_back(vertex);
+		}
+	}
+
+	std::vector<uint32_t> indices;
+	for (uint32_t y = 0; y < size; ++y) {
+		for (uint32_t x = 0; x < size; ++x) {
+			uint32_t i = y * (size + 1) + x;
+			indices.insert(indices.end(), { i, i + 1, i + size + 2, i, i + size + 2, i + size + 1 });
+		}
+	}
+
+	SECTION("Simplification") {
+		MeshLod lod = simplify_mesh(vertices, indices, indices.size() / 4);
+
+		REQUIRE(lod.indices.size() % 3 == 0);
+		REQUIRE(lod.indices.size() <= indices.size() / 2);
+		REQUIRE(lod.error < 1e-3f);
+
+		for (size_t i = 0; i < lod.indices.size(); i += 3) {
+			const Vector3f& a = vertices[lod.indices[i]].pos;
+			const Vector3f& b = vertices[lod.indices[i + 1]].pos;
+			const Vector3f& c = vertices[lod.indices[i + 2]].pos;
+
+			// Same winding as the source
+			float cross_z = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+			REQUIRE(cross_z > 0.f);
+		}
+
+		// Borders stay in place, so the corners are kept
+		std::set<uint32_t> used(lod.indices.begin(), lod.indices.end());
+		REQUIRE(used.count(0) == 1);
+		REQUIRE(used.count(size) == 1);
+		REQUIRE(used.count(size * (size + 1)) == 1);
+		REQUIRE(used.count((size + 1) * (size + 1) - 1) == 1);
+	}
+
+	SECTION("Error") {
+		// Pulling the center up makes the surface curved, simplification can't be free anymore
+		for (Vertex& vertex : vertices) {
+			float dx = vertex.pos.x - size * 0.5f;
+			float dy = vertex.pos.y - size * 0.5f;
+			vertex.pos.z = 4.f * std::exp(-(dx * dx + dy * dy) / 16.f);
+		}
+
+		MeshLod lod = simplify_mesh(vertices, indices, indices.size() / 8);
+
+		REQUIRE(lod.indices.size() < indices.size());
+		REQUIRE(lod.error > 0.f);
+	}
+
+	SECTION("Target reached") {
+		MeshLod lod = simplify_mesh(vertices, indices, indices.size());
+
+		REQUIRE(lod.indices == indices);
+		REQUIRE(lod.error == 0.f);
+	}
+
+	SECTION("Import options") {
+		ImportOptions options;
+		options.optimize_meshes = true;
+		options.build_meshlets = true;
+		options.quantize_vertices = true;
+		options.lod_count = 2;
+		options.lod_reduction = 0.5f;
+
+		Mesh mesh{ vertices, indices, {} };
+		mesh.prepare(options);
+
+		// Built on the optimized vertex order, so every level still indexes the final vertices
+		REQUIRE(mesh.lods.size() == 2);
+		REQUIRE(mesh.lods[0].indices.size() <= indices.size() / 2);
+		REQUIRE(mesh.lods[1].indices.size() < mesh.lods[0].indices.size());
+		for (const MeshLod& lod : mesh.lods) {
+			for (uint32_t index : lod.indices) {
+				REQUIRE(index < mesh.vertices.size());
+			}
+		}
+
+		REQUIRE_FALSE(mesh.meshlets.empty());
+		REQUIRE(mesh.quantized_vertices.size() == mesh.vertices.size());
+	}
+
+	SECTION("Selection") {
+		std::vector<float> errors = { 0.f, 0.01f, 0.1f };
+
+		REQUIRE(select_lod(errors, 1000.f, 1.f, 0.2f, 0) == 0);
+		REQUIRE(select_lod(errors, 50.f, 1.f, 0.2f, 0) == 1);
+		REQUIRE(select_lod(errors, 1.f, 1.f, 0.2f, 0) == 2);
+		REQUIRE(select_lod(errors, 1000.f, 1.f, 0.2f, 2) == 0);
+
+		// Between the two thresholds the current level is kept
+		REQUIRE(select_lod(errors, 90.f, 1.f, 0.2f, 0) == 0);
+		REQUIRE(select_lod(errors, 90.f, 1.f, 0.2f, 1) == 1);
+		REQUIRE(select_lod(errors, 9.f, 1.f, 0.2f, 1) == 1);
+		REQUIRE(select_lod(errors, 9.f, 1.f, 0.2f, 2) == 2);
+	}
+}
@@ -0,0 +1,107 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <Renderer/MeshOptimization.hpp>
+
+#include <algorithm>
+#include <array>
+#include <random>
+
+using namespace Nth;
+
+TEST_CASE("MeshOptimization", "[MeshOptimization]") {
+	// 32x32 grid whose triangles are shuffled, the worst case for the vertex cache
+	const uint32_t size = 32;
+
+	std::vector<Vertex> vertices;
+	for (uint32_t y = 0; y <= size; ++y) {
+		for (uint32_t x = 0; x <= size; ++x) {
+			Vertex vertex{};
+			vertex.pos = { static_cast<float>(x), static_cast<float>(y), 0.f };
+			vertex.normal = { 0.f, 0.f, 1.f };
+			vertices.push_back(vertex);
+		}
+	}
+
+	std::vector<std::array<uint32_t, 3>> triangles;
+	for (uint32_t y = 0; y < size; ++y) {
+		for (uint32_t x = 0; x < size; ++x) {
+			uint32_t i = y * (size + 1) + x;
+			triangles.push_back({ i, i + 1, i + size + 2 });
+			triangles.push_back({ i, i + size + 2, i + size + 1 });
+		}
+	}
+	std::shuffle(triangles.begin(), triangles.end(), std::mt19937{ 42 });
+
+	std::vector<uint32_t> indices;
+	for (const auto& triangle : triangles) {
+		indices.insert(indices.end(), triangle.begin(), triangle.end());
+	}
+
+	// Triangles as sorted corner positions, to compare meshes whatever their order
+	auto triangle_set = [](const std::vector<Vertex>& mesh_vertices, const std::vector<uint32_t>& mesh_indices) {
+		std::vector<std::array<float, 6>> result;
+		for (size_t i = 0; i < mesh_indices.size(); i += 3) {
+			std::array<std::array<float, 2>, 3> corners;
+			for (size_t corner = 0; corner < 3; ++corner) {
+				const Vector3f& position = mesh_vertices[mesh_indices[i + corner]].pos;
+				corners[corner] = { position.x, position.y };
+			}
+			std::sort(corners.begin(), corners.end());
+			result.push_back({ corners[0][0], corners[0][1], corners[1][0], corners[1][1], corners[2][0], corners[2][1] });
+		}
+		std::sort(result.begin(), result.end());
+		return result;
+	};
+
+	SECTION("Statistics") {
+		std::vector<uint32_t> strip = { 0, 1, 2, 1, 2, 3, 2, 3, 4 };
+		VertexCacheStatistics statistics = analyze_vertex_cache(strip, 5);
+
+		REQUIRE(statistics.triangle_count == 3);
+		REQUIRE(statistics.vertex_count == 5);
+		REQUIRE(statistics.miss_count == 5);
+		REQUIRE(statistics.atvr() == 1.f);
+	}
+
+	SECTION("Vertex cache") {
+		VertexCacheStatistics before = analyze_vertex_cache(indices, vertices.size());
+
+		std::vector<uint32_t> optimized = indices;
+		optimize_vertex_cache(optimized, vertices.size());
+		VertexCacheStatistics after = analyze_vertex_cache(optimized, vertices.size());
+
+		REQUIRE(triangle_set(vertices, optimized) == triangle_set(vertices, indices));
+		REQUIRE(after.acmr() < before.acmr() * 0.6f);
+		REQUIRE(after.acmr() < 0.9f);
+	}
+
+	SECTION("Overdraw") {
+		optimize_vertex_cache(indices, vertices.size());
+		VertexCacheStatistics before = analyze_vertex_cache(indices, vertices.size());
+
+		std::vector<uint32_t> optimized = indices;
+		optimize_overdraw(optimized, vertices, 1.05f);
+
+		REQUIRE(triangle_set(vertices, optimized) == triangle_set(vertices, indices));
+		REQUIRE(analyze_vertex_cache(optimized, vertices.size()).acmr() <= before.acmr() * 1.05f);
+	}
+
+	SECTION("Vertex fetch") {
+		std::vector<Vertex> fetched_vertices = vertices;
+		fetched_vertices.push_back(Vertex{});
+
+		std::vector<uint32_t> optimized = indices;
+		std::vector<uint32_t> remap = optimize_vertex_fetch(fetched_vertices, optimized);
+
+		REQUIRE(fetched_vertices.size() == vertices.size());
+		REQUIRE(remap.back() == std::numeric_limits<uint32_t>::max());
+		REQUIRE(triangle_set(fetched_vertices, optimized) == triangle_set(vertices, indices));
+
+		// Vertices come in the order they are first used
+		uint32_t next_vertex = 0;
+		for (uint32_t index : optimized) {
+			REQUIRE(index <= next_vertex);
+			next_vertex = std::max(next_vertex, index + 1);
+		}
+	}
+}
@@ -0,0 +1,75 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <Renderer/Mesh.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+using namespace Nth;
+
+TEST_CASE("Mesh", "[Mesh]") {
+	// Unit quad split in two triangles, the diagonal corners are shared
+	std::filesystem::path path = std::filesystem::temp_directory_path() / "nth_mesh_test.obj";
+	{
+		std::ofstream file{ path };
+		file << "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n";
+		file << "vt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\n";
+		file << "vn 0 0 1\n";
+		file << "f 1/1/1 2/2/1 3/3/1\nf 1/1/1 3/3/1 4/4/1\n";
+	}
+
+	SECTION("Welding") {
+		Mesh mesh = Mesh::FromOBJ(path.string());
+
+		REQUIRE(mesh.vertices.size() == 4);
+		REQUIRE(mesh.indices == std::vector<uint32_t>{ 0, 1, 2, 0, 2, 3 });
+		REQUIRE(mesh.bounds == BoundingBoxf{ { 0.f, 0.f, 0.f }, { 1.f, 1.f, 0.f } });
+	}
+
+	SECTION("Import options") {
+		ImportOptions options;
+		options.optimize_meshes = true;
+		options.quantize_vertices = true;
+
+		Mesh mesh = Mesh::FromOBJ(path.string(), options);
+
+		REQUIRE(mesh.vertices.size() == 4);
+		REQUIRE(mesh.indices.size() == 6);
+		REQUIRE(mesh.quantized_vertices.size() == 4);
+	}
+
+	SECTION("Optimization after meshlets") {
+		ImportOptions options;
+		options.build_meshlets = true;
+
+		Mesh mesh = Mesh::FromOBJ(path.string(), options);
+		REQUIRE(!mesh.meshlets.empty());
+
+		std::vector<uint32_t> indices = mesh.indices;
+		REQUIRE_THROWS_AS(mesh.optimize(), std::runtime_error);
+		REQUIRE(mesh.indices == indices);
+	}
+
+	SECTION("Index format") {
+		Mesh mesh = Mesh::FromOBJ(path.string());
+		REQUIRE(mesh.index_format() == IndexFormat::UInt16);
+
+		std::vector<uint8_t> packed = Mesh::pack_indices(mesh.indices, IndexFormat::UInt16);
+		REQUIRE(packed.size() == mesh.indices.size() * sizeof(uint16_t));
+		for (size_t i = 0; i < mesh.indices.size(); ++i) {
+			uint16_t index;
+			std::memcpy(&index, packed.data() + i * sizeof(uint16_t), sizeof(uint16_t));
+			REQUIRE(index == mesh.indices[i]);
+		}
+
+		REQUIRE(Mesh::pack_indices(mesh.indices, IndexFormat::UInt32).size() == mesh.indices.size() * sizeof(uint32_t));
+
+		mesh.vertices.resize(70000);
+		REQUIRE(mesh.index_format() == IndexFormat::UInt32);
+	}
+
+	std::filesystem::remove(path);
+}
@@ -0,0 +1,80 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <Renderer/Meshlet.hpp>
+
+#include <algorithm>
+#include <set>
+
+using namespace Nth;
+
+TEST_CASE("Meshlet", "[Meshlet]") {
+	// 32x32 grid facing +z
+	const uint32_t size = 32;
+
+	std::vector<Vertex> vertices;
+	for (uint32_t y = 0; y <= size; ++y) {
+		for (uint32_t x = 0; x <= size; ++x) {
+			Vertex vertex{};
+			vertex.pos = { static_cast<float>(x), static_cast<float>(y), 0.f };
+			vertex.normal = { 0.f, 0.f, 1.f };
+			vertices.push_back(vertex);
+		}
+	}
+
+	std::vector<uint32_t> indices;
+	for (uint32_t y = 0; y < size; ++y) {
+		for (uint32_t x = 0; x < size; ++x) {
+			uint32_t i = y * (size + 1) + x;
+			indices.insert(indices.end(), { i, i + 1, i + size + 2, i, i + size + 2, i + size + 1 });
+		}
+	}
+
+	std::vector<uint32_t> original = indices;
+	std::vector<Meshlet> meshlets = build_meshlets(vertices, indices, Meshlet::max_vertices, Meshlet::max_triangles);
+
+	SECTION("Partition") {
+		REQUIRE(indices.size() == original.size());
+		REQUIRE(meshlets.size() >= original.size() / 3 / Meshlet::max_triangles);
+
+		uint32_t next_index = 0;
+		for (const Meshlet& meshlet : meshlets) {
+			REQUIRE(meshlet.first_index == next_index);
+			REQUIRE(meshlet.index_count > 0);
+			REQUIRE(meshlet.index_count <= 3 * Meshlet::max_triangles);
+
+			std::set<uint32_t> unique_vertices(indices.begin() + meshlet.first_index, indices.begin() + meshlet.first_index + meshlet.index_count);
+			REQUIRE(unique_vertices.size() <= Meshlet::max_vertices);
+
+			next_index += meshlet.index_count;
+		}
+		REQUIRE(next_index == indices.size());
+
+		// Same triangles, only their order changed
+		std::multiset<std::set<uint32_t>> source_triangles;
+		std::multiset<std::set<uint32_t>> meshlet_triangles;
+		for (size_t i = 0; i < indices.size(); i += 3) {
+			source_triangles.insert({ original[i], original[i + 1], original[i + 2] });
+			meshlet_triangles.insert({ indices[i], indices[i + 1], indices[i + 2] });
+		}
+		REQUIRE(source_triangles == meshlet_triangles);
+	}
+
+	SECTION("Bounds") {
+		for (const Meshlet& meshlet : meshlets) {
+			for (uint32_t i = meshlet.first_index; i < meshlet.first_index + meshlet.index_count; ++i) {
+				const Vector3f& position = vertices[indices[i]].pos;
+
+				REQUIRE(meshlet.bounds.contains(position));
+				REQUIRE((position - meshlet.center).length() <= meshlet.radius + 1e-4f);
+			}
+		}
+	}
+
+	SECTION("Cone") {
+		// Flat meshlets face +z with a zero width cone
+		for (const Meshlet& meshlet : meshlets) {
+			REQUIRE(meshlet.cone_axis.z > 0.999f);
+			REQUIRE(meshlet.cone_cutoff < 1e-3f);
+		}
+	}
+}
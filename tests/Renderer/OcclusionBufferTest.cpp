@@ -0,0 +1,70 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <Renderer/OcclusionBuffer.hpp>
+#include <Maths/Angle.hpp>
+
+#include <Utils/ReadPool.hpp>
+
+using namespace Nth;
+
+TEST_CASE("OcclusionBuffer", "[OcclusionBuffer]") {
+	OcclusionBuffer buffer;
+	buffer.resize(60, 60);
+
+	REQUIRE(buffer.width() == 64);
+	REQUIRE(buffer.height() == 64);
+
+	buffer.begin(Matrix4f::Perspective(to_radians(90.f), 1.f, 0.1f, 10.f));
+
+	std::vector<Vector3f> quad = {
+		{ -1.f, -1.f, -2.f },
+		{ 1.f, -1.f, -2.f },
+		{ 1.f, 1.f, -2.f },
+		{ -1.f, 1.f, -2.f }
+	};
+	std::vector<uint32_t> indices = { 0, 1, 2, 0, 2, 3 };
+
+	SECTION("Rasterization") {
+		buffer.add_occluder(quad, indices, Matrix4f::Identity());
+		ReadPool pool{ 3 };
+		buffer.rasterize(&pool);
+
+		REQUIRE(buffer.depth(32, 32) < 1.f);
+		REQUIRE(buffer.depth(0, 0) == 1.f);
+		REQUIRE(buffer.depth(63, 63) == 1.f);
+
+		OcclusionBuffer single_thread;
+		single_thread.resize(60, 60);
+		single_thread.begin(Matrix4f::Perspective(to_radians(90.f), 1.f, 0.1f, 10.f));
+		single_thread.add_occluder(quad, indices, Matrix4f::Identity());
+		single_thread.rasterize();
+
+		for (uint32_t y = 0; y < buffer.height(); ++y) {
+			for (uint32_t x = 0; x < buffer.width(); ++x) {
+				REQUIRE(buffer.depth(x, y) == single_thread.depth(x, y));
+			}
+		}
+	}
+
+	SECTION("Visibility") {
+		buffer.add_occluder(quad, indices, Matrix4f::Identity());
+		ReadPool pool{ 1 };
+		buffer.rasterize(&pool);
+
+		BoundingBoxf box{ { -0.2f, -0.2f, -0.2f }, { 0.2f, 0.2f, 0.2f } };
+
+		REQUIRE(!buffer.is_visible(box, Matrix4f::Translation({ 0.f, 0.f, -5.f })));
+		REQUIRE(buffer.is_visible(box, Matrix4f::Translation({ 0.f, 0.f, -1.5f })));
+		REQUIRE(buffer.is_visible(box, Matrix4f::Translation({ 3.f, 0.f, -5.f })));
+		REQUIRE(!buffer.is_visible(box, Matrix4f::Translation({ 20.f, 0.f, -5.f })));
+	}
+
+	SECTION("Occluder transform") {
+		buffer.add_occluder(quad, indices, Matrix4f::Translation({ 4.f, 0.f, 0.f }));
+		buffer.rasterize();
+
+		BoundingBoxf box{ { -0.2f, -0.2f, -0.2f }, { 0.2f, 0.2f, 0.2f } };
+
+		REQUIRE(buffer.is_visible(box, Matrix4f::Translation({ 0.f, 0.f, -5.f })));
+	}
+}
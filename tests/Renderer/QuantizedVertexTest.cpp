@@ -0,0 +1,45 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <Renderer/QuantizedVertex.hpp>
+
+#include <cmath>
+
+using namespace Nth;
+
+TEST_CASE("QuantizedVertex", "[QuantizedVertex]") {
+	SECTION("Half float") {
+		REQUIRE(encode_half(0.f) == 0x0000);
+		REQUIRE(encode_half(1.f) == 0x3c00);
+		REQUIRE(encode_half(-2.f) == 0xc000);
+		REQUIRE(encode_half(65504.f) == 0x7bff);
+		REQUIRE(encode_half(1e6f) == 0x7c00);
+
+		REQUIRE(decode_half(0x3c00) == 1.f);
+		REQUIRE(decode_half(0x0001) == std::ldexp(1.f, -24));
+
+		for (float value : { 0.5f, 0.123f, 3.75f, -17.2f, 2e-4f }) {
+			REQUIRE(std::abs(decode_half(encode_half(value)) - value) <= std::abs(value) * 1e-3f);
+		}
+	}
+
+	SECTION("Round trip") {
+		BoundingBoxf bounds{ { -2.f, 0.f, 1.f }, { 2.f, 4.f, 3.f } };
+
+		for (int i = 0; i < 64; ++i) {
+			float angle = static_cast<float>(i) * 0.7f;
+			float elevation = static_cast<float>(i) * 0.31f - 10.f;
+
+			Vertex vertex;
+			vertex.pos = { 2.f * std::sin(angle), 2.f + 2.f * std::cos(angle), 2.f + std::sin(elevation) };
+			vertex.texture_pos = { std::fmod(angle, 1.f), 0.25f };
+			vertex.normal = { std::cos(elevation) * std::cos(angle), std::cos(elevation) * std::sin(angle), std::sin(elevation) };
+
+			Vertex decoded = dequantize_vertex(quantize_vertex(vertex, bounds), bounds);
+
+			REQUIRE((decoded.pos - vertex.pos).length() < 1e-4f);
+			REQUIRE(std::abs(decoded.texture_pos.x - vertex.texture_pos.x) < 1e-3f);
+			REQUIRE(std::abs(decoded.texture_pos.y - vertex.texture_pos.y) < 1e-3f);
+			REQUIRE(decoded.normal.dot_product(vertex.normal) > 0.999f);
+		}
+	}
+}
@@ -0,0 +1,90 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <Renderer/RenderScene.hpp>
+
+#include <algorithm>
+
+using namespace Nth;
+
+TEST_CASE("RenderScene", "[RenderScene]") {
+	RenderScene scene{ 2 };
+
+	std::vector<RenderObjectHandle> handles;
+	for (size_t i = 0; i < 6; ++i) {
+		handles.push_back(scene.add(RenderObject{ i, nullptr, Matrix4f::Identity() }));
+	}
+
+	SECTION("Handles") {
+		REQUIRE(scene.size() == 6);
+		REQUIRE(scene.get(handles[3]).model_index == 3);
+
+		scene.remove(handles[3]);
+		REQUIRE(!scene.contains(handles[3]));
+		REQUIRE(!scene.is_alive(3));
+		REQUIRE(scene.size() == 5);
+
+		// The slot is reused, the old handle stays invalid
+		RenderObjectHandle handle = scene.add(RenderObject{ 42, nullptr, Matrix4f::Identity() });
+		REQUIRE(handle.index == 3);
+		REQUIRE(handle != handles[3]);
+		REQUIRE(scene.contains(handle));
+		REQUIRE(!scene.contains(handles[3]));
+		REQUIRE(scene.slot_count() == 6);
+	}
+
+	SECTION("Dirty ranges") {
+		// Every frame copy receives the new objects once
+		for (size_t frame = 0; frame < 2; ++frame) {
+			std::vector<RenderSceneRange> ranges = scene.take_dirty_ranges(frame);
+			REQUIRE(ranges.size() == 1);
+			REQUIRE(ranges[0].first == 0);
+			REQUIRE(ranges[0].count == 6);
+
+			REQUIRE(scene.take_dirty_ranges(frame).empty());
+		}
+
+		scene.set_transform(handles[4], Matrix4f::Translation({ 1.f, 0.f, 0.f }));
+		scene.set_transform(handles[1], Matrix4f::Translation({ 1.f, 0.f, 0.f }));
+		scene.set_transform(handles[2], Matrix4f::Translation({ 1.f, 0.f, 0.f }));
+		scene.set_transform(handles[1], Matrix4f::Translation({ 2.f, 0.f, 0.f }));
+
+		std::vector<RenderSceneRange> ranges = scene.take_dirty_ranges(0);
+		REQUIRE(ranges.size() == 2);
+		REQUIRE(ranges[0].first == 1);
+		REQUIRE(ranges[0].count == 2);
+		REQUIRE(ranges[1].first == 4);
+		REQUIRE(ranges[1].count == 1);
+
+		// The other copy is still behind
+		scene.set_transform(handles[5], Matrix4f::Identity());
+		ranges = scene.take_dirty_ranges(1);
+		REQUIRE(ranges.size() == 2);
+		REQUIRE(ranges[1].first == 4);
+		REQUIRE(ranges[1].count == 2);
+		REQUIRE(scene.take_dirty_ranges(1).empty());
+		REQUIRE(scene.take_dirty_ranges(0).size() == 1);
+	}
+
+	SECTION("Changed slots") {
+		std::vector<uint32_t> slots = scene.take_changed_slots();
+		REQUIRE(slots.size() == 6);
+		REQUIRE(scene.take_changed_slots().empty());
+		scene.take_dirty_ranges(0);
+		scene.take_dirty_ranges(1);
+
+		// Removal doesn't need an upload, only structures built over the objects see it
+		scene.set_transform(handles[2], Matrix4f::Translation({ 1.f, 0.f, 0.f }));
+		scene.remove(handles[4]);
+
+		slots = scene.take_changed_slots();
+		std::sort(slots.begin(), slots.end());
+		REQUIRE(slots == std::vector<uint32_t>{ 2, 4 });
+
+		std::vector<RenderSceneRange> ranges = scene.take_dirty_ranges(1);
+		REQUIRE(ranges.size() == 1);
+		REQUIRE(ranges[0].first == 2);
+		REQUIRE(ranges[0].count == 1);
+
+		REQUIRE(scene.handle_of(5) == handles[5]);
+	}
+}
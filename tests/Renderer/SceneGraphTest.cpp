@@ -0,0 +1,117 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <Renderer/SceneGraph.hpp>
+
+#include <Utils/ReadPool.hpp>
+
+#include <cmath>
+
+using namespace Nth;
+
+TEST_CASE("SceneGraph", "[SceneGraph]") {
+	const Vector4f identity{ 0.f, 0.f, 0.f, 1.f };
+	const Vector3f unit{ 1.f, 1.f, 1.f };
+
+	auto near = [](const Matrix4f& a, const Matrix4f& b) {
+		std::array<float, 16> lhs = a.to_array();
+		std::array<float, 16> rhs = b.to_array();
+		for (size_t i = 0; i < 16; ++i) {
+			if (std::abs(lhs[i] - rhs[i]) > 1e-5f) {
+				return false;
+			}
+		}
+
+		return true;
+	};
+
+	SECTION("Compose") {
+		float angle = 0.9f;
+		Vector4f rotation{ 0.f, std::sin(angle * 0.5f), 0.f, std::cos(angle * 0.5f) };
+
+		Matrix4f expected = Matrix4f::Translation({ 1.f, 2.f, 3.f }) * Matrix4f::Rotation(angle, { 0.f, 1.f, 0.f }) * Matrix4f::Scale({ 2.f, 3.f, 4.f });
+		REQUIRE(near(SceneGraph::compose({ 1.f, 2.f, 3.f }, rotation, { 2.f, 3.f, 4.f }), expected));
+	}
+
+	SECTION("Hierarchy") {
+		SceneGraph graph;
+		uint32_t root = graph.add_node(SceneGraph::no_parent, { 1.f, 0.f, 0.f }, identity, unit);
+		uint32_t child = graph.add_node(root, { 0.f, 2.f, 0.f }, identity, unit);
+		uint32_t other = graph.add_node(SceneGraph::no_parent, { 0.f, 0.f, 5.f }, identity, unit);
+
+		REQUIRE(graph.update().size() == 3);
+		REQUIRE(near(graph.world_matrix(child), Matrix4f::Translation({ 1.f, 2.f, 0.f })));
+
+		// Quarter turn around z moves the child from +y to -x
+		graph.set_rotation(root, Vector4f{ 0.f, 0.f, std::sqrt(0.5f), std::sqrt(0.5f) });
+		REQUIRE(graph.update() == std::vector<uint32_t>{ root, child });
+
+		Vector4f position = Vector4f{ 0.f, 0.f, 0.f, 1.f } * graph.world_matrix(child);
+		REQUIRE(std::abs(position.x + 1.f) < 1e-5f);
+		REQUIRE(std::abs(position.y) < 1e-5f);
+
+		graph.set_translation(child, { 0.f, 3.f, 0.f });
+		REQUIRE(graph.update() == std::vector<uint32_t>{ child });
+		REQUIRE(graph.update().empty());
+		REQUIRE(near(graph.world_matrix(other), Matrix4f::Translation({ 0.f, 0.f, 5.f })));
+	}
+
+	SECTION("Rotated and scaled parents") {
+		Vector4f tilt{ std::sin(0.3f), 0.f, 0.f, std::cos(0.3f) };
+		// Around the unit axis (0, 0.6, 0.8)
+		Vector4f turn{ 0.f, 0.6f * std::sin(0.5f), 0.8f * std::sin(0.5f), std::cos(0.5f) };
+
+		SceneGraph graph;
+		uint32_t root = graph.add_node(SceneGraph::no_parent, { 1.f, -2.f, 0.5f }, tilt, { 2.f, 1.f, 0.5f });
+		uint32_t child = graph.add_node(root, { 0.f, 3.f, -1.f }, turn, { 1.5f, 1.5f, 3.f });
+		graph.update();
+
+		Matrix4f expected = SceneGraph::compose({ 1.f, -2.f, 0.5f }, tilt, { 2.f, 1.f, 0.5f }) * SceneGraph::compose({ 0.f, 3.f, -1.f }, turn, { 1.5f, 1.5f, 3.f });
+		REQUIRE(near(graph.world_matrix(child), expected));
+
+		Matrix4f turn_matrix = SceneGraph::compose({ 0.f, 0.f, 0.f }, turn, unit);
+		REQUIRE(near(turn_matrix * turn_matrix.inv(), Matrix4f::Identity()));
+		REQUIRE(std::abs(turn_matrix.det() - 1.f) < 1e-5f);
+	}
+
+	SECTION("Threads") {
+		SceneGraph single;
+		SceneGraph threaded;
+		for (uint32_t i = 0; i < 4000; ++i) {
+			uint32_t parent = i < 4 ? SceneGraph::no_parent : i / 4;
+			Vector3f translation{ static_cast<float>(i % 7), 0.5f, static_cast<float>(i % 3) };
+			Vector4f rotation{ 0.f, std::sin(0.1f * (i % 5)), 0.f, std::cos(0.1f * (i % 5)) };
+
+			single.add_node(parent, translation, rotation, unit);
+			threaded.add_node(parent, translation, rotation, unit);
+		}
+
+		ReadPool pool{ 3 };
+		single.update();
+		threaded.update(&pool);
+
+		for (uint32_t i = 0; i < single.size(); ++i) {
+			REQUIRE(single.world_matrix(i) == threaded.world_matrix(i));
+		}
+	}
+
+	SECTION("Attached objects") {
+		RenderScene scene{ 1 };
+		RenderObjectHandle object = scene.add(RenderObject{ 0, nullptr, Matrix4f::Identity() });
+		scene.take_dirty_ranges(0);
+
+		SceneGraph graph;
+		uint32_t root = graph.add_node(SceneGraph::no_parent, { 0.f, 0.f, 0.f }, identity, unit);
+		uint32_t node = graph.add_node(root, { 0.f, 1.f, 0.f }, identity, unit);
+		graph.attach(node, object);
+
+		graph.update();
+		graph.apply(scene);
+		REQUIRE(near(scene.get(object).transform_matrix, Matrix4f::Translation({ 0.f, 1.f, 0.f })));
+		REQUIRE(scene.take_dirty_ranges(0).size() == 1);
+
+		// Untouched nodes leave the object alone
+		graph.update();
+		graph.apply(scene);
+		REQUIRE(scene.take_dirty_ranges(0).empty());
+	}
+}
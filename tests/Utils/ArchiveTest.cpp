@@ -0,0 +1,216 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <Utils/Archive.hpp>
+#include <Utils/AssetFile.hpp>
+#include <Utils/Compression.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace Nth;
+
+TEST_CASE("Compression", "[Archive]") {
+	auto round_trip = [](const std::vector<uint8_t>& data) {
+		std::vector<uint8_t> compressed = compress_block(data.data(), data.size());
+
+		std::vector<uint8_t> decompressed(data.size());
+		decompress_block(compressed.data(), compressed.size(), decompressed.data(), decompressed.size());
+		REQUIRE(decompressed == data);
+
+		return compressed.size();
+	};
+
+	SECTION("Repetitive data") {
+		std::vector<uint8_t> data;
+		for (size_t i = 0; i < 100000; ++i) {
+			data.push_back(static_cast<uint8_t>(i % 7));
+		}
+
+		REQUIRE(round_trip(data) < data.size() / 20);
+	}
+
+	SECTION("Random data") {
+		std::mt19937 generator{ 42 };
+		std::vector<uint8_t> data(50000);
+		for (uint8_t& byte : data) {
+			byte = static_cast<uint8_t>(generator());
+		}
+
+		// Can't shrink, but must stay close to the input
+		REQUIRE(round_trip(data) < data.size() + data.size() / 100);
+	}
+
+	SECTION("Small blocks") {
+		REQUIRE(round_trip({}) == 1);
+		REQUIRE(round_trip({ 1, 2, 3 }) == 4);
+		round_trip(std::vector<uint8_t>(13, 5));
+		round_trip(std::vector<uint8_t>(300, 9));
+	}
+
+	SECTION("Invalid blocks") {
+		std::vector<uint8_t> data(1000, 3);
+		std::vector<uint8_t> compressed = compress_block(data.data(), data.size());
+		std::vector<uint8_t> output(data.size());
+
+		REQUIRE_THROWS_AS(decompress_block(compressed.data(), compressed.size() - 1, output.data(), output.size()), std::runtime_error);
+		REQUIRE_THROWS_AS(decompress_block(compressed.data(), compressed.size(), output.data(), output.size() - 1), std::runtime_error);
+
+		// A match before the start of the output
+		std::vector<uint8_t> far_match{ 0x10, 'a', 0x10, 0x00, 0x00 };
+		REQUIRE_THROWS_AS(decompress_block(far_match.data(), far_match.size(), output.data(), 5), std::runtime_error);
+	}
+}
+
+TEST_CASE("Archive", "[Archive]") {
+	std::filesystem::path root = std::filesystem::temp_directory_path() / "nth_archive_test";
+	std::filesystem::path path = std::filesystem::temp_directory_path() / "nth_archive_test.ntha";
+	std::filesystem::create_directories(root / "models");
+
+	auto write = [](const std::filesystem::path& file, const std::vector<uint8_t>& content) {
+		std::ofstream output(file, std::ios::binary | std::ios::trunc);
+		output.write(reinterpret_cast<const char*>(content.data()), static_cast<std::streamsize>(content.size()));
+	};
+
+	// Spans several blocks with a partial last one
+	std::vector<uint8_t> mesh;
+	for (uint32_t i = 0; i < 10000; ++i) {
+		mesh.push_back(static_cast<uint8_t>(i % 256 / 3));
+	}
+
+	std::mt19937 generator{ 7 };
+	std::vector<uint8_t> image(3000);
+	for (uint8_t& byte : image) {
+		byte = static_cast<uint8_t>(generator());
+	}
+
+	write(root / "models" / "scene.bin", mesh);
+	write(root / "image.png", image);
+	write(root / "empty.txt", {});
+
+	const uint32_t block_size = 4096;
+	save_archive(root, { root / "models" / "scene.bin", root / "image.png", root / "empty.txt" }, path, block_size);
+
+	SECTION("Table of contents") {
+		Archive archive = Archive::LoadFromFile(path);
+		REQUIRE(archive.entries().size() == 3);
+		REQUIRE(archive.entry_path(archive.entries()[0]) == "empty.txt");
+		REQUIRE(archive.entry_path(archive.entries()[1]) == "image.png");
+		REQUIRE(archive.entry_path(archive.entries()[2]) == "models/scene.bin");
+
+		REQUIRE(archive.find("missing.bin") == nullptr);
+		REQUIRE(archive.find("./models/../models/scene.bin") == &archive.entries()[2]);
+
+		const ArchiveEntry* entry = archive.find("models/scene.bin");
+		REQUIRE(entry->size == mesh.size());
+		REQUIRE(entry->block_count == 3);
+		REQUIRE(entry->compressed_blocks == 3);
+		REQUIRE(archive.read(*entry) == mesh);
+		REQUIRE(archive.view(*entry) == nullptr);
+
+		// Random data is stored, so it is read in place
+		const ArchiveEntry* stored = archive.find("image.png");
+		REQUIRE(stored->compressed_blocks == 0);
+		REQUIRE(archive.view(*stored) != nullptr);
+		REQUIRE(reinterpret_cast<uintptr_t>(archive.view(*stored)) % Archive::entry_alignment == 0);
+		REQUIRE(std::memcmp(archive.view(*stored), image.data(), image.size()) == 0);
+
+		REQUIRE(archive.read(*archive.find("empty.txt")).empty());
+	}
+
+	SECTION("Random access") {
+		Archive archive = Archive::LoadFromFile(path);
+		const ArchiveEntry& entry = *archive.find("models/scene.bin");
+
+		// Inside a block, across blocks and up to the end
+		for (auto [offset, size] : { std::pair<size_t, size_t>{ 100, 50 }, { 4000, 5000 }, { 9000, 1000 }, { 0, 10000 } }) {
+			std::vector<uint8_t> range(size);
+			archive.read(entry, offset, range.data(), size);
+			REQUIRE(std::memcmp(range.data(), mesh.data() + offset, size) == 0);
+		}
+
+		std::vector<uint8_t> past_end(10);
+		REQUIRE_THROWS_AS(archive.read(entry, 9995, past_end.data(), past_end.size()), std::runtime_error);
+	}
+
+	SECTION("Mounted archive") {
+		std::filesystem::path working_directory = std::filesystem::current_path();
+		std::filesystem::current_path(std::filesystem::temp_directory_path());
+
+		// Loose files are found before mounting, the archive is searched first after
+		std::filesystem::path loose = "nth_archive_test/models/scene.bin";
+		REQUIRE(AssetFile::Exists(loose));
+		REQUIRE_FALSE(AssetFile::Exists("models/scene.bin"));
+
+		AssetFile::Mount(path);
+		REQUIRE(AssetFile::Exists("models/scene.bin"));
+
+		AssetFile mesh_file = AssetFile::Open("models/scene.bin");
+		REQUIRE(std::vector<uint8_t>(mesh_file.data(), mesh_file.data() + mesh_file.size()) == mesh);
+
+		AssetFile image_file = AssetFile::Open(std::filesystem::temp_directory_path() / "image.png");
+		REQUIRE(image_file.size() == image.size());
+		REQUIRE(std::memcmp(image_file.data(), image.data(), image.size()) == 0);
+
+		REQUIRE(AssetFile::Open("empty.txt").size() == 0);
+
+		AssetFile loose_file = AssetFile::Open(loose);
+		REQUIRE(loose_file.size() == mesh.size());
+
+		AssetFile::UnmountAll();
+		REQUIRE_FALSE(AssetFile::Exists("models/scene.bin"));
+		REQUIRE_THROWS_AS(AssetFile::Open("models/scene.bin"), std::runtime_error);
+
+		std::filesystem::current_path(working_directory);
+	}
+
+	SECTION("Invalid files") {
+		std::vector<uint8_t> bytes;
+		{
+			std::ifstream input(path, std::ios::binary);
+			bytes.assign(std::istreambuf_iterator<char>(input), {});
+		}
+
+		write(path, std::vector<uint8_t>(bytes.begin(), bytes.end() - 8));
+		REQUIRE_THROWS_AS(Archive::LoadFromFile(path), std::runtime_error);
+
+		std::vector<uint8_t> wrong_magic = bytes;
+		wrong_magic[0] = 'X';
+		write(path, wrong_magic);
+		REQUIRE_THROWS_AS(Archive::LoadFromFile(path), std::runtime_error);
+
+		// Blocks of the stored image, the second entry
+		ArchiveHeader header;
+		std::memcpy(&header, bytes.data(), sizeof(ArchiveHeader));
+		ArchiveEntry entry;
+		std::memcpy(&entry, bytes.data() + header.entry_table + sizeof(ArchiveEntry), sizeof(ArchiveEntry));
+
+		auto with_block = [&](uint64_t offset, uint32_t stored_size) {
+			std::vector<uint8_t> corrupted = bytes;
+			ArchiveBlock block{ offset, stored_size, 0 };
+			std::memcpy(corrupted.data() + entry.blocks, &block, sizeof(ArchiveBlock));
+			write(path, corrupted);
+		};
+
+		ArchiveBlock image_block;
+		std::memcpy(&image_block, bytes.data() + entry.blocks, sizeof(ArchiveBlock));
+
+		with_block(bytes.size() - 100, image_block.stored_size);
+		REQUIRE_THROWS_AS(Archive::LoadFromFile(path), std::runtime_error);
+
+		// Smaller than the image, but the entry says none of its blocks is compressed
+		with_block(image_block.offset, image_block.stored_size - 1);
+		REQUIRE_THROWS_AS(Archive::LoadFromFile(path), std::runtime_error);
+
+		REQUIRE_THROWS_AS(save_archive(root, { root / "image.png", root / "." / "image.png" }, path), std::runtime_error);
+	}
+
+	std::filesystem::remove(path);
+	std::filesystem::remove_all(root);
+}
@@ -0,0 +1,39 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <Utils/Hash.hpp>
+
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+using namespace Nth;
+
+TEST_CASE("Content hash", "[Hash]") {
+	std::vector<uint8_t> data(1000);
+	for (size_t i = 0; i < data.size(); ++i) {
+		data[i] = static_cast<uint8_t>(i * 31);
+	}
+
+	SECTION("Deterministic") {
+		REQUIRE(hash_content(data.data(), data.size()) == hash_content(data.data(), data.size()));
+		REQUIRE(hash_content(data.data(), data.size()) != hash_content(data.data(), data.size(), 1));
+		REQUIRE(hash_content(nullptr, 0) != ContentHash{});
+	}
+
+	SECTION("Sizes and tails") {
+		// Trailing zeros aren't padding, every size and every byte changes the hash
+		std::vector<uint8_t> zeros(64, 0);
+		std::unordered_set<ContentHash> hashes;
+		for (size_t size = 0; size <= zeros.size(); ++size) {
+			hashes.insert(hash_content(zeros.data(), size));
+		}
+		REQUIRE(hashes.size() == zeros.size() + 1);
+
+		ContentHash reference = hash_content(data.data(), data.size());
+		for (size_t i = 0; i < data.size(); i += 7) {
+			std::vector<uint8_t> changed = data;
+			changed[i] ^= 1;
+			REQUIRE(hash_content(changed.data(), changed.size()) != reference);
+		}
+	}
+}
@@ -0,0 +1,108 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <Utils/AssetFile.hpp>
+#include <Utils/ReadPool.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace Nth;
+
+TEST_CASE("Read pool", "[ReadPool]") {
+	std::filesystem::path root = std::filesystem::temp_directory_path() / "nth_read_pool_test";
+	std::filesystem::create_directories(root);
+
+	std::vector<std::filesystem::path> paths;
+	for (size_t i = 0; i < 20; ++i) {
+		paths.push_back(root / (std::to_string(i) + ".bin"));
+
+		std::ofstream output(paths.back(), std::ios::binary | std::ios::trunc);
+		output << std::string(i + 1, static_cast<char>('a' + i));
+	}
+
+	// Catch's assertions aren't thread safe, a batch is checked on the test's thread once it's done
+	auto read_all = [&](ReadPool& pool) {
+		std::vector<std::string> contents(paths.size());
+		pool.read_batch(paths, [&](size_t i, const AssetFile& file) {
+			contents[i].assign(reinterpret_cast<const char*>(file.data()), file.size());
+		});
+
+		return contents;
+	};
+
+	auto check_batch = [&](const std::vector<std::string>& contents) {
+		REQUIRE(contents.size() == paths.size());
+		for (size_t i = 0; i < paths.size(); ++i) {
+			REQUIRE(contents[i] == std::string(i + 1, static_cast<char>('a' + i)));
+		}
+	};
+
+	SECTION("Batches") {
+		ReadPool pool{ 4 };
+		check_batch(read_all(pool));
+
+		pool.read_batch({}, [](size_t, const AssetFile&) {});
+	}
+
+	SECTION("Jobs") {
+		ReadPool pool{ 4 };
+
+		std::vector<size_t> squares(1000);
+		pool.run_batch(squares.size(), [&](size_t i) { squares[i] = i * i; });
+		for (size_t i = 0; i < squares.size(); ++i) {
+			REQUIRE(squares[i] == i * i);
+		}
+
+		pool.run_batch(0, [](size_t) { throw std::runtime_error("Never run"); });
+
+		// The lowest failing index wins whatever thread got there first
+		try {
+			pool.run_batch(100, [](size_t i) {
+				if (i % 10 == 7) {
+					throw std::runtime_error(std::to_string(i));
+				}
+			});
+			FAIL();
+		}
+		catch (const std::runtime_error& e) {
+			REQUIRE(std::string{ e.what() } == "7");
+		}
+	}
+
+	SECTION("Errors") {
+		ReadPool pool{ 4 };
+
+		std::vector<std::filesystem::path> missing = paths;
+		missing[3] = root / "missing.bin";
+		REQUIRE_THROWS(pool.read_batch(missing, [](size_t, const AssetFile&) {}));
+
+		REQUIRE_THROWS_AS(pool.read_batch(paths, [](size_t i, const AssetFile&) {
+			if (i == 5) {
+				throw std::runtime_error("Failed");
+			}
+		}), std::runtime_error);
+	}
+
+	SECTION("Batches from jobs") {
+		// Every thread waits on a batch of its own, callers get through them alone
+		ReadPool pool{ 1 };
+
+		std::vector<std::future<std::vector<std::string>>> jobs;
+		for (size_t i = 0; i < 3; ++i) {
+			jobs.push_back(pool.submit([&]() { return read_all(pool); }));
+		}
+
+		for (auto& job : jobs) {
+			check_batch(job.get());
+		}
+
+		REQUIRE(pool.submit([]() { return 42; }).get() == 42);
+	}
+
+	std::filesystem::remove_all(root);
+}
@@ -0,0 +1,341 @@
+#include <Renderer/CookedModel.hpp>
+#include <Renderer/Model.hpp>
+#include <Renderer/Mesh.hpp>
+
+#include <Utils/Archive.hpp>
+#include <Utils/Hash.hpp>
+#include <Utils/ReadPool.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Runs the import processing offline, the application then only maps the cooked files
+int main(int argc, char** argv) {
+	std::filesystem::path output_directory = "cooked";
+	std::filesystem::path archive_path;
+	bool force = false;
+
+	Nth::ImportOptions options;
+	options.lod_count = 3;
+	options.weld_vertices = true;
+	options.optimize_meshes = true;
+	options.build_meshlets = true;
+	options.quantize_vertices = true;
+
+	std::vector<std::filesystem::path> sources;
+
+	auto usage = []() {
+		std::cout << "Usage: nthcook [options] <sources...>\n"
+			<< "Models (glTF, OBJ, ...) are cooked to .nthc, images, shaders and textures they use are copied next to them\n"
+			<< "Outputs keep the directory of their source relative to the working directory, run it from where the application loads assets\n"
+			<< "  --output <directory>    Where cooked files are written, cooked by default\n"
+			<< "  --archive <file>        Packs every file of the output directory in an archive the application mounts\n"
+			<< "  --lods <count>          Levels of detail generated, 3 by default\n"
+			<< "  --lod-reduction <ratio> Index count kept by each level, 0.5 by default\n"
+			<< "  --instance-meshes       Keep meshes shared by several nodes once\n"
+			<< "  --no-optimize           Skip vertex cache, overdraw and fetch optimization\n"
+			<< "  --no-meshlets           Skip meshlet generation\n"
+			<< "  --no-quantize           Keep full vertices\n"
+			<< "  --force                 Cook sources even if the cache says they are up to date\n";
+	};
+
+	try {
+		for (int i = 1; i < argc; ++i) {
+			std::string argument = argv[i];
+			auto value = [&]() {
+				if (i + 1 >= argc) {
+					throw std::runtime_error(argument + " needs a value");
+				}
+
+				return std::string{ argv[++i] };
+			};
+
+			if (argument == "--help" || argument == "-h") {
+				usage();
+				return 0;
+			}
+			else if (argument == "--output") {
+				output_directory = value();
+			}
+			else if (argument == "--archive") {
+				archive_path = value();
+			}
+			else if (argument == "--lods") {
+				options.lod_count = std::stoul(value());
+			}
+			else if (argument == "--lod-reduction") {
+				options.lod_reduction = std::stof(value());
+			}
+			else if (argument == "--instance-meshes") {
+				options.instance_meshes = true;
+			}
+			else if (argument == "--no-optimize") {
+				options.optimize_meshes = false;
+			}
+			else if (argument == "--no-meshlets") {
+				options.build_meshlets = false;
+			}
+			else if (argument == "--no-quantize") {
+				options.quantize_vertices = false;
+			}
+			else if (argument == "--force") {
+				force = true;
+			}
+			else if (argument.rfind("--", 0) == 0) {
+				throw std::runtime_error("Unknown option " + argument);
+			}
+			else {
+				sources.push_back(argument);
+			}
+		}
+	}
+	catch (const std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		usage();
+		return 1;
+	}
+
+	if (sources.empty()) {
+		usage();
+		return 1;
+	}
+
+	std::filesystem::create_directories(output_directory);
+
+	// Every setting changing the output is part of the cache key
+	std::ostringstream settings;
+	settings << Nth::CookedModel::version << ' ' << options.lod_count << ' ' << options.lod_reduction << ' '
+		<< options.weld_vertices << options.optimize_meshes << options.build_meshlets << options.quantize_vertices << options.instance_meshes;
+	const std::string settings_key = settings.str();
+
+	// Source, key, then every file the key was computed from, separated by tabs
+	struct CacheEntry {
+		uint64_t key;
+		std::vector<std::filesystem::path> dependencies;
+	};
+
+	const std::filesystem::path cache_path = output_directory / "nthcook.cache";
+	std::map<std::string, CacheEntry> cache;
+	{
+		std::ifstream input(cache_path);
+		std::string line;
+		while (std::getline(input, line)) {
+			std::vector<std::string> fields;
+			std::istringstream stream(line);
+			std::string field;
+			while (std::getline(stream, field, '\t')) {
+				fields.push_back(field);
+			}
+
+			if (fields.size() < 2) {
+				continue;
+			}
+
+			// A corrupted line only makes its source cook again
+			CacheEntry entry;
+			try {
+				entry.key = std::stoull(fields[1], nullptr, 16);
+			}
+			catch (const std::exception&) {
+				continue;
+			}
+
+			entry.dependencies.assign(fields.begin() + 2, fields.end());
+			cache[fields[0]] = std::move(entry);
+		}
+	}
+
+	// A missing dependency gives a key nothing matches
+	auto cache_key = [&](const std::vector<std::filesystem::path>& dependencies) -> uint64_t {
+		uint64_t key = Nth::hash_bytes(settings_key.data(), settings_key.size());
+		for (const std::filesystem::path& dependency : dependencies) {
+			if (!std::filesystem::is_regular_file(dependency)) {
+				return 0;
+			}
+
+			std::string name = dependency.generic_string();
+			key = Nth::hash_bytes(name.data(), name.size(), key);
+			key = Nth::hash_file(dependency, key);
+		}
+
+		return key;
+	};
+
+	// Files the importer reads besides the source, buffers of a .gltf and materials of an .obj
+	auto referenced_files = [](const std::filesystem::path& path) {
+		std::ifstream input(path);
+		std::string content{ std::istreambuf_iterator<char>(input), {} };
+
+		std::vector<std::string> files;
+		if (path.extension() == ".gltf") {
+			size_t position = 0;
+			while ((position = content.find("\"uri\"", position)) != std::string::npos) {
+				size_t first = content.find('"', content.find(':', position) + 1);
+				size_t last = content.find('"', first + 1);
+				if (first == std::string::npos || last == std::string::npos) {
+					break;
+				}
+
+				std::string uri = content.substr(first + 1, last - first - 1);
+				if (uri.rfind("data:", 0) != 0) {
+					files.push_back(uri);
+				}
+
+				position = last + 1;
+			}
+		}
+		else if (path.extension() == ".obj") {
+			std::istringstream stream(content);
+			std::string line;
+			while (std::getline(stream, line)) {
+				if (line.rfind("mtllib ", 0) == 0) {
+					files.push_back(line.substr(7));
+				}
+			}
+		}
+
+		return files;
+	};
+
+	auto is_image = [](const std::filesystem::path& path) {
+		std::string extension = path.extension().string();
+		std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+		return extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".tga" || extension == ".bmp";
+	};
+
+	auto is_shader = [](const std::filesystem::path& path) {
+		return path.extension() == ".spv";
+	};
+
+	// glTF scenes are usually all named scene.gltf, the directory keeps their outputs and textures apart
+	auto relative_directory = [](const std::filesystem::path& source) {
+		std::filesystem::path directory = std::filesystem::absolute(source).lexically_normal().parent_path().lexically_relative(std::filesystem::current_path());
+		if (directory.empty() || *directory.begin() == "..") {
+			throw std::runtime_error("is outside of the working directory, which outputs are relative to");
+		}
+
+		return directory == "." ? std::filesystem::path{} : directory;
+	};
+
+	auto copy_asset = [&](const std::filesystem::path& from, const std::filesystem::path& relative_path) {
+		std::filesystem::path to = output_directory / relative_path;
+		std::filesystem::create_directories(to.parent_path());
+		std::filesystem::copy_file(from, to, std::filesystem::copy_options::overwrite_existing);
+	};
+
+	// Meshes and textures of every model are built on it
+	Nth::ReadPool pool;
+
+	size_t cooked = 0;
+	size_t skipped = 0;
+	size_t failed = 0;
+	// Output written by each source, a second source writing it fails instead of overwriting the first
+	std::map<std::string, std::string> outputs;
+	for (const std::filesystem::path& source : sources) {
+		std::string name = source.lexically_normal().generic_string();
+		bool copied = is_image(source) || is_shader(source);
+
+		std::filesystem::path directory;
+		std::filesystem::path output;
+		try {
+			directory = relative_directory(source);
+			output = output_directory / directory / (copied ? source.filename() : source.stem().concat(".nthc"));
+
+			auto [written, inserted] = outputs.emplace(output.lexically_normal().generic_string(), name);
+			if (!inserted && written->second != name) {
+				throw std::runtime_error("writes " + written->first + " as " + written->second + " does");
+			}
+		}
+		catch (const std::exception& e) {
+			std::cerr << name << ": " << e.what() << std::endl;
+			cache.erase(name);
+			++failed;
+			continue;
+		}
+
+		auto cached = cache.find(name);
+		if (!force && cached != cache.end() && std::filesystem::exists(output) && cached->second.key == cache_key(cached->second.dependencies)) {
+			++skipped;
+			continue;
+		}
+
+		try {
+			std::vector<std::filesystem::path> dependencies{ source };
+
+			// Mip generation and block compression need a cooked texture format the renderer can upload, images are kept as they are for now
+			if (copied) {
+				copy_asset(source, directory / source.filename());
+			}
+			else {
+				Nth::Model model = Nth::Model::LoadFromFile(source, pool, options);
+
+				Nth::save_cooked_model(model, output);
+
+				// Texture paths stay relative to the cooked file
+				const std::filesystem::path source_directory = source.parent_path();
+				for (const Nth::Texture& texture : model.textures()) {
+					copy_asset(source_directory / texture.path, directory / texture.path);
+					dependencies.push_back(source_directory / texture.path);
+				}
+
+				for (const std::string& file : referenced_files(source)) {
+					if (std::find(dependencies.begin(), dependencies.end(), source_directory / file) == dependencies.end()) {
+						dependencies.push_back(source_directory / file);
+					}
+				}
+			}
+
+			cache[name] = CacheEntry{ cache_key(dependencies), dependencies };
+			++cooked;
+
+			std::cout << "Cooked " << name << " to " << output.generic_string() << std::endl;
+		}
+		catch (const std::exception& e) {
+			std::cerr << name << ": " << e.what() << std::endl;
+			cache.erase(name);
+			++failed;
+		}
+	}
+
+	std::ofstream output(cache_path, std::ios::trunc);
+	for (const auto& [name, entry] : cache) {
+		output << name << '\t' << std::hex << entry.key << std::dec;
+		for (const std::filesystem::path& dependency : entry.dependencies) {
+			output << '\t' << dependency.generic_string();
+		}
+		output << '\n';
+	}
+
+	std::cout << cooked << " cooked, " << skipped << " up to date, " << failed << " failed" << std::endl;
+
+	// Files are packed under their path in the output directory, which the application runs from
+	if (!archive_path.empty()) {
+		std::vector<std::filesystem::path> files;
+		for (const auto& entry : std::filesystem::recursive_directory_iterator(output_directory)) {
+			if (entry.is_regular_file() && !std::filesystem::equivalent(entry.path(), cache_path) &&
+				!(std::filesystem::exists(archive_path) && std::filesystem::equivalent(entry.path(), archive_path))) {
+				files.push_back(entry.path());
+			}
+		}
+
+		try {
+			Nth::save_archive(output_directory, files, archive_path);
+			std::cout << "Packed " << files.size() << " files to " << archive_path.generic_string() << std::endl;
+		}
+		catch (const std::exception& e) {
+			std::cerr << archive_path.generic_string() << ": " << e.what() << std::endl;
+			return 1;
+		}
+	}
+
+	return failed > 0 ? 1 : 0;
+}
@@ -1,5 +1,6 @@
 set_project("NTH")
 add_requires("vulkan-memory-allocator", "vulkan-headers", "libsdl", "tinyobjloader", "stb", "catch2", "assimp")
+add_requires("glslang", {configs = {binaryonly = true}})
 add_rules("mode.debug", "mode.release")
 add_rules("plugin.vsxmake.autoupdate")
 
@@ -14,6 +15,7 @@ add_defines("VK_NO_PROTOTYPES")
 
 if is_plat("linux") then
 	add_defines("NTH_UNIX", "VK_USE_PLATFORM_XLIB_KHR")
+	add_syslinks("pthread")
 end
 
 if is_plat("windows") then
@@ -23,8 +25,18 @@ end
 target("basic")
 	add_files("exemples/basic/main.cpp")
 
+	-- Every shader is compiled next to its source as <name>.<stage>.spv, which is what the renderer loads
+	add_rules("utils.glsl2spv", {outputdir = "assets"})
+	add_files("assets/*.vert", "assets/*.frag", "assets/*.comp")
+
 	set_rundir("assets")
 
+	add_packages("vulkan-memory-allocator", "vulkan-headers", "libsdl", "tinyobjloader", "stb", "assimp", "glslang")
+
+
+target("nthcook")
+	add_files("tools/nthcook/main.cpp")
+
 	add_packages("vulkan-memory-allocator", "vulkan-headers", "libsdl", "tinyobjloader", "stb", "assimp")
 
 